@@ -1,168 +1,228 @@
-# Microsoft Developer Studio Project File - Name="MapperDll" - Package Owner=<4>
-# Microsoft Developer Studio Generated Build File, Format Version 6.00
-# ** DO NOT EDIT **
-
-# TARGTYPE "Win32 (x86) Dynamic-Link Library" 0x0102
-
-CFG=MapperDll - Win32 Debug
-!MESSAGE This is not a valid makefile. To build this project using NMAKE,
-!MESSAGE use the Export Makefile command and run
-!MESSAGE 
-!MESSAGE NMAKE /f "MapperDll.mak".
-!MESSAGE 
-!MESSAGE You can specify a configuration when running NMAKE
-!MESSAGE by defining the macro CFG on the command line. For example:
-!MESSAGE 
-!MESSAGE NMAKE /f "MapperDll.mak" CFG="MapperDll - Win32 Debug"
-!MESSAGE 
-!MESSAGE Possible choices for configuration are:
-!MESSAGE 
-!MESSAGE "MapperDll - Win32 Release" (based on "Win32 (x86) Dynamic-Link Library")
-!MESSAGE "MapperDll - Win32 Debug" (based on "Win32 (x86) Dynamic-Link Library")
-!MESSAGE 
-
-# Begin Project
-# PROP AllowPerConfigDependencies 0
-# PROP Scc_ProjName ""
-# PROP Scc_LocalPath ""
-CPP=cl.exe
-MTL=midl.exe
-RSC=rc.exe
-
-!IF  "$(CFG)" == "MapperDll - Win32 Release"
-
-# PROP BASE Use_MFC 0
-# PROP BASE Use_Debug_Libraries 0
-# PROP BASE Output_Dir "Release"
-# PROP BASE Intermediate_Dir "Release"
-# PROP BASE Target_Dir ""
-# PROP Use_MFC 0
-# PROP Use_Debug_Libraries 0
-# PROP Output_Dir "..\bin"
-# PROP Intermediate_Dir "..\obj"
-# PROP Ignore_Export_Lib 0
-# PROP Target_Dir ""
-# ADD BASE CPP /nologo /MT /W3 /GX /O2 /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /YX /FD /c
-# ADD CPP /nologo /MT /W3 /GX /O2 /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /YX /FD /c
-# ADD BASE MTL /nologo /D "NDEBUG" /mktyplib203 /win32
-# ADD MTL /nologo /D "NDEBUG" /mktyplib203 /win32
-# ADD BASE RSC /l 0x409 /d "NDEBUG"
-# ADD RSC /l 0x409 /d "NDEBUG"
-BSC32=bscmake.exe
-# ADD BASE BSC32 /nologo
-# ADD BSC32 /nologo
-LINK32=link.exe
-# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /machine:I386
-# ADD LINK32 Aria.lib ../lib/Polygon.lib wsock32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /machine:I386 /out:"..\bin\Mapper.dll"
-
-!ELSEIF  "$(CFG)" == "MapperDll - Win32 Debug"
-
-# PROP BASE Use_MFC 0
-# PROP BASE Use_Debug_Libraries 1
-# PROP BASE Output_Dir "Debug"
-# PROP BASE Intermediate_Dir "Debug"
-# PROP BASE Target_Dir ""
-# PROP Use_MFC 0
-# PROP Use_Debug_Libraries 1
-# PROP Output_Dir "../obj"
-# PROP Intermediate_Dir "../obj"
-# PROP Ignore_Export_Lib 0
-# PROP Target_Dir ""
-# ADD BASE CPP /nologo /MTd /W3 /Gm /GX /ZI /Od /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /YX /FD /GZ /c
-# ADD CPP /nologo /MTd /W3 /Gm /GX /ZI /Od /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /D "__DLL_MAPPER" /FR /YX /FD /GZ /c
-# ADD BASE MTL /nologo /D "_DEBUG" /mktyplib203 /win32
-# ADD MTL /nologo /D "_DEBUG" /mktyplib203 /win32
-# ADD BASE RSC /l 0x409 /d "_DEBUG"
-# ADD RSC /l 0x409 /d "_DEBUG"
-BSC32=bscmake.exe
-# ADD BASE BSC32 /nologo
-# ADD BSC32 /nologo
-LINK32=link.exe
-# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /debug /machine:I386 /pdbtype:sept
-# ADD LINK32 Aria.lib ../lib/Polygon.lib wsock32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /debug /machine:I386 /out:"../bin/Mapper.dll" /pdbtype:sept
-# SUBTRACT LINK32 /nodefaultlib
-
-!ENDIF 
-
-# Begin Target
-
-# Name "MapperDll - Win32 Release"
-# Name "MapperDll - Win32 Debug"
-# Begin Group "Resource Files"
-
-# PROP Default_Filter "ico;cur;bmp;dlg;rc2;rct;bin;rgs;gif;jpg;jpeg;jpe"
-# End Group
-# Begin Group "Source Files"
-
-# PROP Default_Filter "cpp;c;cxx;rc;def;r;odl;idl;hpj;bat"
-# Begin Source File
-
-SOURCE=..\src\RmActionHook.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmBayesCertaintyGrid.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmBayesSonarModel.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmExceptions.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmGlobalMap.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmJavaGridModel.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmLocalMap.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmPioneerController.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmPolygon.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmServer.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmSettings.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmSonarMap.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmSonarMapper.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmUtility.cpp
-# End Source File
-# Begin Source File
-
-SOURCE=..\src\RmUtilityExt.cpp
-# End Source File
-# End Group
-# Begin Group "Header Files"
-
-# PROP Default_Filter "h"
-# Begin Source File
-
-SOURCE=..\include\RmJavaGridModel.h
-# End Source File
-# End Group
-# End Target
-# End Project
+# Microsoft Developer Studio Project File - Name="MapperDll" - Package Owner=<4>
+# Microsoft Developer Studio Generated Build File, Format Version 6.00
+# ** DO NOT EDIT **
+
+# TARGTYPE "Win32 (x86) Dynamic-Link Library" 0x0102
+
+CFG=MapperDll - Win32 Debug
+!MESSAGE This is not a valid makefile. To build this project using NMAKE,
+!MESSAGE use the Export Makefile command and run
+!MESSAGE 
+!MESSAGE NMAKE /f "MapperDll.mak".
+!MESSAGE 
+!MESSAGE You can specify a configuration when running NMAKE
+!MESSAGE by defining the macro CFG on the command line. For example:
+!MESSAGE 
+!MESSAGE NMAKE /f "MapperDll.mak" CFG="MapperDll - Win32 Debug"
+!MESSAGE 
+!MESSAGE Possible choices for configuration are:
+!MESSAGE 
+!MESSAGE "MapperDll - Win32 Release" (based on "Win32 (x86) Dynamic-Link Library")
+!MESSAGE "MapperDll - Win32 Debug" (based on "Win32 (x86) Dynamic-Link Library")
+!MESSAGE 
+
+# Begin Project
+# PROP AllowPerConfigDependencies 0
+# PROP Scc_ProjName ""
+# PROP Scc_LocalPath ""
+CPP=cl.exe
+MTL=midl.exe
+RSC=rc.exe
+
+!IF  "$(CFG)" == "MapperDll - Win32 Release"
+
+# PROP BASE Use_MFC 0
+# PROP BASE Use_Debug_Libraries 0
+# PROP BASE Output_Dir "Release"
+# PROP BASE Intermediate_Dir "Release"
+# PROP BASE Target_Dir ""
+# PROP Use_MFC 0
+# PROP Use_Debug_Libraries 0
+# PROP Output_Dir "..\bin"
+# PROP Intermediate_Dir "..\obj"
+# PROP Ignore_Export_Lib 0
+# PROP Target_Dir ""
+# ADD BASE CPP /nologo /MT /W3 /GX /O2 /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /YX /FD /c
+# ADD CPP /nologo /MT /W3 /GX /O2 /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /YX /FD /c
+# ADD BASE MTL /nologo /D "NDEBUG" /mktyplib203 /win32
+# ADD MTL /nologo /D "NDEBUG" /mktyplib203 /win32
+# ADD BASE RSC /l 0x409 /d "NDEBUG"
+# ADD RSC /l 0x409 /d "NDEBUG"
+BSC32=bscmake.exe
+# ADD BASE BSC32 /nologo
+# ADD BSC32 /nologo
+LINK32=link.exe
+# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /machine:I386
+# ADD LINK32 Aria.lib ../lib/Polygon.lib wsock32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /machine:I386 /out:"..\bin\Mapper.dll"
+
+!ELSEIF  "$(CFG)" == "MapperDll - Win32 Debug"
+
+# PROP BASE Use_MFC 0
+# PROP BASE Use_Debug_Libraries 1
+# PROP BASE Output_Dir "Debug"
+# PROP BASE Intermediate_Dir "Debug"
+# PROP BASE Target_Dir ""
+# PROP Use_MFC 0
+# PROP Use_Debug_Libraries 1
+# PROP Output_Dir "../obj"
+# PROP Intermediate_Dir "../obj"
+# PROP Ignore_Export_Lib 0
+# PROP Target_Dir ""
+# ADD BASE CPP /nologo /MTd /W3 /Gm /GX /ZI /Od /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /YX /FD /GZ /c
+# ADD CPP /nologo /MTd /W3 /Gm /GX /ZI /Od /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "MAPPERDLL_EXPORTS" /D "__DLL_MAPPER" /FR /YX /FD /GZ /c
+# ADD BASE MTL /nologo /D "_DEBUG" /mktyplib203 /win32
+# ADD MTL /nologo /D "_DEBUG" /mktyplib203 /win32
+# ADD BASE RSC /l 0x409 /d "_DEBUG"
+# ADD RSC /l 0x409 /d "_DEBUG"
+BSC32=bscmake.exe
+# ADD BASE BSC32 /nologo
+# ADD BSC32 /nologo
+LINK32=link.exe
+# ADD BASE LINK32 kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /debug /machine:I386 /pdbtype:sept
+# ADD LINK32 Aria.lib ../lib/Polygon.lib wsock32.lib kernel32.lib user32.lib gdi32.lib winspool.lib comdlg32.lib advapi32.lib shell32.lib ole32.lib oleaut32.lib uuid.lib odbc32.lib odbccp32.lib /nologo /dll /debug /machine:I386 /out:"../bin/Mapper.dll" /pdbtype:sept
+# SUBTRACT LINK32 /nodefaultlib
+
+!ENDIF 
+
+# Begin Target
+
+# Name "MapperDll - Win32 Release"
+# Name "MapperDll - Win32 Debug"
+# Begin Group "Resource Files"
+
+# PROP Default_Filter "ico;cur;bmp;dlg;rc2;rct;bin;rgs;gif;jpg;jpeg;jpe"
+# End Group
+# Begin Group "Source Files"
+
+# PROP Default_Filter "cpp;c;cxx;rc;def;r;odl;idl;hpj;bat"
+# Begin Source File
+
+SOURCE=..\src\RmActionHook.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmBayesCertaintyGrid.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmBayesSonarModel.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmBroadcastServer.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmExceptions.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmGlobalMap.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmGridFile.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmInstrument.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmJavaGridModel.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmLocalMap.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmLocalizationTrace.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmMapFusion.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmMapPublisher.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmMapQueryServer.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmMapReplica.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmMapSnapshot.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmMapSnapshotter.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmPioneerController.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmPolygon.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmServer.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmSettings.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmSocket.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmSonarHistory.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmSonarMap.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmSonarMapper.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmSonarSimulator.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmTrace.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmUtility.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmUtilityExt.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\RmViewerStream.cpp
+# End Source File
+# End Group
+# Begin Group "Header Files"
+
+# PROP Default_Filter "h"
+# Begin Source File
+
+SOURCE=..\include\RmJavaGridModel.h
+# End Source File
+# End Group
+# End Target
+# End Project
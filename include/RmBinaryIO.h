@@ -0,0 +1,218 @@
+// RmBinaryIO.h
+
+#ifndef RM_BINARY_IO_H
+#define RM_BINARY_IO_H
+
+#include <iostream>
+#include <string>
+#include "RmUtility.h"
+#include "RmExceptions.h"
+
+
+/**
+ * Provides the primitives used to serialize mapping objects to and from a compact binary stream,
+ * such as in RmGlobalMap::write() and RmGlobalMap::read().
+ * Values are written in the native byte order and width of the platform;
+ * each file begins with a header (see writeHeader()) that records the byte order so that a file
+ * written on an incompatible platform is rejected rather than misread.
+ * <p>
+ * Large, contiguous payloads, such as the rows of a grid, are preceded by align() so that
+ * they begin on an #Alignment boundary relative to the start of the stream, allowing them to
+ * be mapped directly into memory by a reader that knows the file layout.
+ * <p>
+ * All streams must be opened in binary mode.
+ * Read functions throw an RmExceptions::IOException if the stream fails or is exhausted.
+ */
+namespace RmBinaryIO {
+
+/** The boundary, in bytes, upon which bulk payloads are aligned within a stream */
+static const int Alignment = 8;
+
+/** Marker written in the header to identify the byte order of the writing platform;
+	four bytes long on every platform, such that the header is too */
+static const unsigned int ByteOrderMark = 0x01020304;
+
+/** Fails to compile on any platform where #ByteOrderMark is not four bytes long */
+typedef char ByteOrderMarkIsFourBytes[sizeof(ByteOrderMark) == 4 ? 1 : -1];
+
+
+/**
+ * Writes the raw bytes of the given plain-old-data value to the stream.
+ */
+template<class T>
+inline void write( std::ostream &os, const T &v )
+{
+	os.write( reinterpret_cast<const char*>(&v), sizeof(T) );
+}
+
+
+/**
+ * Reads the raw bytes of a plain-old-data value from the stream into v.
+ * @throws an RmExceptions::IOException if the value could not be read
+ */
+template<class T>
+inline void read( std::istream &is, T &v )
+{
+	is.read( reinterpret_cast<char*>(&v), sizeof(T) );
+	if ( !is ) throw RmExceptions::IOException( "RmBinaryIO::read()", "Unexpected end of stream" );
+}
+
+
+/**
+ * Writes n contiguous plain-old-data values beginning at p.
+ */
+template<class T>
+inline void writeArray( std::ostream &os, const T *p, int n )
+{
+	if ( n > 0 ) os.write( reinterpret_cast<const char*>(p), sizeof(T) * n );
+}
+
+
+/**
+ * Reads n contiguous plain-old-data values into the array beginning at p.
+ * @throws an RmExceptions::IOException if the values could not be read
+ */
+template<class T>
+inline void readArray( std::istream &is, T *p, int n )
+{
+	if ( n <= 0 ) return;
+	is.read( reinterpret_cast<char*>(p), sizeof(T) * n );
+	if ( !is ) throw RmExceptions::IOException( "RmBinaryIO::readArray()", "Unexpected end of stream" );
+}
+
+
+/**
+ * Pads the output stream with zeroes up to the next #Alignment boundary.
+ */
+inline void align( std::ostream &os )
+{
+	static const char zeroes[Alignment] = { 0 };
+	const long pos = os.tellp();
+	if ( pos > 0 && pos % Alignment != 0 ) os.write( zeroes, Alignment - pos % Alignment );
+}
+
+
+/**
+ * Skips the input stream forward to the next #Alignment boundary, mirroring align(std::ostream&).
+ */
+inline void align( std::istream &is )
+{
+	const long pos = is.tellg();
+	if ( pos > 0 && pos % Alignment != 0 ) is.seekg( Alignment - pos % Alignment, std::ios::cur );
+	if ( !is ) throw RmExceptions::IOException( "RmBinaryIO::align()", "Unexpected end of stream" );
+}
+
+
+/**
+ * Writes a file header of twelve bytes consisting of a four-character magic identifier,
+ * a 32-bit format version, and the #ByteOrderMark.
+ * @param magic exactly four characters identifying the file type, such as "RMGM"
+ * @param version the version of the format that follows the header
+ */
+inline void writeHeader( std::ostream &os, const char *magic, int version )
+{
+	os.write( magic, 4 );
+	write( os, version );
+	write( os, ByteOrderMark );
+}
+
+
+/**
+ * Reads and validates a header written by writeHeader().
+ * @return the format version found in the header
+ * @throws an RmExceptions::IOException if the magic identifier does not match, or the file
+ * was written on a platform with a different byte order
+ */
+inline int readHeader( std::istream &is, const char *magic )
+{
+	static const char *signature_ = "RmBinaryIO::readHeader()";
+
+	char m[4];
+	readArray( is, m, 4 );
+	if ( m[0] != magic[0] || m[1] != magic[1] || m[2] != magic[2] || m[3] != magic[3] ) {
+		throw RmExceptions::IOException( signature_, "Unrecognized file type" );
+	}
+
+	int version;
+	unsigned int bom;
+	read( is, version );
+	read( is, bom );
+	if ( bom != ByteOrderMark ) {
+		throw RmExceptions::IOException( signature_, "File written with incompatible byte order" );
+	}
+
+	return version;
+}
+
+
+/**
+ * Writes a length-prefixed string.
+ */
+inline void write( std::ostream &os, const std::string &s )
+{
+	const int n = s.length();
+	write( os, n );
+	writeArray( os, s.data(), n );
+}
+
+
+/**
+ * Reads a length-prefixed string written by write( std::ostream&, const std::string& ).
+ */
+inline void read( std::istream &is, std::string &s )
+{
+	int n;
+	read( is, n );
+	if ( n < 0 ) throw RmExceptions::IOException( "RmBinaryIO::read()", "Invalid string length" );
+	s.resize( n );
+	if ( n > 0 ) readArray( is, &s[0], n );
+}
+
+
+/** Writes the x and y components of the coordinate. */
+inline void write( std::ostream &os, const RmUtility::Coord &c ) {
+	write( os, c.x ); write( os, c.y ); }
+
+/** Reads the x and y components of the coordinate. */
+inline void read( std::istream &is, RmUtility::Coord &c ) {
+	read( is, c.x ); read( is, c.y ); }
+
+/** Writes the upper-left and lower-right coordinates of the bounding box. */
+inline void write( std::ostream &os, const RmUtility::BoundBox &b ) {
+	write( os, b.ul ); write( os, b.lr ); }
+
+/** Reads the upper-left and lower-right coordinates of the bounding box. */
+inline void read( std::istream &is, RmUtility::BoundBox &b ) {
+	read( is, b.ul ); read( is, b.lr ); }
+
+/** Writes the coordinate and heading of the pose. */
+inline void write( std::ostream &os, const RmUtility::Pose &p ) {
+	write( os, p.coord ); write( os, p.theta ); }
+
+/** Reads the coordinate and heading of the pose. */
+inline void read( std::istream &is, RmUtility::Pose &p ) {
+	read( is, p.coord ); read( is, p.theta ); }
+
+
+/** Writes the robot pose, sonar number, distance, and full sweep of ranges of the reading. */
+inline void write( std::ostream &os, const RmUtility::SonarReading &r )
+{
+	write( os, r.robotPose );
+	write( os, r.sonarNumber );
+	write( os, r.distance );
+	writeArray( os, &r.all[0], NUM_SONARS );
+}
+
+
+/** Reads a sonar reading written by write( std::ostream&, const RmUtility::SonarReading& ). */
+inline void read( std::istream &is, RmUtility::SonarReading &r )
+{
+	read( is, r.robotPose );
+	read( is, r.sonarNumber );
+	read( is, r.distance );
+	readArray( is, &r.all[0], NUM_SONARS );
+}
+
+};
+
+#endif
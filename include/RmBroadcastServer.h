@@ -0,0 +1,173 @@
+// RmBroadcastServer.h
+
+#ifndef RM_BROADCAST_SERVER_H
+#define RM_BROADCAST_SERVER_H
+
+#pragma warning( disable : 4786 )
+
+#include <string>
+#include <vector>
+#include <deque>
+#include "Aria.h"
+#include "RmServer.h"
+
+
+/**
+ * Provides a UDP socket server that serves any number of subscribed clients at once,
+ * such as several map viewers and a logging node watching the same live map.
+ * <p>
+ * A client subscribes by sending any message from an address not already subscribed,
+ * to which the server replies "Welcome", and unsubscribes by sending "quit".
+ * A client may also limit the rate at which it is sent data by sending
+ * <code>rate bytesPerSecond</code>, where 0 removes the limit.
+ * Every message received, including those that subscribe, is also returned by
+ * pollClientString() and getClientString().
+ * <p>
+ * Data given to sendClientData() or sendClientReply() is queued for every subscriber and
+ * sent without blocking, the subscribers taking turns, so that neither a slow client nor
+ * the network delays the caller; any data that cannot be sent immediately remains queued
+ * until the next call to flush(), which is made by each send and each poll.
+ * A subscriber whose queue exceeds its limit is slow: either its oldest data is dropped
+ * or the subscriber itself is, as per the DropPolicy given at construction.
+ * A subscriber that sends nothing for longer than the idle timeout, if one is set,
+ * is also dropped.
+ * <p>
+ * Data may be sent from any thread; polling should be confined to one.
+ * @see RmServer
+ */
+class RmBroadcastServer : /* is-a */ public RmServer
+{
+public:
+
+	/** Identifies what is dropped once a subscriber's queue exceeds its limit. */
+	enum DropPolicy {
+		/** The oldest data queued for the subscriber */
+		DropOldest,
+		/** The subscriber */
+		DropClient
+	};
+
+	/** The number of messages queued per subscriber unless otherwise specified */
+	static const int DefaultMaxQueue;
+
+	/** The number of messages sent to each subscriber before the next takes its turn */
+	static const int Burst;
+
+
+	/**
+	 * Initializes a UDP server with no subscribers.
+	 * @param portNumber the port on which clients subscribe
+	 * @param name the name of the server, as reported by its messages and exceptions
+	 * @param maxQueue the maximum number of messages queued per subscriber
+	 * @param policy what is dropped once a subscriber's queue exceeds maxQueue
+	 * @throw an RmExceptions::SocketException if unable to create or configure the socket
+	 */
+	RmBroadcastServer( const short portNumber, const std::string name = "Map broadcast server",
+		int maxQueue = DefaultMaxQueue, DropPolicy policy = DropOldest );
+
+
+	/**
+	 * Releases all subscribers, without notice, and closes the connection.
+	 */
+	virtual ~RmBroadcastServer();
+
+
+	/**
+	 * Receives the next message sent by any client, subscribing or unsubscribing it as
+	 * described above, and flushes queued data.
+	 * @param s receives the message
+	 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+	 * @return false if the timeout expired before a message was received
+	 * @throw an RmExceptions::SocketException if unable to wait on the socket
+	 */
+	virtual bool pollClientString( std::string &s, int timeout );
+
+
+	/**
+	 * Queues the given data for every subscriber, then flushes queued data.
+	 */
+	virtual void sendClientData( const char *data, int length );
+
+
+	/**
+	 * Sends as much queued data as may be sent without blocking, within the rate of
+	 * each subscriber, and drops subscribers that have exceeded the idle timeout.
+	 * @return the number of messages that remain queued
+	 */
+	int flush();
+
+
+	/**
+	 * Returns the number of subscribers.
+	 */
+	int subscribers() const;
+
+
+	/**
+	 * Drops every subscriber, without notice.
+	 */
+	void unsubscribeAll();
+
+
+	/**
+	 * Sets the rate, in bytes per second, at which data is sent to new subscribers until they
+	 * request otherwise; 0, the default, imposes no limit.
+	 */
+	void setClientRate( int bytesPerSecond ) { m_clientRate = bytesPerSecond; }
+
+
+	/**
+	 * Sets the time, in milliseconds, after which a subscriber that has sent nothing is
+	 * dropped; 0, the default, disables the timeout, as is necessary for clients that send
+	 * nothing once subscribed.
+	 */
+	void setIdleTimeout( int milliseconds ) { m_idleTimeout = milliseconds; }
+
+
+	/**
+	 * Returns one line per subscriber giving its address and port, rate, and the numbers of
+	 * messages sent, dropped, and queued, noting whether it is currently slow.
+	 */
+	std::string status() const;
+
+private:
+
+	/** The state of a subscribed client */
+	struct Subscriber
+	{
+		sockaddr_in address;
+		std::deque<std::string> queue; // messages not yet sent
+		int rate; // bytes per second, or 0 if unlimited
+		double allowance; // bytes that may yet be sent within the rate
+		ArTime refilled; // time up to which the allowance has been accrued
+		ArTime lastHeard; // time at which the client last sent a message
+		unsigned long sent, dropped;
+		bool slow; // whether the queue has exceeded its limit since last emptied
+	};
+
+	/**
+	 * Returns the index of the subscriber at the given address, or -1 if there is none.
+	 * The caller must hold the mutex.
+	 */
+	int find( const sockaddr_in &address ) const;
+
+	/**
+	 * Drops the subscriber at the given index, reporting the given reason.
+	 * The caller must hold the mutex.
+	 */
+	void drop( int index, const char *reason );
+
+	/**
+	 * Returns the address and port of the given subscriber, in dotted notation.
+	 */
+	static std::string addressOf( const Subscriber &s );
+
+	std::vector<Subscriber*> m_subscribers;
+	mutable ArMutex m_mutex; // guards the subscribers and their queues
+	int m_maxQueue;
+	DropPolicy m_policy;
+	int m_clientRate;
+	int m_idleTimeout;
+};
+
+#endif
@@ -1,57 +1,72 @@
-// RmClient.h
-
-#include <string>
-#include <winsock.h>
-
-
-/**
- * Provides a UDP socket client for wireless data transfer.
- * @see RmServer
- */
-class RmClient
-{
-public:
-
-	/**
-	 * Initializes a UDP client connection with the named server on the given port.
-	 * @throw an RmExceptions::SocketException if winsock is unable to make the connection
-	 * @see RmServer
-	 */
-	RmClient( const char *serverName, const short portNumber );
-
-
-	/**
-	 * Closes the connection.
-	 */
-	~RmClient();
-
-
-	/**
-	 * Returns the last message sent from the server, blocking until such message is received.
-	 * @throw an RmExceptions::SocketException if unable to reach server
-	 */
-	std::string getServerReply();
-
-
-	/**
-	 * Sends the given message to the server.
-	 * @throw an RmExceptions::SocketException if unable to reach server
-	 */
-	void sendServerString( std::string s );
-
-protected:
-
-	/**
-	 * Opens a connection to the named server and creates a UDP/IP datagram socket on the
-	 * given port.
-	 * @throw an RmExceptions::SocketException if unable to reach server or create a socket
-	 */
-	void initClient( const char *serverName, const short portNumber );
-
-private:
-
-	SOCKET m_socket;
-	SOCKADDR_IN m_clientAddress;
-	SOCKADDR_IN m_serverAddress;
-	char m_szBuf[4096]; // this must be class-scope
-};
+// RmClient.h
+
+#ifndef RM_CLIENT_H
+#define RM_CLIENT_H
+
+#include <string>
+#include "RmSocket.h"
+
+
+/**
+ * Provides a UDP socket client for wireless data transfer.
+ * @see RmServer
+ */
+class RmClient
+{
+public:
+
+	/**
+	 * Initializes a UDP client connection with the named server on the given port.
+	 * @throw an RmExceptions::SocketException if the socket library is unable to make the connection
+	 * @see RmServer
+	 */
+	RmClient( const char *serverName, const short portNumber );
+
+
+	/**
+	 * Closes the connection.
+	 */
+	~RmClient();
+
+
+	/**
+	 * Returns the last message sent from the server, blocking until such message is received.
+	 * @throw an RmExceptions::SocketException if unable to reach server
+	 */
+	std::string getServerReply();
+
+
+	/**
+	 * Receives the next message sent from the server, waiting no longer than the given timeout.
+	 * @param s receives the message
+	 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+	 * @return false if the timeout expired before a message was received
+	 * @throw an RmExceptions::SocketException if unable to reach server
+	 */
+	bool pollServerReply( std::string &s, int timeout );
+
+
+	/**
+	 * Sends the given message to the server.
+	 * @throw an RmExceptions::SocketException if unable to reach server
+	 */
+	void sendServerString( std::string s );
+
+protected:
+
+	/**
+	 * Opens a connection to the named server and creates a UDP/IP datagram socket on the
+	 * given port.
+	 * @throw an RmExceptions::SocketException if unable to reach server or create a socket
+	 */
+	void initClient( const char *serverName, const short portNumber );
+
+private:
+
+	RmSocket::Socket m_socket;
+	sockaddr_in m_clientAddress;
+	sockaddr_in m_serverAddress;
+	char m_szBuf[4096]; // this must be class-scope
+};
+
+#endif
@@ -0,0 +1,91 @@
+// RmFlatSet.h
+
+#ifndef RM_FLAT_SET_H
+#define RM_FLAT_SET_H
+
+#include <vector>
+#include <algorithm>
+
+
+/**
+ * Provides the subset of the interface of <code>std::set&lt;T&gt;</code> used for small sets,
+ * such as the local maps covering a region, over a sorted <code>std::vector&lt;T&gt;</code>.
+ * <p>
+ * Whereas a <code>std::set</code> allocates a node for each value, a flat set holds its values
+ * contiguously, allocating only as its capacity is exceeded, and iterates over them in the
+ * same ascending order.
+ * Insertion and erasure are linear in the size of the set, which for the few values of
+ * the sets held by RmGlobalMap is faster than the allocation of a node.
+ * As with a <code>std::vector</code>, any insertion or erasure invalidates its iterators.
+ */
+template<class T>
+class RmFlatSet
+{
+public:
+
+	typedef typename std::vector<T>::const_iterator const_iterator;
+
+
+	const_iterator begin() const { return m_values.begin(); }
+	const_iterator end() const { return m_values.end(); }
+	int size() const { return static_cast<int>(m_values.size()); }
+	bool empty() const { return m_values.empty(); }
+
+
+	/**
+	 * Returns 1 if the set holds the given value, else 0.
+	 */
+	int count( const T &value ) const {
+		return std::binary_search( m_values.begin(), m_values.end(), value ) ? 1 : 0; }
+
+
+	/**
+	 * Adds the given value, returning false if already held.
+	 */
+	bool insert( const T &value )
+	{
+		typename std::vector<T>::iterator i =
+			std::lower_bound( m_values.begin(), m_values.end(), value );
+		if ( i != m_values.end() && !(value < *i) ) return false;
+		m_values.insert( i, value );
+		return true;
+	}
+
+
+	/**
+	 * Removes the given value, returning the number removed.
+	 */
+	int erase( const T &value )
+	{
+		typename std::vector<T>::iterator i =
+			std::lower_bound( m_values.begin(), m_values.end(), value );
+		if ( i == m_values.end() || value < *i ) return 0;
+		m_values.erase( i );
+		return 1;
+	}
+
+
+	/**
+	 * Removes every value, retaining the capacity.
+	 */
+	void clear() { m_values.clear(); }
+
+
+	/**
+	 * Reserves capacity for the given number of values.
+	 */
+	void reserve( int n ) { m_values.reserve( n ); }
+
+
+	/**
+	 * Returns the number of bytes allocated to hold the values.
+	 */
+	unsigned long allocatedBytes() const {
+		return static_cast<unsigned long>(m_values.capacity() * sizeof(T)); }
+
+private:
+
+	std::vector<T> m_values; // sorted in ascending order
+};
+
+#endif
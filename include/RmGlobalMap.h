@@ -1,299 +1,800 @@
-// RmGlobalMap.h
-
-#ifndef GLOBAL_MAP_H
-#define GLOBAL_MAP_H
-
-#include <fstream>
-#include <iostream>
-#include <string>
-#include <vector>
-#include <queue>
-#include <set>
-#include "RmSonarMap.h"
-#include "RmLocalMap.h"
-#include "RmBayesCertaintyGrid.h"
-#include "RmPolygon.h"
-
-
-/**
- * Provides the mechanism for Bayesian probabilistic mapping of sonar readings into a collection of 
- * RmLocalMap objects, performing real-time localization on them, and integrating them into a single 
- * global map.
- * 
- * A RmGlobalMap may be created and utilized just like a RmLocalMap 
- * or RmBayesCertaintyGrid via its constructor and #update() method.
- * Internally, the difference between this and the RmLocalMap
- * lies in the procedure by which the RmGlobalMap maintains a collection of 
- * RmLocalMap objects.
- * Sonar readings are passed on to the current RmLocalMap::update()
- * method for processing until the distance traveled by the robot exceeds that prescribed by
- * RmSettings::LocalMapDistance.
- * Once this occurs, the current local map is archived, and a new one is installed with
- * the robot's current pose as its global origin, and processing resumes as before.
- */
-
-class RmGlobalMap : /* is-a */ public RmBayesCertaintyGrid
-{
-public:
-
-	/** The data type of the identification number that uniquely identifies each region
-	    within the global map */
-	typedef unsigned short RegionId;
-
-	/**
-	 * A region identifies an area of the global map that is uniquely covered by one or
-	 * more local maps.  No two regions are covered by the same set of local maps.
-	 */
-	struct Region 
-	{
-		/** The identification number of the region */
-		RegionId id;
-
-		/** The polygonal boundary of the region */
-		RmPolygon boundary;
-
-		/** The local maps that cover the region */
-		std::set<RmLocalMap*> maps;
-
-		/** Creates a region with the given id and boundary, and no local map coverage */
-		Region( RegionId id, const RmPolygon &p ) : id(id), boundary(p) {}
-	};
-
-	/**
-	 * Initializes a 0 x 0 global map with no associated local maps and the given settings.
-	 */
-	RmGlobalMap( RmSettings* s );
-
-
-	/**
-	 * Destroys all local maps created via #update().
-	 */
-	~RmGlobalMap() { } // RmGlobalMap::empty(); }
-
-
-	/**
-	 * Passes the given sonar reading on to the current RmLocalMap, creating a new local map
-	 * once the distance specified by RmSettings::LocalMapDistance has been traveled.
-	 * @return the update string as returned by RmLocalMap::update()
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual const std::string update( const RmUtility::SonarReading &reading );
-
-
-	/**
-	 * Combines all local maps into a single global map, combining overlapping probabilities as
-	 * an average.
-	 */
-	void integrate();
-
-
-	/**
-	 * Performs housekeeping on last open local map and integrates all maps into the global map.
-	 * Further attempts to update() are ignored until until reset by call to empty().
-	 */
-	void finalize();
-
-
-	/**
-	 * Sets all cells in the global map back to their initialization value, 
-	 * leaving local maps untouched.
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual void clear() { RmBayesCertaintyGrid::clear(); }
-
-
-	/**
-	 * Removes all local maps and reduces the global map back to its initialization size and state.
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual void empty();
-
-
-	/**
-	 * Returns the width of the global map as it exists after integration.
-	 * Prior to integration, the global map remains in its initialialized size and state.
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual int width() const { return RmBayesCertaintyGrid::width(); }
-
-
-	/**
-	 * Returns the height of the global map as it exists after integration.
-	 * Prior to integration, the global map remains in its initialialized size and state.
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual int height() const { return RmBayesCertaintyGrid::height(); }
-
-
-	/**
-	 * Returns the bound of the global map as it exists after integration.
-	 * Prior to integration, the global map remains in its initialialized size and state.
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual RmUtility::BoundBox bound() const { return RmBayesCertaintyGrid::bound(); }
-
-
-	/**
-	 * Returns the value that is the average of all probabilities across the local maps
-	 * mapped to the given global x-y coordinate.  Any empty cells, that is, those with the value
-	 * RmBayesCertaintyGrid::InitVal, are excluded from the average.
-	 * If the coordinate does not map to any local map, returns RmBayesCertaintyGrid::InitVal.
-	 */ 
-	float convolvedValueAt( int x, int y ) const;
-
-
-	/**
-	 * Inserts a text representation of this object into the given output stream.
-	 * The local maps are first convolved with the global map.
-	 */ // fulfills RmSonarMap pure virtual interface
-	virtual std::ostream& put( std::ostream &os ) const;
-
-
-	/**
-	 * Returns true if there is a cell with a value of RmSettings::ObstructedCertainty or greater
-	 * on the line extending between the <i>scaled</i> start and end coordinates.
-	 * Both the current local map and global map are considered when making this
-	 * determination.
-	 */
-	bool obstructionBetween( const RmUtility::Coord &start, const RmUtility::Coord &end ) const;
-
-protected:
-
-	/**
-	 * Creates and adds a new local map to collection of maps, and dispatches any housekeeping
-	 * chores.
-	 * @param reading an unscaled sonar reading
-	 * @return string of coordinate-probability pairs that identify all cells affected by the operation
-	 */
-	std::string installNewMap( const RmUtility::SonarReading &reading );
-
-
-	/**
-	 * Convolves the given local map with the global map.
-	 * @param bound the boundary that defines the area to integrate
-	 * @param retVal if false, an update string is not built and the return value is an empty string
-	 * @return string of coordinate-probability pairs that identify all non-empty cells
-	 * in the format <code>x y pr;x y pr;...</code>; 
-	 * see RmBayesCertaintyGrid::update( const RmUtility::MappedSonarReading &reading )
-	 */
-	const std::string integrate( const RmPolygon &bound, bool retVal );
-
-
-	/**
-	 * Adds the given map to the global region map.
-	 */
-	void addToRegionMap( RmLocalMap *map );
-
-
-	/**
-	 * Removes the given map from the global region map.
-	 */
-	void removeFromRegionMap( RmLocalMap *map );
-
-
-	/**
-	 * Returns the expected robot pose given the reported pose and sonar readings, terminating
-	 * local map, and global map.
-	 * A probabilistic motion model, akin to that described and illustrated in
-	 * <i>Sonar-Based Mapping with Mobile Robots Using EM</i> (W. Burgard, et al, 1999),
-	 * is computed as a Cartesian grid with its origin at the reported robot position.
-	 * The cummulative distance and degrees of turn reported by the current local map
-	 * determine the dimension of this pose distribution;
-	 * a greater distance increases its height, a greater degree of turn increases its width.
-	 * The motion model is represented as a horizontally-elongated Gaussian ellipsoid, 
-	 * with its east and west
-	 * borders "pulled" down, forming a convex northern and concave southern border
-	 * (see RmUtility::gaussGrid() figure B for an illustration and further details).
-	 * Each cell within the motion model grid holds a normally-distributed probability.
-	 *
-	 * The in-range reading from each sonar is evaluated from each point in the global
-	 * map that corresponds to a non-zero value in the motion model.  The range reading vector
-	 * is extended from this point as if the sonar were located in that position.  
-	 * If the path is unobstructed (as per the current global map),
-	 * the value of that motion model cell is convolved with that cell's
-	 * probability of occupancy (see RmBayesSonarModel::prOccupiedGivenSn()).
-	 * This combined pose likelihood value is retained in a second probabilistic
-	 * Cartesian grid that is aligned with the motion model over the global map.
-	 *
-	 * After all pose likelihoods have been evaluated for a sonar, a third Cartesian grid--this
-	 * one histogrammic--that is aligned with the reported robot pose over the global map, 
-	 * is updated.
-	 * Each cell that corresponds to a cell in the pose likelihood grid with a maximum likelihood
-	 * value is incremented by one.  This same histogram is updated for each sonar.
-	 * Once all sonars are processed, those cells with the maximum value indicate all possible
-	 * localized poses.
-	 *
-	 * From these selected poses, those not associated with the maximum selected pose distribution
-	 * are filtered out, thus theoretically leaving only one selected localized pose.
-	 * The localized pose coordinate is identified by the corresponding coordinate on the global map;
-	 * the pose theta is represented as the delta between the angle, <i>alpha</i>, from the current 
-	 * local map's pose coordinate to the new local map's <i>unlocalized</i> pose coordinate, and 
-	 * <i>beta</i>, from the current local map's pose coordinate to the new local map's 
-	 * <i>localized</i> coordinate.
-	 * @param priorMap the local map that has been built but not yet convolved into the global map
-	 * @param reading the first sonar reading of the new local map, unscaled
-	 * @param log the file to which localization log entries are sent; if the file is invalid or
-	 * closed, no log entries are recorded
-	 * @return localized robot position and angle to that pos from starting position of the
-	 * current local map, scaled
-	 */
-	RmUtility::Pose localizedPose( const RmLocalMap &priorMap, const RmUtility::SonarReading &reading, 
-		std::ofstream &log ) const;
-
-
-	/**
-	 * Produces a log string that clears all coordinates within the given bound,
-	 * for use with the map viewer application.
-	 */
-	std::string clearMapString( const RmUtility::BoundBox &bound ) const;
-
-
-	/**
-	 * Fills the area of region r over the global region map with the given id.
-	 */
-	void fillRegionMap( const Region *const r, const RegionId id );
-
-
-	/**
-	 * Creates a new region over the given bound and adds it to the global region map.
-	 */
-	Region* newRegion( const RmPolygon &bound );
-
-
-	/**
-	 * Deletes the given region and removes it from the global region map.
-	 */
-	void deleteRegion( Region **const r );
-
-
-private:
-
-	RmSettings* m_settings;
-	std::string m_debugLogName;
-	std::ofstream m_debugLog;
-
-	/** Scaled accumulation of pose shifts */
-	RmUtility::Pose m_gAccumShift;
-
-	/** The collection of local maps which dynamically represent the global map */
-	std::vector<RmLocalMap*> m_maps;
-
-	/** Indicates whether all local maps have been convolved into RmBayesCertaintyGrid. 
-		Prevents further updates. */
-	bool m_finalized;
-
-	/** The map that's being/been built but not convolved into global map */
-	RmLocalMap* m_currentMap;
-
-	/** Distance traveled in current local map */
-	double m_wDistance;
-
-	/** Global region map that identifies regions covered by one or more local maps */
-	RmMutableCartesianGrid<RegionId> m_regionMap;
-
-	/** Collection of regions that identify overlaid local maps */
-	std::map<RegionId,Region*> m_regions;
-
-	/** Identifies those region ids that were previously used and are now unused,
-		enabling reuse of those ids */
-	std::queue<RegionId> m_usedRegionIds;
-
-	/** Identifies the highest assigned region id */
-	RegionId m_maxRegionId;
-};
-
+// RmGlobalMap.h
+
+#ifndef GLOBAL_MAP_H
+#define GLOBAL_MAP_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <set>
+#include <map>
+#include <utility>
+#include "Aria.h"
+#include "RmSonarMap.h"
+#include "RmLocalMap.h"
+#include "RmBayesCertaintyGrid.h"
+#include "RmPolygon.h"
+#include "RmGridFile.h"
+#include "RmLocalizationTrace.h"
+#include "RmPool.h"
+#include "RmFlatSet.h"
+
+
+/**
+ * Provides the mechanism for Bayesian probabilistic mapping of sonar readings into a collection of 
+ * RmLocalMap objects, performing real-time localization on them, and integrating them into a single 
+ * global map.
+ * 
+ * A RmGlobalMap may be created and utilized just like a RmLocalMap 
+ * or RmBayesCertaintyGrid via its constructor and #update() method.
+ * Internally, the difference between this and the RmLocalMap
+ * lies in the procedure by which the RmGlobalMap maintains a collection of 
+ * RmLocalMap objects.
+ * Sonar readings are passed on to the current RmLocalMap::update()
+ * method for processing until the distance traveled by the robot exceeds that prescribed by
+ * RmSettings::LocalMapDistance.
+ * Once this occurs, the current local map is archived, and a new one is installed with
+ * the robot's current pose as its global origin, and processing resumes as before.
+ * <p>
+ * Several robots may map the same environment at once, each identifying itself to
+ * update() by a robot number.  Each robot follows a trajectory of local maps of its own,
+ * corrected by an accumulated pose shift of its own, while the local maps of every robot are
+ * fused by the one region map, such that each robot is localized against the maps of all;
+ * see RmMapFusion.
+ * <p>
+ * Should RmSettings::RetireMaps be set, each local map is retired once the local map that
+ * follows it on its robot's trajectory has been relocalized against it and convolved with the
+ * global map, placing it beyond the horizon of relocalization: its probabilities are folded into running sums held over the global map, 
+ * by which the maps covering a region are averaged as before, and its grid and sonar readings
+ * are released, optionally being spilled to disk beforehand (see retire()).
+ * <p>
+ * Each change to the map, as seen by the viewer, advances its version(), and each tile of
+ * VersionTileSize cells square records the version at which it last changed, allowing
+ * RmMapPublisher to send a client only those tiles changed since it was last brought up to date.
+ */
+
+class RmGlobalMap : /* is-a */ public RmBayesCertaintyGrid
+{
+public:
+
+	/** The data type of the identification number that uniquely identifies each region
+	    within the global map */
+	typedef unsigned short RegionId;
+
+	/**
+	 * A region identifies an area of the global map that is uniquely covered by one or
+	 * more local maps.  No two regions are covered by the same set of local maps.
+	 */
+	struct Region 
+	{
+		/** The identification number of the region */
+		RegionId id;
+
+		/** The polygonal boundary of the region */
+		RmPolygon boundary;
+
+		/** The local maps that cover the region */
+		RmFlatSet<RmLocalMap*> maps;
+
+		/** Creates a region with the given id and boundary, and no local map coverage */
+		Region( RegionId id, const RmPolygon &p ) : id(id), boundary(p) {}
+	};
+
+	/**
+	 * Initializes a 0 x 0 global map with no associated local maps and the given settings.
+	 */
+	RmGlobalMap( RmSettings* s );
+
+
+	/**
+	 * Closes the localization trace, if any.
+	 * Local maps created via #update() are destroyed by empty(), not here.
+	 */
+	~RmGlobalMap();
+
+
+	/**
+	 * Requests that the grids of the next localization be dumped to the localization trace,
+	 * if any (see RmLocalizationTrace::requestDump()).
+	 * May be called from any thread.
+	 * @return false if localization is not traced
+	 */
+	bool requestLocalizationDump();
+
+
+	/**
+	 * The memory held by each component of a global map, in bytes, as measured by
+	 * measureMemory().  Containers are measured by their capacity, and the nodes of sets and
+	 * maps by an estimate of what each allocates.
+	 */
+	struct MemoryUsage
+	{
+		/** The grids of all local maps, and that of the largest */
+		unsigned long localGrids, largestLocalGrid;
+
+		/** The histories of sonar readings kept by all local maps for their reorientation */
+		unsigned long sonarHistories;
+
+		/** The region map, the boundary and local map coverage of each region, and the 
+			record of those local maps added to the region map */
+		unsigned long regions;
+
+		/** The fused global map, quantized or not, the versions of its tiles, and the running
+			sums of retired local maps */
+		unsigned long globalGrid;
+
+		/** The sum of the above but largestLocalGrid */
+		unsigned long total;
+
+		/** The number of local maps, of those retired, and of regions */
+		int localMaps, retiredMaps, regionCount;
+
+		/** Creates a measurement of no memory */
+		MemoryUsage() : localGrids(0), largestLocalGrid(0), sonarHistories(0), regions(0),
+			globalGrid(0), total(0), localMaps(0), retiredMaps(0), regionCount(0) {}
+	};
+
+
+	/**
+	 * Measures the memory held by this global map, updating memoryUsage() and memoryPeak().
+	 * This is done by update() each time a local map is installed, and by finalize(), empty(),
+	 * and read(), and so must not be done concurrently with any of these.
+	 */
+	void measureMemory();
+
+
+	/**
+	 * Returns the memory held by this global map as of its last measurement by measureMemory(),
+	 * which lags the growth of the local maps being built.
+	 * May be called from any thread.
+	 */
+	MemoryUsage memoryUsage() const;
+
+
+	/**
+	 * Returns the high-water mark of each figure of memoryUsage() since construction,
+	 * empty() notwithstanding.  Each is the greatest measured, so that the figures need not
+	 * have been measured at once, and the total is the greatest total measured.
+	 * May be called from any thread.
+	 */
+	MemoryUsage memoryPeak() const;
+
+
+	/**
+	 * Writes memoryUsage() and memoryPeak() as a table of one line per component.
+	 * May be called from any thread.
+	 */
+	std::ostream& putMemory( std::ostream &os ) const;
+
+
+	/**
+	 * Returns the table written by putMemory().
+	 */
+	std::string memoryReport() const;
+
+
+	/**
+	 * Passes the given sonar reading on to the current RmLocalMap, creating a new local map
+	 * once the distance specified by RmSettings::LocalMapDistance has been traveled.
+	 * The reading is taken to be that of robot 0; see update( const RmUtility::SonarReading&, int ).
+	 * @return the update string as returned by RmLocalMap::update()
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual const std::string update( const RmUtility::SonarReading &reading ) {
+		return update( reading, 0 );
+	}
+
+
+	/**
+	 * Passes the given sonar reading on to the RmLocalMap being built by the given robot,
+	 * creating a new local map for that robot once it has traveled the distance specified by 
+	 * RmSettings::LocalMapDistance, and correcting the reading by that robot's accumulated
+	 * shift.  The trajectory of a robot begins with the first reading received from it.
+	 * @param reading an unscaled sonar reading
+	 * @param robot the number of the robot from which the reading was received, beginning at 0
+	 * @return the update string as returned by RmLocalMap::update()
+	 * @throws an RmExceptions::InvalidParameterException if the robot number is negative
+	 */
+	const std::string update( const RmUtility::SonarReading &reading, int robot );
+
+
+	/**
+	 * Combines all local maps into a single global map, combining overlapping probabilities as
+	 * an average, as per regionValueAt().
+	 * The rows of the map are divided into as many bands as specified by 
+	 * RmSettings::IntegrateThreads, each fused on a thread of its own, the first on the
+	 * calling thread.
+	 * @throws the RmExceptions::Exception by which the fusion of the topmost band failed, if
+	 * any, once all threads have ended
+	 */
+	void integrate();
+
+
+	/**
+	 * Performs housekeeping on last open local map and integrates all maps into the global map.
+	 * Further attempts to update() are ignored until until reset by call to empty().
+	 * @param fuse if false, the maps are not integrated, as when the global map is to be 
+	 * exported by writeTiled(), which does not require it; integrate() may still be called
+	 */
+	void finalize( bool fuse = true );
+
+
+	/**
+	 * Sets all cells in the global map back to their initialization value, 
+	 * leaving local maps untouched.
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual void clear() { RmBayesCertaintyGrid::clear(); }
+
+
+	/**
+	 * Removes all local maps and reduces the global map back to its initialization size and state.
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual void empty();
+
+
+	/**
+	 * Returns the width of the global map as it exists after integration.
+	 * Prior to integration, the global map remains in its initialialized size and state.
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual int width() const { return RmBayesCertaintyGrid::width(); }
+
+
+	/**
+	 * Returns the height of the global map as it exists after integration.
+	 * Prior to integration, the global map remains in its initialialized size and state.
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual int height() const { return RmBayesCertaintyGrid::height(); }
+
+
+	/**
+	 * Returns the bound of the global map as it exists after integration.
+	 * Prior to integration, the global map remains in its initialialized size and state.
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual RmUtility::BoundBox bound() const { return RmBayesCertaintyGrid::bound(); }
+
+
+	/**
+	 * Returns the value that is the average of all probabilities across the local maps
+	 * mapped to the given global x-y coordinate.  Any empty cells, that is, those with the value
+	 * RmBayesCertaintyGrid::InitVal, are excluded from the average.
+	 * If the coordinate does not map to any local map, returns RmBayesCertaintyGrid::InitVal.
+	 */ 
+	float convolvedValueAt( int x, int y ) const;
+
+
+	/**
+	 * Returns the value of the fused global map at the given x-y coordinate as it exists after
+	 * integration, regardless of whether it is held quantized; see quantized().
+	 * If the coordinate lies outside the map, returns RmBayesCertaintyGrid::InitVal.
+	 */
+	float fusedValueAt( int x, int y ) const;
+
+
+	/**
+	 * Replaces the given grid with a copy of the fused global map, dequantized if necessary.
+	 */
+	void fusedMap( RmMutableCartesianGrid<float> &grid ) const;
+
+
+	/**
+	 * Writes the global map to the named grid file (see RmGridFile), convolving the local maps
+	 * one tile at a time such that the fused map is neither integrated nor copied, and 
+	 * omitting those tiles not covered by any local map.
+	 * Each cell written holds the value integrate() would fuse into it, before any
+	 * quantization, and those of omitted tiles are read back as RmBayesCertaintyGrid::InitVal.
+	 * The file thus agrees with the fused map after integrate() over the cells covered by a
+	 * local map, but is bound by the region map rather than by the fused map, which never
+	 * shrinks, and its values are quantized only if the cell type is RmGridFile::Quantized8,
+	 * whether or not the map is quantized().
+	 * @throws an RmExceptions::IOException if the file cannot be written
+	 */
+	void writeTiled( const char *filename, RmGridFile::CellType type = RmGridFile::Float32,
+		RmGridFile::Compression compression = RmGridFile::RunLength, 
+		int tileSize = RmGridFile::DefaultTileSize ) const;
+
+
+	/**
+	 * Returns true if the fused global map is held as 8-bit probabilities quantized by
+	 * RmUtility::quantize(), as specified by RmSettings::QuantizedMap, in which case it is 
+	 * accessed via quantizedMap(), fusedValueAt(), or fusedMap(), and this object's own 
+	 * floating point grid remains in its initialized size and state.
+	 * Local maps always accumulate probabilities as floats.
+	 */
+	bool quantized() const { return m_quantized; }
+
+
+	/**
+	 * Returns the quantized fused global map, which is only populated if quantized().
+	 */
+	const RmMutableCartesianGrid<unsigned char>& quantizedMap() const { return m_quantizedMap; }
+
+
+	/**
+	 * Inserts a text representation of this object into the given output stream.
+	 * The local maps are first convolved with the global map.
+	 */ // fulfills RmSonarMap pure virtual interface
+	virtual std::ostream& put( std::ostream &os ) const;
+
+
+	/**
+	 * Returns true if there is a cell with a value of RmSettings::ObstructedCertainty or greater
+	 * on the line extending between the <i>scaled</i> start and end coordinates.
+	 * Both the local map being built by the given robot and the global map are considered 
+	 * when making this determination.
+	 */
+	bool obstructionBetween( const RmUtility::Coord &start, const RmUtility::Coord &end,
+		int robot = 0 ) const;
+
+
+	/**
+	 * Writes a binary snapshot of the complete mapping session to the given stream:
+	 * the global map, every local map with its sonar reading history, the region map and
+	 * regions, the running sums of retired local maps, the accumulated pose shift and 
+	 * distance state of every robot used by update(), and the sweep from which the mapping
+	 * of each robot is resumed (see resumeSweep()).
+	 * The format begins with a versioned header (see RmBinaryIO::writeHeader()) and
+	 * aligns each grid payload so that it may be memory mapped.
+	 * Settings are not included, with the exception of RmSettings::CellSize, which is
+	 * recorded so that read() can reject a snapshot taken at a different scale.
+	 * @param os an output stream opened in binary mode
+	 * @throws an RmExceptions::IOException if the stream fails
+	 */
+	void write( std::ostream &os ) const;
+
+
+	/**
+	 * Replaces the complete state of this global map with a snapshot written by write(),
+	 * after which mapping may be resumed via update() as if the original session had
+	 * never been interrupted.
+	 * The fused global map retains the representation, quantized or not, in which it was 
+	 * written, regardless of RmSettings::QuantizedMap.
+	 * If the snapshot cannot be read, the global map is left empty.
+	 * @param is an input stream opened in binary mode
+	 * @throws an RmExceptions::IOException if the stream is not a valid snapshot
+	 * @throws an RmExceptions::InvalidStateException if the snapshot was taken with a
+	 * different RmSettings::CellSize
+	 */
+	void read( std::istream &is );
+
+
+	/**
+	 * Writes a snapshot of the mapping session to the named file using write().
+	 * The snapshot is first written to a temporary file, which then replaces the named file
+	 * in a single step, so that an interruption at any point, or a failure to replace the
+	 * file, never destroys a prior snapshot.
+	 * @throws an RmExceptions::IOException if the file cannot be written
+	 */
+	void save( const char *filename ) const;
+
+
+	/**
+	 * Restores a mapping session from the named file using read().
+	 * @throws an RmExceptions::IOException if the file cannot be read or is not a valid snapshot
+	 */
+	void restore( const char *filename );
+
+
+	/**
+	 * Enables periodic checkpointing of the mapping session, whereby a snapshot is saved
+	 * to the named file using save() by the first call to checkpointIfDue() following the
+	 * installation of a new local map, no more often than RmSettings::CheckpointInterval.
+	 * An empty filename disables checkpointing, which is the default.
+	 */
+	void setCheckpoint( const std::string &filename ) { m_checkpointName = filename; }
+
+
+	/**
+	 * Saves a checkpoint snapshot, as enabled by setCheckpoint(), if a new local map has
+	 * been installed since the last and RmSettings::CheckpointInterval has elapsed.
+	 * Must be called between sweeps, once the last sweep passed to the RmSonarMapper of every
+	 * robot has been mapped in full, so that the snapshot never holds part of a sweep.
+	 * <p>
+	 * The snapshot holds the complete session, every local map with its sonar history, and
+	 * is written synchronously on the calling thread, which when mapping from a live robot
+	 * is that of Aria; the time it takes grows with the session, such that the interval
+	 * should be long enough that the robot is not stalled for a significant share of it.
+	 */
+	void checkpointIfDue();
+
+
+	/**
+	 * Records the position, counting from 0, of the sweep within the sonar data of the given
+	 * robot at which its RmSonarMapper last updated the map, such that a session resumed
+	 * from a snapshot need not map again those sweeps already mapped; see resumeSweep().
+	 * Ignored for a robot whose readings have not yet been passed to update().
+	 */
+	void setResumeSweep( int robot, int sweep );
+
+
+	/**
+	 * Returns the position of the sweep within the sonar data of the given robot from which
+	 * its mapping is to be resumed following restore(), as last recorded by setResumeSweep().
+	 * The sweeps preceding it were mapped before the snapshot was taken, and are skipped;
+	 * the sweep itself is passed to RmSonarMapper::resumeAt(), and those following it to
+	 * RmSonarMapper::mapReadings(), as though the session had never been interrupted.
+	 * Returns -1 if none has been recorded, as for a robot whose mapping is resumed from
+	 * its first sweep, or one mapped live, whose sweeps are not replayed.
+	 */
+	int resumeSweep( int robot = 0 ) const;
+
+
+	/** The version of the snapshot format produced by write() */
+	static const int SnapshotVersion;
+
+
+	/**
+	 * Returns the value of the map at the given x-y coordinate as it appears to the viewer
+	 * at this moment: that of a local map being built, where it has mapped the cell, 
+	 * and otherwise the convolution of those already built, as per convolvedValueAt()
+	 * but whether or not the fused map has yet been integrated there.
+	 * Where the local maps being built by several robots have mapped the cell, that of the 
+	 * lowest numbered robot is returned.
+	 */
+	float liveValueAt( int x, int y ) const;
+
+
+	/**
+	 * Returns the version of the map, a count advanced each time a sonar reading, the
+	 * installation of a local map, or finalize() changes the values returned by liveValueAt(),
+	 * and each time the map is emptied or restored.
+	 */
+	unsigned long version() const { return m_version; }
+
+
+	/**
+	 * Returns the version at which the map was last emptied or restored; a client brought up
+	 * to date with an earlier version must discard everything it holds.
+	 */
+	unsigned long resetVersion() const { return m_resetVersion; }
+
+
+	/**
+	 * Appends to the given vector the tiles (see tileBound()) whose cells have changed since 
+	 * the given version, ordered by row and column, beginning with the southernmost, 
+	 * westernmost tile.  Only tiles changed since resetVersion() are ever reported, so that
+	 * a version of 0 reports every tile that holds mapped cells.
+	 */
+	void changedTiles( unsigned long since, std::vector<RmUtility::Coord> &tiles ) const;
+
+
+	/**
+	 * Returns the bound of the given tile, that spanning the VersionTileSize columns
+	 * beginning with <code>tile.x * VersionTileSize</code> and the VersionTileSize rows
+	 * beginning with <code>tile.y * VersionTileSize</code>.
+	 */
+	static RmUtility::BoundBox tileBound( const RmUtility::Coord &tile );
+
+
+	/** The width and height, in cells, of the tiles over which changes are versioned */
+	static const int VersionTileSize;
+
+
+	/**
+	 * Returns the number of robots whose readings have been passed to update(), being one
+	 * more than the highest robot number received.
+	 */
+	int robots() const { return static_cast<int>(m_trajectories.size()); }
+
+
+	/**
+	 * Returns the pose of the given robot as of the last sonar reading it passed to update(), 
+	 * corrected by accumulatedShift() and scaled to grid coordinates; following restore(),
+	 * that at which its current local map began.
+	 * Returns (0,0):0 for a robot from which no reading has been received.
+	 */
+	RmUtility::Pose robotPose( int robot = 0 ) const;
+
+
+	/**
+	 * Returns the accumulated shift, scaled to grid coordinates, by which localization has 
+	 * corrected the poses reported by the given robot.
+	 */
+	RmUtility::Pose accumulatedShift( int robot = 0 ) const;
+
+protected:
+
+	/**
+	 * The state by which update() follows the trajectory of a single robot through the
+	 * local maps it builds.
+	 */
+	struct Trajectory
+	{
+		/** Scaled accumulation of pose shifts */
+		RmUtility::Pose gAccumShift;
+
+		/** The map that's being/been built but not convolved into global map */
+		RmLocalMap* currentMap;
+
+		/** The map built before the current map, against which the current map is relocalized */
+		RmLocalMap* priorMap;
+
+		/** Distance traveled in current local map */
+		double wDistance;
+
+		/** Indicates the next reading is the first since a new local map was installed, and thus
+			contributes no distance to that map */
+		bool newMap;
+
+		/** Pose of the last reading received by update(), shifted and scaled; see robotPose() */
+		RmUtility::Pose gRobotPose;
+
+		/** Position of the last reading received by update(), unscaled */
+		RmUtility::Coord wLastPos;
+
+		/** The reading, shifted by the accumulated pose shift, used as the current map's pose */
+		RmUtility::SonarReading wCurrentReading;
+
+		/** The sweep from which mapping is resumed following restore(); see resumeSweep() */
+		int resumeSweep;
+
+		/** Creates the trajectory of a robot from which no reading has yet been received */
+		Trajectory() : currentMap(NULL), priorMap(NULL), wDistance(0.0), newMap(true), 
+			resumeSweep(-1) {}
+	};
+
+
+	/**
+	 * Creates and adds a new local map to collection of maps, and dispatches any housekeeping
+	 * chores.
+	 * @param reading an unscaled sonar reading
+	 * @param robot the robot from which the reading was received, whose trajectory already exists
+	 * @return string of coordinate-probability pairs that identify all cells affected by the operation
+	 */
+	std::string installNewMap( const RmUtility::SonarReading &reading, int robot );
+
+
+	/**
+	 * Convolves the given local map with the global map.
+	 * @param bound the boundary that defines the area to integrate
+	 * @param retVal if false, an update string is not built and the return value is an empty string
+	 * @return string of coordinate-probability pairs that identify all non-empty cells
+	 * in the format <code>x y pr;x y pr;...</code>; 
+	 * see RmBayesCertaintyGrid::update( const RmUtility::MappedSonarReading &reading )
+	 */
+	const std::string integrate( const RmPolygon &bound, bool retVal );
+
+
+	/**
+	 * Returns the same value as convolvedValueAt(), but for any coordinate covered by the
+	 * region map, whether or not the fused map has yet been integrated there.
+	 */
+	float regionValueAt( int x, int y ) const;
+
+
+	/**
+	 * Fuses the local maps over the given band of the region map, which spans its full
+	 * width, into the fused global map, which must already span the band; see integrate().
+	 * Neither the region map nor the local maps are modified, and no cell of the fused map
+	 * beyond the band is written, such that bands may be fused concurrently.
+	 */
+	void integrateRows( const RmUtility::BoundBox &band );
+
+
+	/**
+	 * Stores the given value in the fused global map, quantizing it if quantized().
+	 */
+	void setFusedValue( int x, int y, float pr ) {
+		if ( m_quantized ) m_quantizedMap.valueAt( x, y ) = RmUtility::quantize( pr );
+		else valueAt( x, y ) = pr;
+	}
+
+
+	/**
+	 * Advances the version of the map and records it against every tile overlapping the
+	 * given bound; see changedTiles().
+	 */
+	void touch( const RmUtility::BoundBox &bound );
+
+
+	/**
+	 * Adds the given map to the global region map, fusing it with those maps already added.
+	 */
+	void addToRegionMap( RmLocalMap *map );
+
+
+	/**
+	 * Removes the given map from the global region map.
+	 */
+	void removeFromRegionMap( RmLocalMap *map );
+
+
+	/**
+	 * Returns the expected robot pose given the reported pose and sonar readings, terminating
+	 * local map, and global map.
+	 * A probabilistic motion model, akin to that described and illustrated in
+	 * <i>Sonar-Based Mapping with Mobile Robots Using EM</i> (W. Burgard, et al, 1999),
+	 * is computed as a Cartesian grid with its origin at the reported robot position.
+	 * The cummulative distance and degrees of turn reported by the current local map
+	 * determine the dimension of this pose distribution;
+	 * a greater distance increases its height, a greater degree of turn increases its width.
+	 * The motion model is represented as a horizontally-elongated Gaussian ellipsoid, 
+	 * with its east and west
+	 * borders "pulled" down, forming a convex northern and concave southern border
+	 * (see RmUtility::gaussGrid() figure B for an illustration and further details).
+	 * Each cell within the motion model grid holds a normally-distributed probability.
+	 *
+	 * The in-range reading from each sonar is evaluated from each point in the global
+	 * map that corresponds to a non-zero value in the motion model.  The range reading vector
+	 * is extended from this point as if the sonar were located in that position.  
+	 * If the path is unobstructed (as per the current global map),
+	 * the value of that motion model cell is convolved with that cell's
+	 * probability of occupancy (see RmBayesSonarModel::prOccupiedGivenSn()).
+	 * This combined pose likelihood value is retained in a second probabilistic
+	 * Cartesian grid that is aligned with the motion model over the global map.
+	 *
+	 * After all pose likelihoods have been evaluated for a sonar, a third Cartesian grid--this
+	 * one histogrammic--that is aligned with the reported robot pose over the global map, 
+	 * is updated.
+	 * Each cell that corresponds to a cell in the pose likelihood grid with a maximum likelihood
+	 * value is incremented by one.  This same histogram is updated for each sonar.
+	 * Once all sonars are processed, those cells with the maximum value indicate all possible
+	 * localized poses.
+	 *
+	 * From these selected poses, those not associated with the maximum selected pose distribution
+	 * are filtered out, thus theoretically leaving only one selected localized pose.
+	 * The localized pose coordinate is identified by the corresponding coordinate on the global map;
+	 * the pose theta is represented as the delta between the angle, <i>alpha</i>, from the current 
+	 * local map's pose coordinate to the new local map's <i>unlocalized</i> pose coordinate, and 
+	 * <i>beta</i>, from the current local map's pose coordinate to the new local map's 
+	 * <i>localized</i> coordinate.
+	 * @param priorMap the local map that has been built but not yet convolved into the global map
+	 * @param reading the first sonar reading of the new local map, unscaled
+	 * @param robot the robot from which the reading was received, whose local map being built is
+	 * considered along with the global map when testing for obstructions
+	 * <p>
+	 * Each localization is recorded by the localization trace, if any
+	 * (see RmSettings::LocalizationTraceName), along with its grids should they be due for a dump.
+	 * @return localized robot position and angle to that pos from starting position of the
+	 * current local map, scaled
+	 */
+	RmUtility::Pose localizedPose( const RmLocalMap &priorMap, const RmUtility::SonarReading &reading, 
+		int robot ) const;
+
+
+	/**
+	 * Writes the given record to the localization trace, if any, reporting rather than
+	 * throwing should it fail.
+	 */
+	void traceLocalization( const RmLocalizationTrace::Record &record ) const;
+
+
+	/**
+	 * Retires the given local map, which must have been added to the region map and must no 
+	 * longer be needed to localize any robot, adding its non-empty probabilities over those
+	 * regions it covers to the running sums of retired maps, and then releasing its grid and
+	 * sonar readings (see RmLocalMap::retire()).
+	 * The map remains a member of its regions, whose bookkeeping requires only its bound,
+	 * but should the regions over its cells later be divided by those of further maps, it 
+	 * contributes to each cell as it did upon retirement.
+	 * <p>
+	 * If RmSettings::RetiredMapSpillName is given, the map is first appended to the file of 
+	 * that name with ".lms" appended, which begins with a header as written by 
+	 * RmBinaryIO::writeHeader() and holds, for each map, its position in the collection of 
+	 * local maps followed by the map as written by RmLocalMap::write().
+	 * Should the spill fail, it is reported, and the map is retired all the same.
+	 */
+	void retire( RmLocalMap *map );
+
+
+	/**
+	 * Produces a log string that clears all coordinates within the given bound,
+	 * for use with the map viewer application.
+	 */
+	std::string clearMapString( const RmUtility::BoundBox &bound ) const;
+
+
+	/**
+	 * Fills the area of region r over the global region map with the given id.
+	 */
+	void fillRegionMap( const Region *const r, const RegionId id );
+
+
+	/**
+	 * Creates a new local map from the pool of local maps, as would
+	 * <code>new RmLocalMap( m_settings, pose, prior )</code>.
+	 */
+	RmLocalMap* newLocalMap( const RmUtility::Pose &pose = RmUtility::Pose(), 
+		const RmLocalMap *prior = NULL ) {
+		return new (m_mapPool.allocate()) RmLocalMap( m_settings, pose, prior ); }
+
+
+	/**
+	 * Creates a new region over the given bound and adds it to the global region map.
+	 */
+	Region* newRegion( const RmPolygon &bound );
+
+
+	/**
+	 * Deletes the given region and removes it from the global region map.
+	 */
+	void deleteRegion( Region **const r );
+
+
+	/**
+	 * Destroys every local map and region, releasing the pools that held them, without
+	 * updating the region map.
+	 */
+	void releaseMaps();
+
+
+private:
+
+	RmGlobalMap( const RmGlobalMap& ); // not copyable, as it owns its localization trace
+	RmGlobalMap& operator=( const RmGlobalMap& );
+
+	friend class ConvolvedTiles;
+	friend class FusedBand;
+
+	RmSettings* m_settings;
+
+	/** The trace of each localization by localizedPose(); null if not traced */
+	RmLocalizationTrace *m_localizationTrace;
+
+	/** The trajectory of each robot, indexed by robot number */
+	std::vector<Trajectory> m_trajectories;
+
+	/** The collection of local maps which dynamically represent the global map */
+	std::vector<RmLocalMap*> m_maps;
+
+	/** Those local maps that have been added to the region map */
+	RmFlatSet<RmLocalMap*> m_regionMaps;
+
+	/** The storage of the local maps and regions, released at once by empty() */
+	RmPool<RmLocalMap> m_mapPool;
+	RmPool<Region> m_regionPool;
+
+	/** Indicates whether all local maps have been convolved into RmBayesCertaintyGrid. 
+		Prevents further updates. */
+	bool m_finalized;
+
+	/** Global region map that identifies regions covered by one or more local maps */
+	RmMutableCartesianGrid<RegionId> m_regionMap;
+
+	/** Collection of regions that identify overlaid local maps */
+	std::map<RegionId,Region*> m_regions;
+
+	/** Identifies those region ids that were previously used and are now unused,
+		enabling reuse of those ids */
+	std::queue<RegionId> m_usedRegionIds;
+
+	/** Identifies the highest assigned region id */
+	RegionId m_maxRegionId;
+
+	/** The file to which checkpoint snapshots are saved; empty if checkpointing is disabled */
+	std::string m_checkpointName;
+
+	/** Indicates a checkpoint snapshot is due on the next call to checkpointIfDue() */
+	bool m_checkpointPending;
+
+	/** The time at which the last checkpoint snapshot was saved, or the map last emptied */
+	ArTime m_checkpointed;
+
+	/** Indicates the fused global map is held in m_quantizedMap; see quantized() */
+	bool m_quantized;
+
+	/** The fused global map, if quantized() */
+	RmMutableCartesianGrid<unsigned char> m_quantizedMap;
+
+	/** The sums of the non-empty probabilities of the retired local maps, and the number of
+		maps summed, over the cells they cover; see retire() */
+	RmMutableCartesianGrid<float> m_retiredSums;
+	RmMutableCartesianGrid<unsigned short> m_retiredCounts;
+
+	/** The file to which local maps are spilled upon retirement, opened upon the first */
+	std::ofstream m_retiredSpill;
+
+	/** The current version of the map, and that at which it was last emptied or restored */
+	unsigned long m_version, m_resetVersion;
+
+	/** The version at which each tile last changed, keyed by tile row and column */
+	std::map<std::pair<int,int>,unsigned long> m_tileVersions;
+
+	/** The memory held as of the last measurement, and its high-water marks */
+	MemoryUsage m_memoryUsage, m_memoryPeak;
+
+	/** Serializes access to m_memoryUsage and m_memoryPeak */
+	mutable ArMutex m_memoryMutex;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+// RmGridFile.h
+
+#ifndef RM_GRID_FILE_H
+#define RM_GRID_FILE_H
+
+#include <iostream>
+#include <vector>
+#include "RmUtility.h"
+#include "RmMutableCartesianGrid.h"
+
+
+/**
+ * Reads and writes occupancy grids in a compact binary format, an alternative to the text
+ * representation produced by RmMutableCartesianGrid::put() that is both considerably smaller
+ * and faster to write and load.
+ * <h3>Format</h3>
+ * A grid file consists of
+ * <ul>
+ * <li>a header, as written by RmBinaryIO::writeHeader(), identifying the file as "RMGD"
+ * <li>the grid description (see Header): cell type, compression, cell size, tile size,
+ * initialization value, bound, and global origin
+ * <li>a tile directory of one (offset, length) pair of unsigned 32-bit integers per tile
+ * <li>the tile payloads, each aligned per RmBinaryIO::align()
+ * </ul>
+ * The grid is divided into square tiles of Header::tileSize cells, ordered left-to-right,
+ * top-to-bottom beginning at the upper-left corner of the bound; tiles along the eastern and
+ * southern edges are clipped to the bound.  The cells of each tile are likewise stored
+ * left-to-right, top-to-bottom, either raw or run-length encoded as a series of
+ * (unsigned 16-bit count, cell value) pairs.
+ * A tile with an offset of zero is absent from the file, all of its cells having the
+ * initialization value; write() omits every such tile.
+ * The tile directory allows any area of the grid to be loaded without reading the tiles 
+ * outside it; see read( const char*, const RmUtility::BoundBox&, RmMutableCartesianGrid<float>&, Header* ).
+ * <p>
+ * Cells are stored either as 32-bit floats or as 8-bit values quantized by
+ * RmUtility::quantize().  Either may be written from or read into a grid of floats or of
+ * quantized values, converting between the two as necessary.
+ */
+class RmGridFile
+{
+public:
+
+	/** Identifies the representation of each cell within the file. */
+	enum CellType {
+		/** 32-bit IEEE floating point probability */
+		Float32,
+		/** 8-bit probability, as quantized by RmUtility::quantize() */
+		Quantized8
+	};
+
+	/** Identifies the compression applied to each tile. */
+	enum Compression {
+		/** Cells are stored raw */
+		Raw,
+		/** Cells are stored as a series of (count, value) pairs */
+		RunLength
+	};
+
+	/** Describes the grid contained in a file. */
+	struct Header
+	{
+		/** The representation of each cell */
+		CellType cellType;
+
+		/** The compression applied to each tile */
+		Compression compression;
+
+		/** The size of each cell, in the units of the sonar readings (see RmSettings::CellSize) */
+		int cellSize;
+
+		/** The width and height of each tile, in cells */
+		int tileSize;
+
+		/** The value of each cell of an absent tile */
+		float initVal;
+
+		/** The upper-left and lower-right coordinates of the grid */
+		RmUtility::BoundBox bound;
+
+		/** The global origin to which the grid's local origin is linked */
+		RmUtility::Coord origin;
+
+		/** Returns the number of columns of tiles */
+		int tilesX() const { return (bound.width() + tileSize - 1) / tileSize; }
+
+		/** Returns the number of rows of tiles */
+		int tilesY() const { return (bound.height() + tileSize - 1) / tileSize; }
+	};
+
+	/**
+	 * Supplies the cells of a grid one tile at a time, allowing a grid to be written without
+	 * ever being held in memory in its entirety.
+	 * @see write( const TileSource&, const RmUtility::BoundBox&, const RmUtility::Coord&, float, const char*, int, CellType, Compression, int )
+	 */
+	class TileSource
+	{
+	public:
+
+		virtual ~TileSource() {}
+
+		/**
+		 * Fills the given cells, which are sized to the area, with the probabilities of the 
+		 * area, left-to-right, top-to-bottom beginning at its upper-left corner.
+		 * @return false if every cell has the initialization value, in which case the
+		 * tile is omitted from the file
+		 */
+		virtual bool tile( const RmUtility::BoundBox &area, std::vector<float> &cells ) const = 0;
+	};
+
+	/** The tile size used unless otherwise specified */
+	static const int DefaultTileSize;
+
+	/** The version of the format produced by write() */
+	static const int Version;
+
+
+	/**
+	 * Writes the given grid to the named file.
+	 * @param grid the grid to be written
+	 * @param filename the name of the file to create or overwrite
+	 * @param cellSize the size of each cell, recorded for the benefit of the reader
+	 * @param type the representation of each cell
+	 * @param compression the compression applied to each tile
+	 * @param tileSize the width and height of each tile, in cells
+	 * @throws an RmExceptions::IOException if the file cannot be written
+	 * @throws an RmExceptions::InvalidParameterException if the tile size is not positive
+	 */
+	static void write( const RmMutableCartesianGrid<float> &grid, const char *filename,
+		int cellSize, CellType type = Float32, Compression compression = RunLength,
+		int tileSize = DefaultTileSize );
+
+
+	/**
+	 * Writes the given grid of probabilities quantized by RmUtility::quantize(), such as
+	 * RmGlobalMap::quantizedMap(), to the named file.
+	 * A type of Float32 dequantizes each cell, writing RmUtility::QuantizedUnknown as the
+	 * initialization value of the grid.
+	 * @see write( const RmMutableCartesianGrid<float>&, const char*, int, CellType, Compression, int )
+	 */
+	static void write( const RmMutableCartesianGrid<unsigned char> &grid, const char *filename,
+		int cellSize, CellType type = Quantized8, Compression compression = RunLength,
+		int tileSize = DefaultTileSize );
+
+
+	/**
+	 * Writes the grid of the given bound and global origin to the named file, obtaining
+	 * its cells from the given source one tile at a time.
+	 * @param initVal the probability of any cell not supplied by the source
+	 * @see write( const RmMutableCartesianGrid<float>&, const char*, int, CellType, Compression, int )
+	 */
+	static void write( const TileSource &source, const RmUtility::BoundBox &bound, 
+		const RmUtility::Coord &origin, float initVal, const char *filename, int cellSize, 
+		CellType type = Float32, Compression compression = RunLength, 
+		int tileSize = DefaultTileSize );
+
+
+	/**
+	 * Replaces the given grid with that stored in the named file.
+	 * The grid will have the same bound and global origin as the grid that was written.
+	 * @param filename the name of a file written by write()
+	 * @param grid the grid into which the file is loaded
+	 * @param header if non-null, receives the description of the grid
+	 * @throws an RmExceptions::IOException if the file cannot be read or is not a valid grid file
+	 */
+	static void read( const char *filename, RmMutableCartesianGrid<float> &grid,
+		Header *header = NULL );
+
+
+	/**
+	 * Replaces the given grid of quantized probabilities with that stored in the named file,
+	 * quantizing the cells of a Float32 file.
+	 * @see read( const char*, RmMutableCartesianGrid<float>&, Header* )
+	 */
+	static void read( const char *filename, RmMutableCartesianGrid<unsigned char> &grid,
+		Header *header = NULL );
+
+
+	/**
+	 * Replaces the given grid with the given area of that stored in the named file,
+	 * reading only those tiles that intersect the area.
+	 * The grid is bound by the intersection of the area and the bound of the stored grid.
+	 * @throws an RmExceptions::IOException if the file cannot be read or is not a valid grid file
+	 * @throws an RmExceptions::InvalidParameterException if the area lies outside the stored grid
+	 */
+	static void read( const char *filename, const RmUtility::BoundBox &area,
+		RmMutableCartesianGrid<float> &grid, Header *header = NULL );
+
+
+	/**
+	 * The quantized version of 
+	 * read( const char*, const RmUtility::BoundBox&, RmMutableCartesianGrid<float>&, Header* ).
+	 */
+	static void read( const char *filename, const RmUtility::BoundBox &area,
+		RmMutableCartesianGrid<unsigned char> &grid, Header *header = NULL );
+
+
+	/**
+	 * Returns the description of the grid stored in the named file without loading its cells.
+	 * @throws an RmExceptions::IOException if the file cannot be read or is not a valid grid file
+	 */
+	static Header readHeader( const char *filename );
+
+protected:
+
+	/**
+	 * Writes the header and grid description.
+	 */
+	static void writeHeader( std::ostream &os, const Header &header );
+
+
+	/**
+	 * Reads and validates the header and grid description.
+	 */
+	static Header readHeader( std::istream &is );
+};
+
+#endif
@@ -0,0 +1,204 @@
+// RmGridView.h
+
+#ifndef RM_GRID_VIEW_H
+#define RM_GRID_VIEW_H
+
+#include <iostream>
+#include <cstdio>
+#include "RmUtility.h"
+#include "RmExceptions.h"
+
+
+/**
+ * Provides a non-owning window onto a rectangular area of a grid, addressed using the same
+ * global coordinates as the grid itself but without copying any of its cells.
+ * A view consists of nothing more than a pointer to the cell at the upper-left corner of its
+ * bound, the stride between the first cells of adjacent rows, and the bound itself,
+ * and may therefore be freely copied and passed by value.
+ * <h3>Usage</h3>
+ * Views are obtained from RmMutableCartesianGrid::view(), the <code>const</code> version of
+ * which provides a read-only view, as in <code>RmGridView&lt;const float&gt;</code>.
+ * <pre>
+ * 1    RmMutableCartesianGrid<float> grid( RmUtility::BoundBox( -50, 50, 50, -50 ), Coord() );
+ * 2    RmGridView<float> window( grid.view( RmUtility::BoundBox( -5, 5, 5, -5 ) ) );
+ * 3    window.valueAt( 0, 0 ) = 1.0f;
+ * 4    float *row = window.rowAt( 5 );
+ * </pre>
+ * Line 3 writes directly to the cell [0][0] of the underlying grid; line 4 provides
+ * unchecked access to the eleven cells of the top row of the window, beginning with [-5][5].
+ * <p>
+ * A view is invalidated by any operation that resizes the grid from which it was obtained.
+ * <h3>Dependencies</h3>
+ * The utility structures of RmUtility::Coord and RmUtility::BoundBox are used in
+ * specifying grid points and boundaries, respectively.
+ */
+
+template<class T>
+class RmGridView
+{
+public:
+
+	/**
+	 * Constructs an empty view, one that contains no cells.
+	 */
+	RmGridView() : m_cells( NULL ), m_stride( 0 ), m_width( 0 ), m_height( 0 ) {}
+
+
+	/**
+	 * Constructs a view of the given bound onto the given cells.
+	 * @param cells the cell at the upper-left corner of the bound
+	 * @param stride the number of cells between the first cells of adjacent rows
+	 * @param bound the upper-left and lower-right coordinates of the view; an inverted bound,
+	 * such as that resulting from the intersection of disjoint boxes, produces an empty view
+	 */
+	RmGridView( T *cells, int stride, const RmUtility::BoundBox &bound )
+		: m_cells( cells ), m_stride( stride ), m_bound( bound ),
+		  m_width( bound.lr.x - bound.ul.x + 1 ), m_height( bound.ul.y - bound.lr.y + 1 )
+	{
+		if ( m_width <= 0 || m_height <= 0 ) {
+			m_cells = NULL;
+			m_width = m_height = 0;
+		}
+	}
+
+
+	/**
+	 * Returns the upper-left and lower-right coordinates of the view.
+	 * The bound of an empty view is undefined.
+	 */
+	RmUtility::BoundBox bound() const { return m_bound; }
+
+
+	/**
+	 * Returns the number of columns in the view.
+	 */
+	int width() const { return m_width; }
+
+
+	/**
+	 * Returns the number of rows in the view.
+	 */
+	int height() const { return m_height; }
+
+
+	/**
+	 * Returns true if the view contains no cells.
+	 */
+	bool empty() const { return m_cells == NULL; }
+
+
+	/**
+	 * Returns true if the given coordinate falls within the bound of this view.
+	 */
+	bool inBounds( int x, int y ) const
+	{
+		return m_cells != NULL && x >= m_bound.ul.x && x <= m_bound.lr.x &&
+			y <= m_bound.ul.y && y >= m_bound.lr.y;
+	}
+
+
+	/**
+	 * Provides access to the cell at the given global coordinate.
+	 * @throws an RmExceptions::IndexOutOfBoundsException if the coordinate is beyond the
+	 * bound of the view
+	 */
+	T& valueAt( int x, int y ) const;
+
+
+	/**
+	 * Provides bulk access to the width() contiguous cells of the row at the given
+	 * global y-coordinate, beginning with the cell at the western boundary of the view and
+	 * bypassing the bounds checking of valueAt().
+	 * @param y a row within the bound of a non-empty view
+	 */
+	T* rowAt( int y ) const { return m_cells + (m_bound.ul.y - y) * m_stride; }
+
+
+	/**
+	 * Returns a view of the given area of this view, clipped to its bound.
+	 */
+	RmGridView<T> view( const RmUtility::BoundBox &area ) const;
+
+
+	/**
+	 * Streams a text representation of the view in a top-down row-column format, as would
+	 * RmMutableMatrix::put() for a grid spanning just its bound.
+	 * @param os the output stream
+	 * @param format an optional C-style format string
+	 */
+	std::ostream& put( std::ostream& os, const char *format = NULL ) const;
+
+private:
+
+	/** The cell at the upper-left corner of the view, or NULL if the view is empty */
+	T *m_cells;
+
+	/** The number of cells between the first cells of adjacent rows */
+	int m_stride;
+
+	/** The upper-left and lower-right coordinates of the view */
+	RmUtility::BoundBox m_bound;
+
+	/** The dimensions of the view, retained since those of an inverted bound are not */
+	int m_width, m_height;
+};
+
+
+template<class T>
+T& RmGridView<T>::valueAt( int x, int y ) const
+{
+	if ( !inBounds( x, y ) ) {
+		char buff[80];
+		sprintf( buff, "View bound: (%d,%d) (%d,%d); Requested index: [%d][%d]",
+			m_bound.ul.x, m_bound.ul.y, m_bound.lr.x, m_bound.lr.y, x, y );
+		throw RmExceptions::IndexOutOfBoundsException( "RmGridView<T>::valueAt()", buff );
+	}
+
+	return rowAt( y )[x - m_bound.ul.x];
+}
+
+
+template<class T>
+RmGridView<T> RmGridView<T>::view( const RmUtility::BoundBox &area ) const
+{
+	if ( m_cells == NULL ) return RmGridView<T>();
+
+	RmUtility::BoundBox clip( area );
+	clip.intersectWith( m_bound );
+	if ( clip.ul.x > clip.lr.x || clip.ul.y < clip.lr.y ) return RmGridView<T>();
+
+	return RmGridView<T>( rowAt( clip.ul.y ) + (clip.ul.x - m_bound.ul.x), m_stride, clip );
+}
+
+
+template<class T>
+std::ostream& RmGridView<T>::put( std::ostream& os, const char *format ) const
+{
+	char buff[32];
+
+	for ( int y = 0; y < m_height; ++y )
+	{
+		const T *cols = m_cells + y * m_stride;
+		for ( int x = 0; x < m_width; ++x )
+		{
+			if ( format != NULL ) {
+				sprintf( buff, format, cols[x] );
+				os << buff << " ";
+			}
+			else {
+				os << cols[x] << " ";
+			}
+		}
+		os << "\n";
+	}
+	return os;
+}
+
+
+template<class T>
+std::ostream& operator<< ( std::ostream& os, const RmGridView<T>& v )
+{
+	return v.put( os );
+}
+
+#endif
@@ -0,0 +1,142 @@
+// RmInstrument.h
+
+#ifndef RM_INSTRUMENT_H
+#define RM_INSTRUMENT_H
+
+#include <iostream>
+#include <string>
+
+
+/**
+ * Provides the timers and counters by which the hot paths of mapping are instrumented,
+ * such that the cost of each stage may be observed in a running session.
+ * <p>
+ * Each Stage accumulates the number of times it is entered, its total and greatest duration,
+ * and a histogram of its durations, in buckets of powers of two microseconds.
+ * Each Counter accumulates a number of events, such as cells updated or bytes sent.
+ * Durations are inclusive, such that a stage entered from within another would be counted
+ * by both.  The stages instrumented here are entered in turn rather than nested, as are
+ * addToRegionMap() and then integrate() by RmGlobalMap::installNewMap(), such that their
+ * durations may be summed.
+ * All figures are shared by every thread and map of the process, and are accumulated under
+ * a lock, such that they are to be recorded once per call of a stage, not once per cell.
+ * <p>
+ * Instrumentation is compiled only when <code>_INSTRUMENT</code> is defined, as it is by the
+ * Release Instrumented configuration of MapperLib, MapperCon, and MapperBench, and is
+ * otherwise removed entirely by the macros through which it is recorded,
+ * RM_INSTRUMENT_TIMER() and RM_INSTRUMENT_COUNT(), such that it costs nothing when disabled.
+ * The functions themselves are always available, such that report() may be called regardless,
+ * and says so when there is nothing to report.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    void RmGlobalMap::integrate()
+ * 2    {
+ * 3        RM_INSTRUMENT_TIMER( RmInstrument::Integrate );
+ * 4        RM_INSTRUMENT_COUNT( RmInstrument::CellsUpdated, cells );
+ * 5        ...
+ * 6    RmInstrument::report( std::cout );
+ * </pre>
+ */
+namespace RmInstrument {
+
+/** The stages timed */
+enum Stage { SonarUpdate, AddToRegionMap, LocalizedPose, Integrate, LogFormat, SendClientReply,
+	StageCount };
+
+/** The events counted */
+enum Counter { CellsUpdated, RaysCast, RegionsCreated, BytesSent, SweepsDropped, CounterCount };
+
+/** The number of buckets of each histogram, the last of which holds all longer durations */
+static const int Buckets = 24;
+
+
+/**
+ * Returns the time in seconds since some fixed point, to a resolution of a microsecond or better.
+ */
+double wallSeconds();
+
+
+/**
+ * Records one pass through the given stage, of the given duration in seconds.
+ */
+void record( Stage stage, double seconds );
+
+
+/**
+ * Adds the given number of events to the given counter.
+ */
+void count( Counter counter, double n );
+
+
+/**
+ * Returns the number of events counted by the given counter.
+ */
+double counted( Counter counter );
+
+
+/**
+ * Returns the name of the given stage or counter, as written by report().
+ */
+const char* name( Stage stage );
+const char* name( Counter counter );
+
+
+/**
+ * Writes a table of every stage and counter, and the histogram of each stage entered,
+ * to the given stream.
+ */
+void report( std::ostream &os );
+
+
+/**
+ * Returns the report written by report().
+ */
+std::string report();
+
+
+/**
+ * Clears every stage and counter.
+ */
+void reset();
+
+
+/**
+ * Records the duration of the stage for which it is declared, from its construction
+ * to its destruction.
+ */
+class ScopedTimer
+{
+public:
+
+	ScopedTimer( Stage stage ) : m_stage( stage ), m_start( wallSeconds() ) {}
+
+	~ScopedTimer() { record( m_stage, wallSeconds() - m_start ); }
+
+private:
+
+	ScopedTimer( const ScopedTimer& ); // not copyable
+	ScopedTimer& operator=( const ScopedTimer& );
+
+	const Stage m_stage;
+	const double m_start;
+};
+
+}
+
+
+#ifdef _INSTRUMENT
+
+/** Times the remainder of the enclosing scope as the given RmInstrument::Stage */
+#define RM_INSTRUMENT_TIMER( stage ) RmInstrument::ScopedTimer rmInstrumentTimer_( stage )
+
+/** Adds n to the given RmInstrument::Counter */
+#define RM_INSTRUMENT_COUNT( counter, n ) RmInstrument::count( counter, n )
+
+#else
+
+#define RM_INSTRUMENT_TIMER( stage )
+#define RM_INSTRUMENT_COUNT( counter, n )
+
+#endif
+
+#endif
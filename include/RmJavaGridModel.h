@@ -1,7 +1,7 @@
-// RmJavaGridModel.h
-
-#include <string>
-#include "../viewer/GridModel.h" // javac-generated file that prototypes all Java_GridModel_... methods
-
-void fireMapUpdateEvent( std::string eventString );
-
+// RmJavaGridModel.h
+
+#include <string>
+#include "../viewer/GridModel.h" // javac-generated file that prototypes all Java_GridModel_... methods
+
+void fireMapUpdateEvent( std::string eventString );
+
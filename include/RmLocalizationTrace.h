@@ -0,0 +1,187 @@
+// RmLocalizationTrace.h
+
+#ifndef RM_LOCALIZATION_TRACE_H
+#define RM_LOCALIZATION_TRACE_H
+
+#pragma warning( disable : 4786 )
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Aria.h"
+#include "RmExceptions.h"
+#include "RmUtility.h"
+
+
+/**
+ * Records the diagnostics of each localization performed by RmGlobalMap::localizedPose(),
+ * as a compact binary record per localization, such that localization may be diagnosed in
+ * every session at negligible cost.
+ * <p>
+ * Each Record holds the pose prior to localization, the extent of the pose distribution drawn
+ * about it, and, for each sonar, the best score of any pose, the number of poses achieving it,
+ * and the number from which the sonar's range is unobstructed, followed by the peak of the
+ * pose histogram, the candidate poses achieving it, and the pose chosen.
+ * Records are written to a file of the given name with ".lt" appended, beginning with a header
+ * as written by RmBinaryIO::writeHeader(), and are read back by read().
+ * <p>
+ * The grids from which each record is drawn (the pose distribution, and the pose selections,
+ * unobstructed poses, and occupancy at the range of each sonar, and the pose histogram) are
+ * too large to be written for every localization, and so are written as text, with ".ltd"
+ * appended to the name, only for every localization sampled by the given interval, and for
+ * the next localization once requestDump() is called.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmLocalizationTrace trace( "session", 10 );
+ * 2    RmLocalizationTrace::Record r;
+ * 3    bool dump = trace.beginLocalization( r );
+ * 4    ... // fill r, writing to trace.dumpStream() if dump
+ * 5    trace.write( r );
+ * </pre>
+ */
+class RmLocalizationTrace
+{
+public:
+
+	/** The magic identifier of the trace file */
+	static const char *Magic;
+
+	/** The version of the trace file format */
+	static const int Version;
+
+
+	/** The diagnostics of a single sonar */
+	struct SonarRecord
+	{
+		/** The range reading, in millimeters */
+		int distance;
+
+		/** Whether the reading was in range, and so considered */
+		bool inRange;
+
+		/** The number of poses from which the reading's path is unobstructed */
+		int unobstructed;
+
+		/** The number of poses achieving the best score, each of which is counted in the pose
+			histogram */
+		int selected;
+
+		/** The best score of any pose: its probability of occupancy at the range reading,
+			weighted by the pose distribution */
+		float bestScore;
+	};
+
+
+	/** The diagnostics of a single localization */
+	struct Record
+	{
+		/** The number of the localization, beginning at 1 */
+		int localization;
+
+		/** The robot localized */
+		int robot;
+
+		/** The pose prior to localization, scaled */
+		RmUtility::Pose prior;
+
+		/** The width and height of the pose distribution drawn about the prior pose */
+		int width, height;
+
+		/** The distance traveled and degrees turned over the local map localized against */
+		float cumDistance, cumTurn;
+
+		SonarRecord sonars[NUM_SONARS];
+
+		/** The highest count of the pose histogram; 0 if no reading was in range */
+		int histogramPeak;
+
+		/** The number of poses achieving the histogram peak, and the number of those that
+			remain once filtered by the pose distribution */
+		int candidates, retained;
+
+		/** The pose chosen, scaled */
+		RmUtility::Pose chosen;
+
+		/** Whether the grids of the localization were dumped */
+		bool dumped;
+	};
+
+
+	/**
+	 * Opens a trace of the given name, to which ".lt" is appended.
+	 * @param dumpInterval the number of localizations between those whose grids are dumped,
+	 * beginning with the first; if 0, only those requested are dumped
+	 * @throws an RmExceptions::IOException if the trace file cannot be opened
+	 */
+	RmLocalizationTrace( const std::string &name, int dumpInterval = 0 );
+
+
+	/**
+	 * Numbers the given record as the next localization, clearing its remaining fields,
+	 * and returns true if its grids are to be dumped to dumpStream().
+	 */
+	bool beginLocalization( Record &r );
+
+
+	/**
+	 * Requests that the grids of the next localization be dumped, whether sampled or not.
+	 * May be called from any thread.
+	 */
+	void requestDump();
+
+
+	/**
+	 * Returns the text stream to which the grids of a localization are dumped, opening it
+	 * upon the first call.
+	 */
+	std::ostream& dumpStream();
+
+
+	/**
+	 * Writes the given record to the trace file.
+	 * @throws an RmExceptions::IOException if the record cannot be written
+	 */
+	void write( const Record &r );
+
+
+	/**
+	 * Returns the number of localizations begun.
+	 */
+	int localizations() const { return m_localizations; }
+
+
+	/**
+	 * Reads the header of a trace file, which must be opened in binary mode.
+	 * @throws an RmExceptions::IOException if the file is not a trace of a compatible version
+	 */
+	static void readHeader( std::istream &is );
+
+
+	/**
+	 * Reads the next record of a trace file, returning false at the end of the file.
+	 * @throws an RmExceptions::IOException if the file ends within a record
+	 */
+	static bool read( std::istream &is, Record &r );
+
+
+	/**
+	 * Writes the given record as text, one line for the localization and one for each sonar
+	 * in range.
+	 */
+	friend std::ostream& operator<<( std::ostream &os, const Record &r );
+
+private:
+
+	RmLocalizationTrace( const RmLocalizationTrace& ); // not copyable
+	RmLocalizationTrace& operator=( const RmLocalizationTrace& );
+
+	std::string m_name;
+	std::ofstream m_trace;
+	std::ofstream m_dump; // opened upon the first dump
+	const int m_dumpInterval;
+	int m_localizations;
+	bool m_dumpRequested;
+	ArMutex m_mutex; // serializes access to m_dumpRequested
+};
+
+#endif
@@ -0,0 +1,146 @@
+// RmMapFusion.h
+
+#ifndef RM_MAP_FUSION_H
+#define RM_MAP_FUSION_H
+
+#pragma warning( disable : 4786 )
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Aria.h"
+#include "RmExceptions.h"
+#include "RmGlobalMap.h"
+#include "RmMapSnapshotter.h"
+#include "RmSettings.h"
+#include "RmUtility.h"
+
+class FusedRobot;
+class RmSonarMapper;
+
+
+/**
+ * Fuses the sonar data of several robots mapping the same environment into a single global
+ * map, ingesting the data of each robot on a thread of its own.
+ * <p>
+ * Each robot is numbered in the order in which it is added, beginning at 0, and is mapped as
+ * described by RmGlobalMap::update( const RmUtility::SonarReading&, int ): it follows its own
+ * trajectory of local maps, corrected by its own accumulated pose shift, while the local maps
+ * of every robot are fused by the one region map.
+ * The readings of each robot are collected into sweeps by an RmSonarMapper of its own,
+ * exactly as are those of a single robot, and each sweep is mapped while holding the lock,
+ * such that the robots are mapped in the order in which their sweeps arrive, and the map is
+ * never checkpointed (see RmGlobalMap::checkpointIfDue()) part way through the sweep of any.
+ * Should the map have been restored from a snapshot of the session, those sweeps of each
+ * robot mapped before the snapshot was taken are skipped (see RmGlobalMap::resumeSweep()).
+ * As that order depends upon the scheduling of the threads, so may the fused map where
+ * the robots' maps overlap.
+ * <p>
+ * Sonar data is read as text, one sweep per line, as written by RmSonarMapper to a sonar data
+ * file, such that recorded sessions may be replayed concurrently, each standing in for a robot.
+ * Should the map be read or modified by any other thread while the robots are being ingested,
+ * that thread must hold the lock provided by lock() and unlock().
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmMapFusion fusion( map, settings );
+ * 2    fusion.addRobot( sonarStream1 );
+ * 3    fusion.addRobot( sonarStream2 );
+ * 4    fusion.start();
+ * 5    fusion.join();
+ * 6    map.finalize();
+ * </pre>
+ */
+class RmMapFusion
+{
+public:
+
+	/**
+	 * Initializes a fusion of the given map, to which no robots have yet been added.
+	 * @param map the map into which the robots are fused
+	 * @param settings the settings passed on to the RmSonarMapper of each robot
+	 * @param snapshotter if not null, the snapshotter whose takeIfDue() is called after each
+	 * sweep is mapped, such that readers of the snapshots need not hold the lock
+	 */
+	RmMapFusion( RmGlobalMap &map, const RmSettings &settings,
+		RmMapSnapshotter *snapshotter = NULL );
+
+
+	/**
+	 * Waits for the ingest threads, if started and not yet joined, and deletes the robots.
+	 */
+	~RmMapFusion();
+
+
+	/**
+	 * Adds a robot whose sonar data is read from the given stream, which must remain open
+	 * until the robot has been joined.
+	 * @return the number by which the robot is identified to the map
+	 * @throws an RmExceptions::InvalidStateException if the robots have already been started
+	 */
+	int addRobot( std::istream &sonarData );
+
+
+	/**
+	 * Returns the number of robots added.
+	 */
+	int robots() const { return static_cast<int>(m_robots.size()); }
+
+
+	/**
+	 * Starts the ingest thread of every robot, each of which reads its sonar data until the
+	 * end of its stream.
+	 * @throws an RmExceptions::InvalidStateException if the robots have already been started
+	 */
+	void start();
+
+
+	/**
+	 * Waits for the ingest thread of every robot to reach the end of its sonar data.
+	 * Should the ingest of any robot have failed, that robot's thread ends early, while the
+	 * others continue.
+	 * @throws the RmExceptions::Exception by which the lowest numbered robot failed, if any,
+	 * once all threads have ended
+	 */
+	void join();
+
+
+	/**
+	 * Waits until no other thread holds the lock, then holds it, that the map may be read or
+	 * modified outside the ingest threads.
+	 */
+	void lock() { m_mutex.lock(); }
+
+
+	/**
+	 * Releases the lock held by lock().
+	 */
+	void unlock() { m_mutex.unlock(); }
+
+private:
+
+	friend class FusedRobot;
+
+	/**
+	 * Maps the given sweep of the given robot by the robot's RmSonarMapper while holding
+	 * the lock, or resumes the mapper at the sweep, then checkpoints the map and takes a
+	 * snapshot if due.
+	 * @param sweep the position of the sweep within the robot's sonar data
+	 * @param resume the position of the sweep at which the robot's mapping is resumed, as
+	 * returned by RmGlobalMap::resumeSweep() before the robots were started
+	 */
+	void ingest( RmSonarMapper &mapper, RmUtility::SonarReading &readings, int sweep, 
+		int resume, int robot );
+
+	RmMapFusion( const RmMapFusion& ); // not copyable
+	RmMapFusion& operator=( const RmMapFusion& );
+
+	RmGlobalMap &m_map;
+	const RmSettings &m_settings;
+	RmMapSnapshotter *m_snapshotter;
+	ArMutex m_mutex; // serializes access to the map
+	std::vector<FusedRobot*> m_robots; // indexed by robot number
+	bool m_running; // indicates the ingest threads have been started and not yet joined
+	bool m_started; // indicates the ingest threads have been started
+};
+
+#endif
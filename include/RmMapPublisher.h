@@ -0,0 +1,252 @@
+// RmMapPublisher.h
+
+#ifndef RM_MAP_PUBLISHER_H
+#define RM_MAP_PUBLISHER_H
+
+#pragma warning( disable : 4786 )
+
+#include <string>
+#include <vector>
+#include "Aria.h"
+#include "RmActionHandler.h"
+#include "RmGlobalMap.h"
+#include "RmServer.h"
+#include "RmSocket.h"
+
+
+/**
+ * Publishes the state of a global map to a single client as compressed tile deltas,
+ * bringing the client up to date with the latest version of the map rather than replaying
+ * every intermediate value of every cell as do the update strings of RmSonarMap::update().
+ * <p>
+ * Each call to publish() sends, as an update, those tiles (see RmGlobalMap::changedTiles())
+ * that have changed since the client's baseline: the version last acknowledged by the client
+ * or, for a client that has never acknowledged one, the version last sent.
+ * Every tile carries the absolute content of its cells, so a tile lost in transit is made good
+ * by the next update that carries it; a client that acknowledges receives every changed tile
+ * again until it acknowledges an update that carried it.
+ * Periodic keyframes, which carry every mapped tile, allow a client that joins late, or that
+ * never acknowledges, to converge, as does a keyframe requested by the client.
+ * <h3>Protocol</h3>
+ * An update consists of one or more frames, each no larger than the transport allows.
+ * Each frame consists of a HeaderSize-byte header, all values in network byte order:
+ * <pre>
+ * Offset  Size  Content
+ *  0       2    "RD"
+ *  2       1    Version
+ *  3       1    flags; bit 0 is set if the update is a keyframe
+ *  4       4    the map version to which the update brings the client
+ *  8       4    the base version the client must hold for the update to do so; 0 for a keyframe
+ * 12       2    the index of this frame within the update
+ * 14       2    the number of frames in the update
+ * 16       2    the width and height of each tile, in cells
+ * 18       2    the number of tiles n in this frame
+ * </pre>
+ * followed by n tiles, each consisting of
+ * <pre>
+ *  0       2    tile column
+ *  2       2    tile row
+ *  4       1    encoding; 0 if raw, 1 if run-length
+ *  5       2    length of the cell data, in bytes
+ *  7            cell data
+ * </pre>
+ * The cells of a tile are probabilities quantized by RmUtility::quantize(), ordered
+ * left-to-right, top-to-bottom beginning at the upper-left corner of the tile (see
+ * RmGlobalMap::tileBound()), and stored either raw or as a series of (count, value)
+ * byte pairs, whichever is the shorter.
+ * The client discards everything it holds upon the first frame of a keyframe.
+ * <p>
+ * The client replies with lines of text: <code>ack version</code> once it holds every frame
+ * of an update and the base version, and <code>keyframe</code> to request a keyframe.
+ * RmMapReplica implements the client, and may stand in for one.
+ * <h3>Usage</h3>
+ * The publisher reads the map directly, and must therefore be called from the thread that
+ * updates it.
+ * <pre>
+ * 1    RmMapPublisher::DatagramTransport transport( &server );
+ * 2    RmMapPublisher publisher( map, transport );
+ * 3    while ( publisher.service( 0 ) ) ;
+ * 4    publisher.publish();
+ * </pre>
+ * Line 3 processes all acknowledgements received since the last call.
+ * Alternatively, as an RmActionHandler installed after the RmSonarMapper that updates the
+ * map, the publisher does both with each robot action (see handleAction()).
+ */
+class RmMapPublisher : /* is-a */ public RmActionHandler
+{
+public:
+
+	/**
+	 * Carries frames from a publisher to its client, and the client's replies back.
+	 */
+	class Transport
+	{
+	public:
+
+		virtual ~Transport() {}
+
+		/**
+		 * Returns the size of the largest frame that may be sent, in bytes.
+		 */
+		virtual int maxFrame() const = 0;
+
+		/**
+		 * Sends the given frame to the client.
+		 * @throw an RmExceptions::SocketException if unable to reach the client
+		 */
+		virtual void send( const std::string &frame ) = 0;
+
+		/**
+		 * Receives the next line of text sent by the client, waiting no longer than the given
+		 * timeout.
+		 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+		 * @return false if the timeout expired before a line was received
+		 */
+		virtual bool receive( std::string &line, int timeout ) = 0;
+	};
+
+
+	/**
+	 * Carries each frame as a datagram served by an RmServer, with frames limited to
+	 * RmViewerStream::DefaultPayload bytes; replies are the datagrams sent by the client.
+	 */
+	class DatagramTransport : public Transport
+	{
+	public:
+
+		DatagramTransport( RmServer *server ) : m_server( server ) {}
+
+		virtual int maxFrame() const;
+		virtual void send( const std::string &frame );
+		virtual bool receive( std::string &line, int timeout );
+
+	private:
+
+		RmServer *m_server;
+	};
+
+
+	/**
+	 * Carries frames over a connected stream (TCP) socket, each preceded by its length as
+	 * a 32-bit integer in network byte order; replies are newline-terminated lines.
+	 * The socket is neither connected nor closed by the transport.
+	 */
+	class StreamTransport : public Transport
+	{
+	public:
+
+		StreamTransport( RmSocket::Socket socket ) : m_socket( socket ) {}
+
+		virtual int maxFrame() const;
+		virtual void send( const std::string &frame );
+		virtual bool receive( std::string &line, int timeout );
+
+	private:
+
+		RmSocket::Socket m_socket;
+		std::string m_received; // bytes received but not yet returned as a line
+	};
+
+
+	/** The size of the header of each frame, in bytes */
+	static const int HeaderSize;
+
+	/** The version of the protocol */
+	static const unsigned char Version;
+
+	/** The number of calls to publish() between keyframes unless otherwise specified */
+	static const int DefaultKeyframeInterval;
+
+	/** The minimum time, in milliseconds, between updates published by handleAction() */
+	static const int DefaultPublishInterval;
+
+
+	/**
+	 * Initializes a publisher whose first update will be a keyframe.
+	 * @param map the map to be published
+	 * @param transport the transport over which the client is reached
+	 * @param keyframeInterval the number of calls to publish() after which a keyframe is sent
+	 * in place of an update; if zero, keyframes are sent only as required or requested
+	 * @throw an RmExceptions::InvalidParameterException if the transport cannot carry a frame
+	 * of a single tile
+	 */
+	RmMapPublisher( const RmGlobalMap &map, Transport &transport,
+		int keyframeInterval = DefaultKeyframeInterval );
+
+
+	/**
+	 * Processes every reply received from the client, then, once the client has replied,
+	 * calls publish() if DefaultPublishInterval has elapsed since it was last called.
+	 * Replies are how a client makes itself known to a transport such as DatagramTransport,
+	 * and an RmMapReplica begins by requesting a keyframe.
+	 * Should the client be unreachable, nothing more is published until it next replies.
+	 */
+	virtual void handleAction( ArRobot *robot );
+
+
+	/**
+	 * Sends an update of the tiles changed since the client's baseline, or a keyframe if
+	 * one is due, requested, or required because the map has been emptied or restored since.
+	 * Nothing is sent if no tile has changed.
+	 * @return the number of tiles sent
+	 * @throw an RmExceptions::SocketException if unable to reach the client
+	 */
+	int publish();
+
+
+	/**
+	 * Receives and processes the next reply from the client, if any, waiting no longer than
+	 * the given timeout.
+	 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+	 * @return false if the timeout expired before a reply was received
+	 */
+	bool service( int timeout );
+
+
+	/**
+	 * Records that the client holds the given version of the map.
+	 * Versions older than one already acknowledged, or newer than any sent, are ignored.
+	 */
+	void acknowledge( unsigned long version );
+
+
+	/**
+	 * Causes the next call to publish() to send a keyframe.
+	 */
+	void requestKeyframe() { m_keyframeDue = true; }
+
+
+	/**
+	 * Returns the version last acknowledged by the client, or 0 if none has been.
+	 */
+	unsigned long ackedVersion() const { return m_acked; }
+
+
+	/**
+	 * Returns the version of the map as of the last update sent.
+	 */
+	unsigned long sentVersion() const { return m_sent; }
+
+
+	/**
+	 * Encodes the given tile of the given map, appending it to the given frame in the format
+	 * described above.
+	 */
+	static void encodeTile( const RmGlobalMap &map, const RmUtility::Coord &tile, std::string &frame );
+
+private:
+
+	const RmGlobalMap &m_map;
+	Transport &m_transport;
+	int m_keyframeInterval;
+
+	bool m_heard; // whether the client has replied since it was last unreachable
+	ArTime m_published; // the time at which handleAction() last called publish()
+	bool m_keyframeDue; // whether a keyframe is to be sent by the next call to publish()
+	int m_sinceKeyframe; // calls to publish() since the last keyframe
+	bool m_acking; // whether the client has ever acknowledged an update
+	unsigned long m_acked; // see ackedVersion()
+	unsigned long m_sent; // see sentVersion()
+};
+
+#endif
@@ -0,0 +1,93 @@
+// RmMapQueryServer.h
+
+#ifndef RM_MAP_QUERY_SERVER_H
+#define RM_MAP_QUERY_SERVER_H
+
+#pragma warning( disable : 4786 )
+
+#include <string>
+#include "RmServer.h"
+#include "RmMapSnapshot.h"
+#include "RmMapSnapshotter.h"
+
+
+/**
+ * Provides a UDP socket server that answers queries of a global map as it is being built,
+ * such as those of a path planner, from the latest snapshot taken by an RmMapSnapshotter,
+ * so that answering a query never delays the mapping.
+ * <h3>Protocol</h3>
+ * Each query is a datagram holding a line of text, answered by a single datagram that begins
+ * with the keyword of the query followed by the version of the snapshot (see
+ * RmGlobalMap::version()) from which it was answered.
+ * All coordinates are in grid cells, as are those of the grid file, and all angles are in
+ * degrees, as are those of the robot's pose; probabilities are quantized by
+ * RmUtility::quantize().
+ * <pre>
+ * Query                                 Reply
+ * pose [robot]                          pose version x y theta shiftX shiftY shiftTheta
+ * bound                                 bound version ulX ulY lrX lrY
+ * cells ulX ulY lrX lrY                 cells version ulX ulY lrX lrY, a newline, and the
+ *                                       probability of each cell within the bound as a single
+ *                                       byte, left-to-right, top-to-bottom
+ * occupancy x1 y1 [x2 y2 ...]           occupancy version pr1 [pr2 ...]
+ * ray x y theta range                   ray version hit x y, or ray version clear
+ * </pre>
+ * <code>pose</code> returns the pose of the given robot, or of robot 0 if none is given, 
+ * as corrected by localization, and the accumulated shift by which it was corrected
+ * (see RmMapFusion); <code>bound</code> returns the bound
+ * of the mapped cells, rounded out to whole tiles; <code>ray</code> returns the first
+ * cell obstructed (see RmSettings::ObstructedCertainty) within the given range of the given
+ * pose, if any, following the ray no further than the farthest corner of the bound, nor
+ * for more than MaxCells cells.
+ * A query that cannot be answered is replied to with <code>error</code> followed by the reason.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmMapSnapshotter snapshotter( map, settings );
+ * 2    actionHandlers.push_back( &snapshotter );
+ * 3    RmMapQueryServer server( port, snapshotter );
+ * 4    while ( server.service( RmSocket::Forever ) ) ;
+ * </pre>
+ */
+class RmMapQueryServer : /* is-a */ public RmServer
+{
+public:
+
+	/** The largest number of cells that may be returned by a single <code>cells</code> query,
+		or followed by a single <code>ray</code> query */
+	static const int MaxCells;
+
+
+	/**
+	 * Initializes a UDP server that answers queries from the snapshots of the given
+	 * snapshotter.
+	 * @throw an RmExceptions::SocketException if unable to create the socket
+	 */
+	RmMapQueryServer( const short portNumber, RmMapSnapshotter &snapshotter,
+		const std::string name = "Map query server" );
+
+
+	/**
+	 * Receives the next query from any client, waiting no longer than the given timeout,
+	 * and replies to it.
+	 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+	 * @return false if the timeout expired before a query was received
+	 * @throw an RmExceptions::SocketException if unable to reach the client
+	 */
+	bool service( int timeout );
+
+
+	/**
+	 * Answers the given query from the given snapshot, as described above.
+	 * @param snapshot the snapshot from which to answer
+	 * @param query the query, as received from the client
+	 * @param reply receives the reply
+	 */
+	static void answer( const RmMapSnapshot *snapshot, const std::string &query,
+		std::string &reply );
+
+private:
+
+	RmMapSnapshotter &m_snapshotter;
+};
+
+#endif
@@ -0,0 +1,94 @@
+// RmMapReplica.h
+
+#ifndef RM_MAP_REPLICA_H
+#define RM_MAP_REPLICA_H
+
+#pragma warning( disable : 4786 )
+
+#include <string>
+#include <vector>
+#include "RmMutableCartesianGrid.h"
+
+
+/**
+ * Reconstructs a global map from the frames sent by an RmMapPublisher, serving as the
+ * reference implementation of its client and as a stand-in for one.
+ * Frames are passed to apply() in the order received, however they are carried; each tile
+ * replaces the corresponding cells of the replica, and reply() then returns the line of text
+ * with which the publisher is to be answered.
+ * <p>
+ * Frames of an update older than the newest seen are discarded, so that a frame delayed
+ * in transit cannot undo a later one.  The replica holds a version once it has applied every
+ * frame of an update while holding that update's base version (see RmMapPublisher).
+ * <h3>Dependencies</h3>
+ * The replica is held in an RmMutableCartesianGrid of probabilities quantized by
+ * RmUtility::quantize(), which expands as tiles arrive.
+ */
+class RmMapReplica
+{
+public:
+
+	/**
+	 * Initializes an empty replica that holds no version of the map.
+	 */
+	RmMapReplica();
+
+
+	/**
+	 * Applies the given frame to the replica.
+	 * @param data the frame, as sent by the publisher
+	 * @param length the number of bytes of data
+	 * @return false if the frame was discarded as stale
+	 * @throws an RmExceptions::IOException if the frame is malformed
+	 */
+	bool apply( const char *data, int length );
+
+
+	/**
+	 * Returns the line of text with which to answer the publisher:
+	 * <code>ack version</code> if a version is held, otherwise <code>keyframe</code>.
+	 */
+	std::string reply() const;
+
+
+	/**
+	 * Returns true if the replica holds a complete version of the map; see version().
+	 */
+	bool current() const { return m_current; }
+
+
+	/**
+	 * Returns the version of the map held by the replica, valid only if current().
+	 */
+	unsigned long version() const { return m_version; }
+
+
+	/**
+	 * Returns the quantized probability of the given cell, or that of RmBayesCertaintyGrid::InitVal
+	 * if it has not been received.
+	 */
+	unsigned char valueAt( int x, int y ) const {
+		return m_grid.inBounds( x, y ) ? m_grid.valueAt( x, y ) : m_grid.initValue(); }
+
+
+	/**
+	 * Returns the replica itself.
+	 */
+	const RmMutableCartesianGrid<unsigned char>& grid() const { return m_grid; }
+
+private:
+
+	RmMutableCartesianGrid<unsigned char> m_grid;
+
+	bool m_current; // see current()
+	unsigned long m_version; // see version()
+
+	unsigned long m_newest; // the version of the newest update of which a frame has been seen
+	unsigned long m_base; // the base version of that update
+	int m_framesSeen; // the number of its frames seen
+	int m_frameCount; // the number of frames it comprises
+	std::vector<bool> m_seen; // a flag for each of its frames, set once seen
+	bool m_keyframe; // whether it is a keyframe
+};
+
+#endif
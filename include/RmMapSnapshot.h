@@ -0,0 +1,142 @@
+// RmMapSnapshot.h
+
+#ifndef RM_MAP_SNAPSHOT_H
+#define RM_MAP_SNAPSHOT_H
+
+#pragma warning( disable : 4786 )
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include "RmGlobalMap.h"
+#include "RmMutableCartesianGrid.h"
+#include "RmUtility.h"
+
+
+/**
+ * Holds an unchanging copy of a global map as it appeared to the viewer at a given version
+ * (see RmGlobalMap::liveValueAt()), together with the pose and accumulated shift of each robot
+ * at that version, so that the map may be read from any thread while it continues to be built.
+ * <p>
+ * Cells are held in the tiles by which the map versions its changes (see
+ * RmGlobalMap::tileBound()); cells outside every mapped tile hold RmBayesCertaintyGrid::InitVal.
+ * Tiles are never modified once copied, and are shared between snapshots: a snapshot taken with
+ * a prior snapshot of the same map shares every tile of the prior snapshot that has not changed
+ * since, and copies from the map only those that have, so that successive snapshots cost
+ * little more than the changes between them.
+ * <h3>Usage</h3>
+ * As tiles are counted without synchronization, snapshots that may share tiles must be
+ * created and destroyed on a single thread, that which updates the map; RmMapSnapshotter
+ * does so on behalf of readers on other threads.
+ * @see RmMapQueryServer
+ */
+class RmMapSnapshot
+{
+public:
+
+	/**
+	 * Copies the given map.
+	 * @param map the map to be copied, which must not be updated while it is being copied
+	 * @param obstructedCertainty the probability at and above which rayCast() considers a
+	 * cell obstructed, normally RmSettings::ObstructedCertainty
+	 * @param prior a snapshot previously taken of the same map, with which unchanged tiles
+	 * are shared, or null
+	 */
+	RmMapSnapshot( const RmGlobalMap &map, float obstructedCertainty,
+		const RmMapSnapshot *prior = NULL );
+
+
+	/**
+	 * Releases the tiles of the snapshot, deleting those no other snapshot shares.
+	 */
+	~RmMapSnapshot();
+
+
+	/**
+	 * Returns the version of the map copied; see RmGlobalMap::version().
+	 */
+	unsigned long version() const { return m_version; }
+
+
+	/**
+	 * Returns the number of robots mapped; see RmGlobalMap::robots().
+	 */
+	int robots() const { return static_cast<int>(m_robotPoses.size()); }
+
+
+	/**
+	 * Returns the pose of the given robot, in grid coordinates; see RmGlobalMap::robotPose().
+	 */
+	RmUtility::Pose robotPose( int robot = 0 ) const;
+
+
+	/**
+	 * Returns the accumulated pose shift of the given robot, in grid coordinates; see
+	 * RmGlobalMap::accumulatedShift().
+	 */
+	RmUtility::Pose accumulatedShift( int robot = 0 ) const;
+
+
+	/**
+	 * Returns the bound of the mapped tiles, which is that of the origin cell alone if
+	 * none are mapped.
+	 */
+	RmUtility::BoundBox bound() const { return m_bound; }
+
+
+	/**
+	 * Returns the probability of the given cell.
+	 */
+	float valueAt( int x, int y ) const;
+
+
+	/**
+	 * Appends to the given string the probability of every cell within the given bound,
+	 * quantized by RmUtility::quantize(), one byte per cell, ordered left-to-right,
+	 * top-to-bottom beginning at the upper-left corner of the bound.
+	 */
+	void cells( const RmUtility::BoundBox &bound, std::string &s ) const;
+
+
+	/**
+	 * Replaces the given grid with one spanning bound() that holds the value of every cell.
+	 */
+	void grid( RmMutableCartesianGrid<float> &grid ) const;
+
+
+	/**
+	 * Follows a ray from the given pose for the given distance, in cells, and returns true
+	 * if it meets an obstructed cell within that distance, the first such cell being returned by
+	 * <code>hit</code>.  The cell from which the ray begins is not tested.
+	 */
+	bool rayCast( const RmUtility::Pose &from, int range, RmUtility::Coord &hit ) const;
+
+private:
+
+	/** The cells of a tile, ordered from its upper-left corner, and the snapshots sharing them */
+	struct Tile
+	{
+		std::vector<float> cells;
+		int references;
+	};
+
+	/** The tiles of the map, keyed by tile row and column as in RmGlobalMap */
+	typedef std::map<std::pair<int,int>,Tile*> TileMap;
+
+	/** Returns the tile row or column in which the given cell row or column lies */
+	static int tileOf( int c );
+
+	RmMapSnapshot( const RmMapSnapshot& ); // not copyable
+	RmMapSnapshot& operator=( const RmMapSnapshot& );
+
+	unsigned long m_version; // see version()
+	unsigned long m_resetVersion; // RmGlobalMap::resetVersion() as of version()
+	std::vector<RmUtility::Pose> m_robotPoses; // see robotPose(), indexed by robot
+	std::vector<RmUtility::Pose> m_accumShifts; // see accumulatedShift(), indexed by robot
+	RmUtility::BoundBox m_bound; // see bound()
+	float m_obstructed; // the probability at and above which a cell is obstructed
+	TileMap m_tiles;
+};
+
+#endif
@@ -0,0 +1,103 @@
+// RmMapSnapshotter.h
+
+#ifndef RM_MAP_SNAPSHOTTER_H
+#define RM_MAP_SNAPSHOTTER_H
+
+#pragma warning( disable : 4786 )
+
+#include <map>
+#include <vector>
+#include "Aria.h"
+#include "RmActionHandler.h"
+#include "RmGlobalMap.h"
+#include "RmMapSnapshot.h"
+#include "RmSettings.h"
+
+
+/**
+ * Takes snapshots of a global map on the thread that updates it, and shares the latest
+ * with readers on any other thread, such that neither ever waits on the other for longer
+ * than it takes to exchange a pointer.
+ * <p>
+ * As an RmActionHandler installed after the RmSonarMapper that updates the map, the
+ * snapshotter takes a snapshot with each robot action in which the map has changed,
+ * no more often than the given interval.
+ * A reader calls acquire() for the latest snapshot, which remains valid, however many
+ * snapshots have since been taken, until passed to release().
+ * Snapshots are deleted only by the thread that takes them, once superseded and released,
+ * so that the tiles they share are never counted by two threads at once (see RmMapSnapshot).
+ * <p>
+ * Should the map be modified by more than one thread, such as by a robot and by a user
+ * who empties it, each must hold the same lock while modifying the map and taking snapshots;
+ * readers never do.
+ */
+class RmMapSnapshotter : /* is-a */ public RmActionHandler
+{
+public:
+
+	/** The minimum time between snapshots taken by handleAction() unless otherwise specified */
+	static const int DefaultInterval;
+
+
+	/**
+	 * Initializes a snapshotter, taking a first snapshot of the map.
+	 * @param map the map of which snapshots are to be taken
+	 * @param settings specifies RmSettings::ObstructedCertainty, as of each snapshot
+	 * @param interval the minimum time, in milliseconds, between snapshots taken by
+	 * takeIfDue()
+	 */
+	RmMapSnapshotter( const RmGlobalMap &map, const RmSettings &settings,
+		int interval = DefaultInterval );
+
+
+	/**
+	 * Deletes every snapshot; every snapshot acquired must first have been released.
+	 */
+	virtual ~RmMapSnapshotter();
+
+
+	/**
+	 * Calls takeIfDue().
+	 */
+	virtual void handleAction( ArRobot *robot ) { takeIfDue(); }
+
+
+	/**
+	 * Takes a snapshot of the map, unless one of its current version has already been taken,
+	 * and makes it the latest, deleting those superseded snapshots no reader holds.
+	 * Must be called from the thread that updates the map.
+	 */
+	void take();
+
+
+	/**
+	 * Calls take() if the interval has elapsed since the last snapshot was taken.
+	 */
+	void takeIfDue() { if ( m_taken.mSecSince() >= m_interval ) take(); }
+
+
+	/**
+	 * Returns the latest snapshot, which must be passed to release() once no longer used.
+	 */
+	const RmMapSnapshot* acquire();
+
+
+	/**
+	 * Releases the given snapshot, as returned by acquire().
+	 */
+	void release( const RmMapSnapshot *snapshot );
+
+private:
+
+	const RmGlobalMap &m_map;
+	const RmSettings &m_settings;
+	int m_interval;
+	ArTime m_taken; // the time at which the latest snapshot was taken
+
+	ArMutex m_mutex; // guards the snapshots and their reader counts
+	const RmMapSnapshot *m_latest; // the latest snapshot
+	std::vector<const RmMapSnapshot*> m_retired; // superseded snapshots not yet deleted
+	std::map<const RmMapSnapshot*,int> m_readers; // the number of readers of each held snapshot
+};
+
+#endif
@@ -0,0 +1,140 @@
+// RmPool.h
+
+#ifndef RM_POOL_H
+#define RM_POOL_H
+
+#include <new>
+#include <vector>
+#include <cassert>
+
+
+/**
+ * Provides the storage of objects of a single type from blocks of many, such that objects
+ * created and destroyed at a high rate, such as the local maps and regions of RmGlobalMap,
+ * are not each allocated from the heap.
+ * <p>
+ * Storage is carved from each block in turn, and storage released by deallocate() is kept on
+ * a free list for the next allocate(), so that a slot is reused before another is carved.
+ * The pool neither constructs nor destroys objects: each is constructed by placement
+ * <code>new</code> over the storage returned by allocate(), and destroyed explicitly before
+ * its storage is returned.
+ * Every block is released at once by release(), or by destruction of the pool, which should
+ * happen only once each object of the pool has been destroyed, since no destructor is run.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmPool<Region> pool;
+ * 2    Region *r = new (pool.allocate()) Region( id, bound );
+ * 3    r->~Region();
+ * 4    pool.deallocate( r );
+ * 5    pool.release();
+ * </pre>
+ */
+template<class T>
+class RmPool
+{
+public:
+
+	/** The number of objects held by each block, by default */
+	enum { DefaultBlockSize = 64 };
+
+
+	/**
+	 * Creates a pool, allocating no block until the first call to allocate().
+	 * @param blockSize the number of objects held by each block
+	 */
+	RmPool( int blockSize = DefaultBlockSize )
+		: m_blockSize(blockSize < 1 ? 1 : blockSize), m_next(0), m_free(NULL), m_live(0) {}
+
+
+	/**
+	 * Releases every block.
+	 */
+	~RmPool() { release(); }
+
+
+	/**
+	 * Returns uninitialized storage for one object, allocating another block should those
+	 * allocated be exhausted.
+	 * @throws std::bad_alloc if a block cannot be allocated
+	 */
+	void* allocate()
+	{
+		++m_live;
+		if ( m_free != NULL )
+		{
+			Slot *slot = m_free;
+			m_free = slot->next;
+			return slot;
+		}
+		if ( m_blocks.empty() || m_next == m_blockSize )
+		{
+			m_blocks.reserve( m_blocks.size() + 1 ); // so that push_back() cannot throw
+			m_blocks.push_back( static_cast<char*>(::operator new( m_blockSize * SlotSize )) );
+			m_next = 0;
+		}
+		return m_blocks.back() + SlotSize * m_next++;
+	}
+
+
+	/**
+	 * Returns the given storage, allocated by allocate() and whose object has been destroyed,
+	 * to the pool for reuse.
+	 */
+	void deallocate( void *p )
+	{
+		if ( p == NULL ) return;
+		assert( m_live > 0 );
+		--m_live;
+		Slot *slot = static_cast<Slot*>(p);
+		slot->next = m_free;
+		m_free = slot;
+	}
+
+
+	/**
+	 * Releases every block at once, invalidating all storage allocated, including any whose
+	 * object was never returned, such as one whose constructor threw.
+	 */
+	void release()
+	{
+		std::vector<char*>::const_iterator block;
+		for ( block = m_blocks.begin(); block != m_blocks.end(); ++block ) ::operator delete( *block );
+		std::vector<char*>().swap( m_blocks );
+		m_next = 0;
+		m_free = NULL;
+		m_live = 0;
+	}
+
+
+	/**
+	 * Returns the number of objects whose storage is allocated.
+	 */
+	int live() const { return m_live; }
+
+
+	/**
+	 * Returns the number of bytes allocated to the blocks of the pool, whether or not in use.
+	 */
+	unsigned long allocatedBytes() const {
+		return static_cast<unsigned long>(m_blocks.size() * m_blockSize * SlotSize); }
+
+private:
+
+	RmPool( const RmPool& ); // not copyable
+	RmPool& operator=( const RmPool& );
+
+	/** The storage of an object, which holds the next free slot once returned */
+	struct Slot { Slot *next; };
+
+	/** The bytes of each slot, which are a multiple of the alignment of both T and Slot */
+	enum { SlotSize = sizeof(T) > sizeof(Slot) ?
+		(sizeof(T) + sizeof(Slot) - 1) / sizeof(Slot) * sizeof(Slot) : sizeof(Slot) };
+
+	std::vector<char*> m_blocks;
+	const int m_blockSize;
+	int m_next; // the next slot of the last block never allocated
+	Slot *m_free; // the most recently returned slot
+	int m_live;
+};
+
+#endif
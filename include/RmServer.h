@@ -1,68 +1,104 @@
-// RmServer.h
-
-#ifndef RM_SERVER_H
-#define RM_SERVER_H
-
-#include <string>
-#include <winsock.h>
-
-
-/**
- * Provides a UDP socket server for wireless data transfer.
- * @see RmClient
- */
-class RmServer
-{
-public:
-
-	/**
-	 * Initializes a UDP server connection with which a client on the same port may
-	 * communicate using RmClient.
-	 * @throw an RmExceptions::SocketException if encounters the wrong winsock version
-	 */
-	RmServer( const short portNumber, const std::string name = "Remote control server" );
-
-
-	/**
-	 * Closes the connection.
-	 */
-	~RmServer();
-
-
-	/**
-	 * Returns the last message sent from the client, blocking until such message is received.
-	 */
-	std::string getClientString();
-
-
-	/**
-	 * Sends the given string to the client initialized at construction.
-	 * @throw an RmExceptions::SocketException if unable to reach client
-	 */
-	void sendClientReply( const std::string s );
-
-protected:
-
-	/**
-	 * Creates a UDP/IP datagram socket on the given port and binds the server to the socket.
-	 * @throw an RmExceptions::SocketException if unable to create or bind the socket
-	 */
-	int initServer( const short portNumber );
-
-	/**
-	 * Provides the means for dynamically creating an exception message that includes
-	 * the error followed by the name of the server given during construction.
-	 * Memory to accommodate the return string is allocated on each call.
-	 */
-	const char* message( const char *msg ) const;
-
-private:
-
-	SOCKET m_socket;
-	SOCKADDR_IN m_clientAddress;
-	SOCKADDR_IN m_serverAddress;
-	std::string m_name;
-	char m_szBuf[4096]; // this must be class-scope
-};
-
+// RmServer.h
+
+#ifndef RM_SERVER_H
+#define RM_SERVER_H
+
+#include <string>
+#include "RmSocket.h"
+
+
+/**
+ * Provides a UDP socket server for wireless data transfer.
+ * Messages may be awaited with or without a timeout, and from any number of servers at once
+ * using waitForClient(), allowing several servers to be serviced from a single loop.
+ * @see RmClient
+ */
+class RmServer
+{
+public:
+
+	/**
+	 * Initializes a UDP server connection with which a client on the same port may
+	 * communicate using RmClient.
+	 * @throw an RmExceptions::SocketException if encounters the wrong socket library version
+	 */
+	RmServer( const short portNumber, const std::string name = "Remote control server" );
+
+
+	/**
+	 * Closes the connection.
+	 */
+	virtual ~RmServer();
+
+
+	/**
+	 * Returns the last message sent from the client, blocking until such message is received,
+	 * or an empty string should the message not be received.
+	 */
+	std::string getClientString();
+
+
+	/**
+	 * Receives the next message sent from the client, waiting no longer than the given timeout.
+	 * @param s receives the message
+	 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+	 * @return false if the timeout expired before a message was received, or if it could not
+	 * be received, as when a datagram sent earlier was refused by its client
+	 * @throw an RmExceptions::SocketException if unable to wait on the socket
+	 */
+	virtual bool pollClientString( std::string &s, int timeout );
+
+
+	/**
+	 * Waits until a message from the client of any of the given servers may be received
+	 * without blocking, or until the given timeout expires.
+	 * @param servers the servers to be waited upon
+	 * @param count the number of servers
+	 * @param timeout the maximum time to wait, in milliseconds, or RmSocket::Forever
+	 * @return the index of the first server with a message waiting, or -1 if the timeout expired
+	 * @throw an RmExceptions::SocketException if unable to wait on the sockets
+	 */
+	static int waitForClient( RmServer *const *servers, int count, int timeout );
+
+
+	/**
+	 * Sends the given string to the client initialized at construction.
+	 * @throw an RmExceptions::SocketException if unable to reach client
+	 */
+	void sendClientReply( const std::string s );
+
+
+	/**
+	 * Sends the given binary data to the client initialized at construction as a single datagram.
+	 * @param data the data to be sent
+	 * @param length the number of bytes of data
+	 * @throw an RmExceptions::SocketException if unable to reach client
+	 */
+	virtual void sendClientData( const char *data, int length );
+
+protected:
+
+	/**
+	 * Creates a UDP/IP datagram socket on the given port and binds the server to the socket.
+	 * @throw an RmExceptions::SocketException if unable to create or bind the socket
+	 */
+	int initServer( const short portNumber );
+
+	/**
+	 * Provides the means for dynamically creating an exception message that includes
+	 * the error followed by the name of the server given during construction.
+	 * Memory to accommodate the return string is allocated on each call.
+	 */
+	const char* message( const char *msg ) const;
+
+	RmSocket::Socket m_socket;
+	sockaddr_in m_clientAddress; // the sender of the last message received
+	std::string m_name;
+
+private:
+
+	sockaddr_in m_serverAddress;
+	char m_szBuf[4096]; // this must be class-scope
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,136 @@
+// RmSocket.h
+
+#ifndef RM_SOCKET_H
+#define RM_SOCKET_H
+
+#include <string>
+
+#ifdef WIN32
+#include <winsock.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+
+
+/**
+ * Provides the portion of the socket API used by RmServer and RmClient in a form common to
+ * WinSock, under Windows, and to POSIX sockets, elsewhere.
+ * The standard BSD calls (<code>socket()</code>, <code>bind()</code>, <code>sendto()</code>,
+ * <code>recvfrom()</code>, and so on) are common to both and are used directly;
+ * this namespace supplies the types and calls that differ, along with waitReadable(),
+ * which allows any number of sockets to be serviced from a single loop.
+ */
+namespace RmSocket {
+
+#ifdef WIN32
+	/** The handle to a socket */
+	typedef SOCKET Socket;
+
+	/** The type of the address length passed to <code>recvfrom()</code> */
+	typedef int AddressLength;
+#else
+	typedef int Socket;
+	typedef socklen_t AddressLength;
+#endif
+
+	/** The handle returned by <code>socket()</code> upon failure */
+	extern const Socket InvalidSocket;
+
+	/** A timeout for waitReadable() that waits indefinitely */
+	const int Forever = -1;
+
+
+	/**
+	 * Initializes the socket library, as required by WinSock before any other call.
+	 * Each call must be matched by a call to cleanup().
+	 * @param caller the name of the calling function, as reported by any exception
+	 * @throws an RmExceptions::SocketException if the library is of the wrong version
+	 */
+	void startup( const char *caller );
+
+
+	/**
+	 * Releases the socket library once cleanup() has been called once for each call to startup().
+	 */
+	void cleanup();
+
+
+	/**
+	 * Closes the given socket.
+	 */
+	void close( Socket s );
+
+
+	/**
+	 * Waits until a datagram is ready to be received from one of the given sockets, such that
+	 * a subsequent call to <code>recvfrom()</code> on it will not block.
+	 * @param sockets the sockets to be waited upon
+	 * @param count the number of sockets
+	 * @param timeout the maximum time to wait, in milliseconds, or Forever
+	 * @return the index of the first of the given sockets that is ready, or -1 if the timeout
+	 * expired or the wait was interrupted by a signal
+	 * @throws an RmExceptions::SocketException if the wait fails
+	 */
+	int waitReadable( const Socket *sockets, int count, int timeout );
+
+
+	/**
+	 * Places the given socket in non-blocking mode, whereby a call that would otherwise block
+	 * instead fails, with wouldBlock() then returning true.
+	 * @throws an RmExceptions::SocketException if the mode cannot be set
+	 */
+	void setNonBlocking( Socket s );
+
+
+	/**
+	 * Returns true if the last failed call on a non-blocking socket failed only because it
+	 * would have blocked.
+	 */
+	bool wouldBlock();
+
+
+	/**
+	 * Appends the low 16 bits of the given value to the given message in network 
+	 * (big-endian) byte order.
+	 */
+	inline void put16( std::string &s, int v ) {
+		s += static_cast<char>( (v >> 8) & 0xff );
+		s += static_cast<char>( v & 0xff );
+	}
+
+
+	/**
+	 * Appends the low 32 bits of the given value to the given message in network byte order.
+	 */
+	inline void put32( std::string &s, unsigned long v ) {
+		put16( s, static_cast<int>( (v >> 16) & 0xffff ) );
+		put16( s, static_cast<int>( v & 0xffff ) );
+	}
+
+
+	/**
+	 * Returns the signed 16-bit value stored at the given position of a message in network
+	 * byte order.
+	 */
+	inline int get16( const char *p ) {
+		return static_cast<short>( ((p[0] & 0xff) << 8) | (p[1] & 0xff) );
+	}
+
+
+	/**
+	 * Returns the unsigned 32-bit value stored at the given position of a message in network
+	 * byte order.
+	 */
+	inline unsigned long get32( const char *p ) {
+		return (static_cast<unsigned long>( get16( p ) & 0xffff ) << 16) | (get16( p + 2 ) & 0xffff);
+	}
+}
+
+#endif
@@ -0,0 +1,167 @@
+// RmSonarHistory.h
+
+#ifndef RM_SONAR_HISTORY_H
+#define RM_SONAR_HISTORY_H
+
+#include <iostream>
+#include <vector>
+#include "RmUtility.h"
+
+
+/**
+ * Holds a history of sonar readings, in the order received, compactly enough that a local map
+ * may keep every reading it has mapped for later reorientation.
+ * <p>
+ * Each RmUtility::SonarReading carries the ranges of its entire sweep, such that the readings
+ * of one sonar after another, as passed to RmLocalMap::update(), duplicate the sweep once for
+ * each sonar.  Instead, consecutive readings of a sweep, those sharing a pose and ranges and
+ * taken in ascending order of sonar, are held as a single Sweep of the pose, the ranges as
+ * 16-bit integers, and a mask of the sonars read, all within one contiguous vector.
+ * The readings are reconstructed one at a time by a const_iterator, each with its distance
+ * being its sonar's range, as is the case for every reading produced by RmSonarMapper.
+ * Poses are held as given, without quantization, such that a map reoriented from its history
+ * is identical to one reoriented from the readings themselves.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmSonarHistory history;
+ * 2    history.push_back( reading );
+ * 3    for ( RmSonarHistory::const_iterator r = history.begin(); r != history.end(); ++r )
+ * 4        grid.update( *r );
+ * </pre>
+ */
+class RmSonarHistory
+{
+public:
+
+	/** The readings of a single sweep */
+	struct Sweep
+	{
+		/** The robot pose at which the sweep was taken, unscaled */
+		RmUtility::Pose robotPose;
+
+		/** The sonars read, bit <i>i</i> being set for sonar <i>i</i> */
+		unsigned short sonars;
+
+		/** The range reading of each sonar, in millimeters, whether or not read */
+		unsigned short ranges[NUM_SONARS];
+	};
+
+
+	/**
+	 * Iterates over the readings of a history in the order received, reconstructing each.
+	 * The reading referenced is invalidated by the iterator's advance.
+	 */
+	class const_iterator
+	{
+	public:
+
+		/** Constructs an iterator referencing no reading */
+		const_iterator() : m_sweep(NULL), m_end(NULL), m_sonar(0) {}
+
+		const RmUtility::SonarReading& operator*() const { return m_reading; }
+		const RmUtility::SonarReading* operator->() const { return &m_reading; }
+
+		/** Advances to the next reading */
+		const_iterator& operator++();
+
+		bool operator==( const const_iterator &i ) const {
+			return m_sweep == i.m_sweep && m_sonar == i.m_sonar; }
+		bool operator!=( const const_iterator &i ) const { return !(*this == i); }
+
+	private:
+
+		friend class RmSonarHistory;
+
+		/** Constructs an iterator referencing the first reading of the given sweep */
+		const_iterator( const Sweep *sweep, const Sweep *end );
+
+		/** Advances to the next sonar read within the sweep, if any, from the given sonar */
+		void seek( int sonar );
+
+		const Sweep *m_sweep; // the sweep of the reading referenced
+		const Sweep *m_end; // that beyond the last sweep
+		int m_sonar; // the sonar of the reading referenced, or NUM_SONARS at the end
+		RmUtility::SonarReading m_reading;
+	};
+
+
+	/**
+	 * Constructs an empty history.
+	 */
+	RmSonarHistory() : m_size(0) {}
+
+
+	/**
+	 * Appends the given reading to the history, as part of the last sweep should it share
+	 * that sweep's pose and ranges and follow each of its sonars.
+	 * Ranges are held within [0..65535] millimeters, beyond which they are clamped.
+	 */
+	void push_back( const RmUtility::SonarReading &reading );
+
+
+	/**
+	 * Returns an iterator referencing the first reading.
+	 */
+	const_iterator begin() const;
+
+
+	/**
+	 * Returns an iterator referencing the position beyond the last reading.
+	 */
+	const_iterator end() const;
+
+
+	/**
+	 * Returns the number of readings held.
+	 */
+	int size() const { return m_size; }
+
+
+	/**
+	 * Returns the number of sweeps over which the readings are held.
+	 */
+	int sweeps() const { return static_cast<int>(m_sweeps.size()); }
+
+
+	/**
+	 * Shifts every reading by the given shift, then rotates it by the shift's theta about
+	 * the given pivot, as done by RmLocalMap::reorientBy().
+	 */
+	void reorientBy( const RmUtility::Pose &shift, const RmUtility::Coord &pivot );
+
+
+	/**
+	 * Removes all readings, releasing the memory that held them.
+	 */
+	void release();
+
+
+	/**
+	 * Returns the number of bytes allocated to hold the readings.
+	 */
+	unsigned long allocatedBytes() const {
+		return static_cast<unsigned long>(m_sweeps.capacity() * sizeof(Sweep)); }
+
+
+	/**
+	 * Writes the number of readings followed by each, reconstructed, as written by
+	 * RmBinaryIO::write(), such that the format is that of a vector of readings.
+	 * @param os an output stream opened in binary mode
+	 */
+	void write( std::ostream &os ) const;
+
+
+	/**
+	 * Replaces the history with that written by write().
+	 * @param is an input stream opened in binary mode
+	 * @throws an RmExceptions::IOException if the stream is truncated or inconsistent
+	 */
+	void read( std::istream &is );
+
+private:
+
+	std::vector<Sweep> m_sweeps;
+	int m_size; // the number of readings held
+};
+
+#endif
@@ -0,0 +1,202 @@
+// RmSonarSimulator.h
+
+#ifndef RM_SONAR_SIMULATOR_H
+#define RM_SONAR_SIMULATOR_H
+
+#pragma warning( disable : 4786 )
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "RmExceptions.h"
+#include "RmUtility.h"
+
+
+/**
+ * Simulates a robot driven through a floor plan, producing the sonar sweeps it would record,
+ * such that sonar data of any length may be generated without a robot.
+ * <p>
+ * The floor plan is a set of walls, given as closed polygons or as a raster of occupied
+ * cells (see readFloorPlan()), in the frame of reference of the robot's odometry as recorded
+ * by Aria: millimeters, with the heading in degrees counterclockwise from the x-axis.
+ * Each sonar is placed and aimed as by RmPioneerController, from RmPioneerController::DistToSonar,
+ * RmPioneerController::ThetaToSonar, and RmPioneerController::SonarTheta, and returns the
+ * distance to the nearest wall along its axis, or MaxRange if none is that near.
+ * <p>
+ * The robot is driven by forward() and turn(), which move its true pose, from which its
+ * sonars range, and its odometry pose, which accumulates the errors specified by
+ * setOdometryError() and is the pose recorded by each sweep.
+ * Ranges are perturbed as specified by setSonarNoise().
+ * All randomness is drawn from a generator of the simulator's own, such that a simulation
+ * repeated with the same seed produces the same sweeps on any platform.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmSonarSimulator sim;
+ * 2    sim.readFloorPlan( planStream );
+ * 3    sim.setPose( -2500, -1500, 0 );
+ * 4    sim.forward( 20 );
+ * 5    sim.writeSweep( sonarStream );
+ * </pre>
+ */
+class RmSonarSimulator
+{
+public:
+
+	/** The range returned by a sonar that senses no wall, as by Aria */
+	static const int MaxRange;
+
+
+	/**
+	 * Initializes a simulator with no walls, the robot at the origin facing along the x-axis,
+	 * and neither odometry error nor sonar noise.
+	 * @param seed the seed of the random number generator
+	 */
+	RmSonarSimulator( unsigned long seed = 1 );
+
+
+	/**
+	 * Adds a wall along each edge of the given polygon, the last vertex joining the first.
+	 */
+	void addPolygon( const std::vector<RmUtility::Coord> &vertices );
+
+
+	/**
+	 * Adds walls around the occupied cells of the given raster, being those marked '#',
+	 * wherever they border a free cell or the edge of the raster.
+	 * The raster is centered on the origin, its first row the northernmost (greatest y).
+	 * @param rows the rows of the raster, each of the same width
+	 * @param cellSize the width of each cell, in millimeters
+	 * @throws an RmExceptions::InvalidParameterException if the rows differ in width or
+	 * the cell size is not positive
+	 */
+	void addRaster( const std::vector<std::string> &rows, int cellSize );
+
+
+	/**
+	 * Adds the walls described by the given floor plan, in which any line beginning with '%'
+	 * is a comment.  The plan consists of any number of sections, each beginning with a line
+	 * naming its kind:
+	 * <ul>
+	 * <li><code>polygon</code>, followed by the vertices of a polygon, one <code>x y</code>
+	 *     pair per line, until a blank line or the end of the plan
+	 * <li><code>raster cellSize</code>, followed by the rows of a raster, as per addRaster(),
+	 *     until a blank line or the end of the plan
+	 * </ul>
+	 * @throws an RmExceptions::IOException if the plan is malformed
+	 */
+	void readFloorPlan( std::istream &is );
+
+
+	/**
+	 * Returns the number of walls.
+	 */
+	int walls() const { return static_cast<int>(m_walls.size()); }
+
+
+	/**
+	 * Specifies the errors accumulated by the odometry pose with each motion.
+	 * The odometry records each distance driven scaled by (1 + distanceScale), and each turn
+	 * scaled by (1 + turnScale), to which are added normally distributed errors of the
+	 * given deviations, and a heading drift proportional to the distance driven.
+	 * @param distanceScale the systematic error of each distance, as a fraction
+	 * @param turnScale the systematic error of each turn, as a fraction
+	 * @param drift the heading drift, in degrees per meter driven
+	 * @param distanceSigma the deviation of the random error of each step, in millimeters
+	 * @param turnSigma the deviation of the random error of each step, in degrees
+	 */
+	void setOdometryError( double distanceScale, double turnScale, double drift,
+		double distanceSigma, double turnSigma );
+
+
+	/**
+	 * Specifies the perturbation of each range.
+	 * @param sigma the deviation of the normally distributed error added to each range,
+	 * in millimeters
+	 * @param dropout the probability that a sonar senses no wall, returning MaxRange
+	 * @param beamWidth if not zero, the width in degrees of the cone across which each sonar
+	 * casts five rays, returning the nearest range of any; otherwise a single ray is cast
+	 * along the sonar's axis
+	 */
+	void setSonarNoise( double sigma, double dropout, double beamWidth = 0.0 );
+
+
+	/**
+	 * Places the robot at the given pose, to which the odometry pose is also reset.
+	 * @param x the x-coordinate, in millimeters
+	 * @param y the y-coordinate, in millimeters
+	 * @param th the heading, in degrees counterclockwise from the x-axis
+	 */
+	void setPose( double x, double y, double th );
+
+
+	/**
+	 * Drives the robot straight ahead by the given distance, which may be negative.
+	 */
+	void forward( double distance );
+
+
+	/**
+	 * Turns the robot in place by the given angle, counterclockwise if positive.
+	 */
+	void turn( double theta );
+
+
+	/**
+	 * Returns the range that the given sonar returns from the robot's true pose,
+	 * including any noise.
+	 */
+	int range( int sonar );
+
+
+	/**
+	 * Returns a sweep of all sonars at the robot's true pose, recording the odometry pose,
+	 * as would be parsed from a line of sonar data (see RmUtility::SonarReading).
+	 */
+	RmUtility::SonarReading sweep();
+
+
+	/**
+	 * Writes a sweep, as per sweep(), to the given stream in the format of a sonar data file,
+	 * as written by RmSonarMapper.
+	 */
+	void writeSweep( std::ostream &os );
+
+private:
+
+	/** A wall from one point to another */
+	struct Wall
+	{
+		double x1, y1, x2, y2;
+		Wall( double x1_, double y1_, double x2_, double y2_ )
+			: x1(x1_), y1(y1_), x2(x2_), y2(y2_) {}
+	};
+
+	/**
+	 * Returns the distance from the given point to the nearest wall along the given heading,
+	 * or MaxRange if none is that near.
+	 */
+	double castRay( double x, double y, double th ) const;
+
+	/** Returns a uniformly distributed random number in [0, 1) */
+	double uniform();
+
+	/** Returns a normally distributed random number of mean 0 and deviation 1 */
+	double gaussian();
+
+	std::vector<Wall> m_walls;
+
+	/** The true pose of the robot, and that recorded by its odometry */
+	double m_x, m_y, m_th;
+	double m_odoX, m_odoY, m_odoTh;
+
+	/** Odometry error; see setOdometryError() */
+	double m_distanceScale, m_turnScale, m_drift, m_distanceSigma, m_turnSigma;
+
+	/** Sonar noise; see setSonarNoise() */
+	double m_rangeSigma, m_dropout, m_beamWidth;
+
+	/** The state of the random number generator */
+	unsigned long m_random;
+};
+
+#endif
@@ -0,0 +1,120 @@
+// RmTrace.h
+
+#ifndef RM_TRACE_H
+#define RM_TRACE_H
+
+#include <iostream>
+
+
+/**
+ * Records the timeline of a mapping session as begin and end events of its stages, such as
+ * the installation of each local map and each localization, for export as a trace to be viewed
+ * in Chrome's <code>about:tracing</code> or in Perfetto.
+ * <p>
+ * Events are held in a ring buffer of a fixed number of events, allocated by start(), such that
+ * a session of any length may be traced in bounded memory, the oldest events being overwritten
+ * once the buffer is full.
+ * Until start() is called, and after stop(), nothing is recorded, and each event costs no more
+ * than the test of a flag.
+ * The recorder is shared by every thread and map of the process, each thread being shown
+ * separately in the order in which it first records an event.
+ * <h3>Usage</h3>
+ * <pre>
+ * 1    RmTrace::start();
+ * 2    {
+ * 3        RmTrace::Scope scope( "installNewMap" );
+ * 4        ...
+ * 5    }
+ * 6    RmTrace::write( "session.json" );
+ * </pre>
+ */
+namespace RmTrace {
+
+/** The number of events held by default */
+static const int DefaultCapacity = 32768;
+
+/** The greatest length of the arguments of an event, beyond which they are truncated */
+static const int MaxArgs = 160;
+
+
+/**
+ * Begins recording, discarding any events previously recorded.
+ * @param capacity the number of most recent events held
+ */
+void start( int capacity = DefaultCapacity );
+
+
+/**
+ * Ends recording, retaining the events recorded for write().
+ */
+void stop();
+
+
+/**
+ * Returns true if events are being recorded.
+ */
+bool recording();
+
+
+/**
+ * Records the beginning of the given stage on the calling thread.
+ * @param name the name of the stage, which must remain valid until the events are written,
+ * as must a string literal
+ * @param args if not null, the arguments shown with the event, as the members of a JSON object,
+ * such as <code>"robot":0</code>
+ */
+void begin( const char *name, const char *args = NULL );
+
+
+/**
+ * Records the end of the stage most recently begun on the calling thread.
+ */
+void end( const char *name, const char *args = NULL );
+
+
+/**
+ * Records an event of no duration, such as the outcome of a stage.
+ */
+void instant( const char *name, const char *args = NULL );
+
+
+/**
+ * Writes the events held, oldest first, as a trace in the Chrome trace event format.
+ * Should the beginning of a stage have been overwritten, its end is omitted.
+ */
+void write( std::ostream &os );
+
+
+/**
+ * Writes the events held to the given file.
+ * @throws an RmExceptions::IOException if the file cannot be written
+ */
+void write( const char *filename );
+
+
+/**
+ * Records the beginning of the given stage upon construction, and its end upon destruction,
+ * if recording.
+ */
+class Scope
+{
+public:
+
+	Scope( const char *name, const char *args = NULL ) : m_name( name )
+	{
+		if ( recording() ) begin( name, args );
+	}
+
+	~Scope() { if ( recording() ) end( m_name ); }
+
+private:
+
+	Scope( const Scope& ); // not copyable
+	Scope& operator=( const Scope& );
+
+	const char *m_name;
+};
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+// RmViewerStream.h
+
+#ifndef RM_VIEWER_STREAM_H
+#define RM_VIEWER_STREAM_H
+
+#pragma warning( disable : 4786 )
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include "Aria.h"
+#include "RmServer.h"
+
+
+/**
+ * Streams map updates to the remote map viewer as compact binary datagrams, an alternative
+ * to serving each update string produced by RmSonarMap::update() as a datagram of its own.
+ * Updates are coalesced over a configurable window of time, a later update of a cell replacing
+ * any earlier one still pending, and the cells pending at the close of the window are then
+ * packed into as few datagrams as will carry them, none exceeding the configured payload.
+ * <h3>Protocol</h3>
+ * Each datagram consists of a HeaderSize-byte header followed by CellBytes bytes per cell,
+ * all values big-endian:
+ * <pre>
+ * Offset  Size  Content
+ *  0       2    "RV"
+ *  2       1    Version
+ *  3       1    flags; bit 0 is set on the last datagram of a window
+ *  4       4    sequence number, incremented with each datagram sent
+ *  8       2    robot x, in cells       \
+ * 10       2    robot y, in cells        | the pose and range reading
+ * 12       2    robot heading, degrees   | of the most recent update
+ * 14       1    sonar number             | of the window
+ * 15       1    reserved                 |
+ * 16       2    range reading           /
+ * 18       2    number of cells n
+ * 20      5n    for each cell: x (2), y (2), probability quantized by RmUtility::quantize() (1)
+ * </pre>
+ * Because the header carries the pose and range, each datagram is self-contained and
+ * may be converted by the viewer to the text form of an update string; the sequence number
+ * allows it to discard those that arrive out of order and to report those that are lost.
+ * The viewer's own control strings ("Welcome", "reset", "quit") are unaffected.
+ */
+class RmViewerStream
+{
+public:
+
+	/** The payload of each datagram used unless otherwise specified, in bytes, which together
+		with the IP and UDP headers fits within a 1500-byte Ethernet MTU */
+	static const int DefaultPayload;
+
+	/** The size of the header of each datagram, in bytes */
+	static const int HeaderSize;
+
+	/** The size of each cell within a datagram, in bytes */
+	static const int CellBytes;
+
+	/** The version of the protocol */
+	static const unsigned char Version;
+
+
+	/**
+	 * Initializes a stream with no pending updates.
+	 * @param server the server to whose client datagrams are sent; may be NULL, in which case
+	 * updates are coalesced but never sent
+	 * @param window the time over which updates are coalesced, in milliseconds; if zero,
+	 * each update is sent as soon as it is added
+	 * @param payload the maximum size of each datagram, in bytes, at least large enough for the
+	 * header and one cell
+	 */
+	RmViewerStream( RmServer *server = NULL, int window = 0, int payload = DefaultPayload );
+
+
+	/**
+	 * Adds the pose, range reading, and cells of the given update string, as produced by
+	 * RmSonarMap::update(), to those pending, then sends them if the window has elapsed.
+	 * Probabilities are accepted either as decimals or as quantized values
+	 * (see RmUtility::cellString()).
+	 * Strings that do not begin with a valid pose line are ignored.
+	 * @throw an RmExceptions::SocketException if unable to reach the client
+	 */
+	void add( const std::string &update );
+
+
+	/**
+	 * Sends the pending updates if the window has elapsed since the first of them was added.
+	 * This should be called periodically so that the last updates of a burst are not held
+	 * indefinitely.
+	 * @throw an RmExceptions::SocketException if unable to reach the client
+	 */
+	void flushIfDue();
+
+
+	/**
+	 * Sends the pending updates, if any, regardless of the window.
+	 * @throw an RmExceptions::SocketException if unable to reach the client
+	 */
+	void flush();
+
+
+	/**
+	 * Packs the pending updates into datagrams, without sending them, and clears them.
+	 * @param datagrams receives one string of binary data per datagram
+	 */
+	void pack( std::vector<std::string> &datagrams );
+
+
+	/**
+	 * Assigns the server to whose client datagrams are sent.
+	 */
+	void setServer( RmServer *server ) { m_server = server; }
+
+
+	/**
+	 * Returns the sequence number of the next datagram to be sent.
+	 */
+	unsigned long sequence() const { return m_sequence; }
+
+private:
+
+	/** Identifies a cell by its x-y coordinate */
+	typedef std::pair<int,int> CellKey;
+
+	RmServer *m_server;
+	int m_window;
+	int m_payload;
+	unsigned long m_sequence;
+
+	bool m_pending; // whether an update has been added since the last flush
+	ArTime m_windowStart; // time at which the first pending update was added
+	int m_pose[5]; // x, y, heading, sonar number, and range of the most recent update
+	std::map<CellKey,unsigned char> m_cells; // the pending cells and their latest values
+};
+
+#endif
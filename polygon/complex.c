@@ -46,32 +46,38 @@ struct EdgeState {
    int Count;
 };
 
-extern void InitDraw();
-extern struct PointList* pointListTop;
-extern void DrawHorizontalLineSeg(int, int, int, int);
-extern struct PointList* FillConvexPolygon(struct PointListHeader *, int, int, int);
-static void BuildGET(struct PointListHeader *, struct EdgeState *,
-   int, int);
-static void MoveXSortedToAET(int);
-static void ScanOutAET(int, int);
-static void AdvanceAET(void);
-static void XSortAET(void);
+/* Pointers to global edge table (GET) and active edge table (AET);
+   ko: held by each fill rather than globally, that fills may run concurrently */
+struct EdgeTables {
+   struct EdgeState *GETPtr;
+   struct EdgeState *AETPtr;
+};
 
-/* Pointers to global edge table (GET) and active edge table (AET) */
-static struct EdgeState *GETPtr, *AETPtr;
+extern void InitDraw(struct DrawContext *);
+extern void DrawHorizontalLineSeg(struct DrawContext *, int, int, int, int);
+extern struct PointList* FillConvexPolygon(struct DrawContext *, struct PointListHeader *, int, int, int);
+static void BuildGET(struct EdgeTables *, struct PointListHeader *, struct EdgeState *,
+   int, int);
+static void MoveXSortedToAET(struct EdgeTables *, int);
+static void ScanOutAET(struct DrawContext *, struct EdgeTables *, int, int);
+static void AdvanceAET(struct EdgeTables *);
+static void XSortAET(struct EdgeTables *);
 
-struct PointList* FillPolygon(struct PointListHeader * VertexList, int Color,
+/* ko: The points are drawn into the given context (see DrawContext) */
+struct PointList* FillPolygon(struct DrawContext * Context,
+      struct PointListHeader * VertexList, int Color,
       int PolygonShape, int XOffset, int YOffset)
 {
    struct EdgeState *EdgeTableBuffer;
+   struct EdgeTables Tables;
    int CurrentY;
 
-   InitDraw(); // inits point list that will be "drawn" (added) to the list
+   InitDraw(Context); // inits point list that will be "drawn" (added) to the list
 
 #ifdef CONVEX_CODE_LINKED
    /* Pass convex polygons through to fast convex polygon filler */
    if (PolygonShape == CONVEX)
-      return(FillConvexPolygon(VertexList, Color, XOffset, YOffset));
+      return(FillConvexPolygon(Context, VertexList, Color, XOffset, YOffset));
 #endif
 
    /* It takes a minimum of 3 vertices to cause any pixels to be
@@ -84,21 +90,26 @@ struct PointList* FillPolygon(struct PointListHeader * VertexList, int Color,
          VertexList->Length))) == NULL)
       return(0);  /* couldn't get memory for the edge table */
    /* Build the global edge table */
-   BuildGET(VertexList, EdgeTableBuffer, XOffset, YOffset);
+   BuildGET(&Tables, VertexList, EdgeTableBuffer, XOffset, YOffset);
+   /* ko: reject polygons of 0 height, every edge of which was skipped */
+   if (Tables.GETPtr == NULL) {
+      free(EdgeTableBuffer);
+      return(0);
+   }
    /* Scan down through the polygon edges, one scan line at a time,
       so long as at least one edge remains in either the GET or AET */
-   AETPtr = NULL;    /* initialize the active edge table to empty */
-   CurrentY = GETPtr->StartY; /* start at the top polygon vertex */
-   while ((GETPtr != NULL) || (AETPtr != NULL)) {
-      MoveXSortedToAET(CurrentY);  /* update AET for this scan line */
-      ScanOutAET(CurrentY, Color); /* draw this scan line from AET */
-      AdvanceAET();                /* advance AET edges 1 scan line */
-      XSortAET();                  /* resort on X */
+   Tables.AETPtr = NULL;    /* initialize the active edge table to empty */
+   CurrentY = Tables.GETPtr->StartY; /* start at the top polygon vertex */
+   while ((Tables.GETPtr != NULL) || (Tables.AETPtr != NULL)) {
+      MoveXSortedToAET(&Tables, CurrentY);  /* update AET for this scan line */
+      ScanOutAET(Context, &Tables, CurrentY, Color); /* draw this scan line from AET */
+      AdvanceAET(&Tables);                /* advance AET edges 1 scan line */
+      XSortAET(&Tables);                  /* resort on X */
       CurrentY++;                  /* advance to the next scan line */
    }
    /* Release the memory we've allocated and we're done */
    free(EdgeTableBuffer);
-   return(pointListTop);
+   return(Context->pointListTop);
 }
 
 /* Creates a GET in the buffer pointed to by NextFreeEdgeStruc from
@@ -106,7 +117,7 @@ struct PointList* FillPolygon(struct PointListHeader * VertexList, int Color,
    guarantee all edges go top to bottom. The GET is sorted primarily
    by ascending Y start coordinate, and secondarily by ascending X
    start coordinate within edges with common Y coordinates */
-static void BuildGET(struct PointListHeader * VertexList,
+static void BuildGET(struct EdgeTables * Tables, struct PointListHeader * VertexList,
       struct EdgeState * NextFreeEdgeStruc, int XOffset, int YOffset)
 {
    int i, StartX, StartY, EndX, EndY, DeltaY, DeltaX, Width, temp;
@@ -117,7 +128,7 @@ static void BuildGET(struct PointListHeader * VertexList,
    /* Scan through the vertex list and put all non-0-height edges into
       the GET, sorted by increasing Y start coordinate */
    VertexPtr = VertexList->PointPtr;   /* point to the vertex list */
-   GETPtr = NULL;    /* initialize the global edge table to empty */
+   Tables->GETPtr = NULL;    /* initialize the global edge table to empty */
    for (i = 0; i < VertexList->Length; i++) {
       /* Calculate the edge height and width */
       StartX = VertexPtr[i].X + XOffset;
@@ -163,7 +174,7 @@ static void BuildGET(struct PointListHeader * VertexList,
          /* Link the new edge into the GET so that the edge list is
             still sorted by Y coordinate, and by X coordinate for all
             edges with the same Y coordinate */
-         FollowingEdgeLink = &GETPtr;
+         FollowingEdgeLink = &Tables->GETPtr;
          for (;;) {
             FollowingEdge = *FollowingEdgeLink;
             if ((FollowingEdge == NULL) ||
@@ -182,17 +193,17 @@ static void BuildGET(struct PointListHeader * VertexList,
 
 /* Sorts all edges currently in the active edge table into ascending
    order of current X coordinates */
-static void XSortAET() {
+static void XSortAET(struct EdgeTables * Tables) {
    struct EdgeState *CurrentEdge, **CurrentEdgePtr, *TempEdge;
    int SwapOccurred;
 
    /* Scan through the AET and swap any adjacent edges for which the
       second edge is at a lower current X coord than the first edge.
       Repeat until no further swapping is needed */
-   if (AETPtr != NULL) {
+   if (Tables->AETPtr != NULL) {
       do {
          SwapOccurred = 0;
-         CurrentEdgePtr = &AETPtr;
+         CurrentEdgePtr = &Tables->AETPtr;
          while ((CurrentEdge = *CurrentEdgePtr)->NextEdge != NULL) {
             if (CurrentEdge->X > CurrentEdge->NextEdge->X) {
                /* The second edge has a lower X than the first;
@@ -211,11 +222,11 @@ static void XSortAET() {
 
 /* Advances each edge in the AET by one scan line.
    Removes edges that have been fully scanned. */
-static void AdvanceAET() {
+static void AdvanceAET(struct EdgeTables * Tables) {
    struct EdgeState *CurrentEdge, **CurrentEdgePtr;
 
    /* Count down and remove or advance each edge in the AET */
-   CurrentEdgePtr = &AETPtr;
+   CurrentEdgePtr = &Tables->AETPtr;
    while ((CurrentEdge = *CurrentEdgePtr) != NULL) {
       /* Count off one scan line for this edge */
       if ((--(CurrentEdge->Count)) == 0) {
@@ -237,7 +248,7 @@ static void AdvanceAET() {
 
 /* Moves all edges that start at the specified Y coordinate from the
    GET to the AET, maintaining the X sorting of the AET. */
-static void MoveXSortedToAET(int YToMove) {
+static void MoveXSortedToAET(struct EdgeTables * Tables, int YToMove) {
    struct EdgeState *AETEdge, **AETEdgePtr, *TempEdge;
    int CurrentX;
 
@@ -247,19 +258,19 @@ static void MoveXSortedToAET(int YToMove) {
       at the desired Y coordinate. Also, the GET is X sorted within
       each Y coordinate, so each successive edge we add to the AET is
       guaranteed to belong later in the AET than the one just added */
-   AETEdgePtr = &AETPtr;
-   while ((GETPtr != NULL) && (GETPtr->StartY == YToMove)) {
-      CurrentX = GETPtr->X;
+   AETEdgePtr = &Tables->AETPtr;
+   while ((Tables->GETPtr != NULL) && (Tables->GETPtr->StartY == YToMove)) {
+      CurrentX = Tables->GETPtr->X;
       /* Link the new edge into the AET so that the AET is still
          sorted by X coordinate */
       for (;;) {
          AETEdge = *AETEdgePtr;
          if ((AETEdge == NULL) || (AETEdge->X >= CurrentX)) {
-            TempEdge = GETPtr->NextEdge;
-            *AETEdgePtr = GETPtr;  /* link the edge into the AET */
-            GETPtr->NextEdge = AETEdge;
-            AETEdgePtr = &GETPtr->NextEdge;
-            GETPtr = TempEdge;   /* unlink the edge from the GET */
+            TempEdge = Tables->GETPtr->NextEdge;
+            *AETEdgePtr = Tables->GETPtr;  /* link the edge into the AET */
+            Tables->GETPtr->NextEdge = AETEdge;
+            AETEdgePtr = &Tables->GETPtr->NextEdge;
+            Tables->GETPtr = TempEdge;   /* unlink the edge from the GET */
             break;
          } else {
             AETEdgePtr = &AETEdge->NextEdge;
@@ -270,7 +281,8 @@ static void MoveXSortedToAET(int YToMove) {
 
 /* Fills the scan line described by the current AET at the specified Y
    coordinate in the specified color, using the odd/even fill rule */
-static void ScanOutAET(int YToScan, int Color) {
+static void ScanOutAET(struct DrawContext * Context, struct EdgeTables * Tables,
+      int YToScan, int Color) {
    int LeftX;
    struct EdgeState *CurrentEdge;
 
@@ -278,11 +290,11 @@ static void ScanOutAET(int YToScan, int Color) {
       crossings is encountered. The nearest pixel on or to the right
       of left edges is drawn, and the nearest pixel to the left of but
       not on right edges is drawn */
-   CurrentEdge = AETPtr;
+   CurrentEdge = Tables->AETPtr;
    while (CurrentEdge != NULL) {
       LeftX = CurrentEdge->X;
       CurrentEdge = CurrentEdge->NextEdge;
-      DrawHorizontalLineSeg(YToScan, LeftX, CurrentEdge->X-1, Color);
+      DrawHorizontalLineSeg(Context, YToScan, LeftX, CurrentEdge->X-1, Color);
 //      DrawHorizontalLineSeg(YToScan, LeftX, CurrentEdge->X, Color);
       CurrentEdge = CurrentEdge->NextEdge;
    }
@@ -40,11 +40,11 @@
    else                                                              \
       Index = (Index - 1 + VertexList->Length) % VertexList->Length;
 
-extern struct PointList* pointListTop;
-extern void DrawHorizontalLineList(struct HLineList *, int);
+extern void DrawHorizontalLineList(struct DrawContext *, struct HLineList *, int);
 static void ScanEdge(int, int, int, int, int, int, struct HLine **);
 
-struct PointList* FillConvexPolygon(struct PointListHeader * VertexList, int Color,
+struct PointList* FillConvexPolygon(struct DrawContext * Context,
+      struct PointListHeader * VertexList, int Color,
       int XOffset, int YOffset)
 {
    int i, MinIndexL, MaxIndex, MinIndexR, SkipFirst, Temp;
@@ -170,11 +170,11 @@ struct PointList* FillConvexPolygon(struct PointListHeader * VertexList, int Col
    } while (CurrentIndex != MaxIndex);
 
    /* Draw the line list representing the scan converted polygon */
-   DrawHorizontalLineList(&WorkingHLineList, Color);
+   DrawHorizontalLineList(Context, &WorkingHLineList, Color);
 
    /* Release the line list's memory and we're successfully done */
    free(WorkingHLineList.HLinePtr);
-   return(pointListTop);
+   return(Context->pointListTop);
 }
 
 /* Scan converts an edge from (X1,Y1) to (X2,Y2), not including the
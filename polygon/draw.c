@@ -18,44 +18,48 @@
 //#define SCREEN_WIDTH    320
 //#define SCREEN_SEGMENT  0xA000
 
-struct PointList* pointList = 0;
-struct PointList* pointListTop = 0;
+void DrawPixel(struct DrawContext *, int, int, int);
 
-void DrawPixel(int, int, int);
-
-void InitDraw() 
+/* ko: Frees the points drawn into the given context, leaving it empty */
+void FreeDraw(struct DrawContext * Context)
 {
-	if ( pointListTop == 0 ) return;
-	pointList = pointListTop;
+	struct PointList* pointList = Context->pointListTop;
 	while ( pointList )
 	{
 		struct PointList* nextPointList = pointList->next;
 		free( pointList );
 		pointList = nextPointList;
 	}
-	pointList = pointListTop = 0;
+	Context->pointList = Context->pointListTop = 0;
+}
+
+void InitDraw(struct DrawContext * Context) 
+{
+	FreeDraw( Context );
 }
 
-void DrawHorizontalLineSeg(int Y, int LeftX, int RightX, int Color) {
+void DrawHorizontalLineSeg(struct DrawContext * Context, int Y, int LeftX, int RightX, int Color) {
    int X;
 
    /* Draw each pixel in the horizontal line segment, starting with
       the leftmost one */
    for (X = LeftX; X <= RightX; X++)
-      DrawPixel(X, Y, Color);
+      DrawPixel(Context, X, Y, Color);
 }
 
 /* Draws the pixel at (X, Y) in color Color in VGA mode 13h */
-void DrawPixel(int X, int Y, int Color) 
+void DrawPixel(struct DrawContext * Context, int X, int Y, int Color) 
 {
 /*	static int lastY = -1;
 	if ( lastY != Y ) printf( "\n" );
 	lastY = Y;
 	printf( "(%d,%d) ", X, Y );
 */
-	if ( pointListTop == 0 )
+	if ( Context->pointListTop == 0 )
 	{
-		if ( (pointList = pointListTop = (struct PointList*)(malloc( sizeof( struct PointList ) ))) == NULL )
+		struct PointList* pointList;
+		if ( (pointList = Context->pointList = Context->pointListTop = 
+				(struct PointList*)(malloc( sizeof( struct PointList ) ))) == NULL )
 			exit(0);
 		pointList->next = 0;
 		pointList->point.X = X;
@@ -69,7 +73,7 @@ void DrawPixel(int X, int Y, int Color)
 		nextPointList->next = 0;
 		nextPointList->point.X = X;
 		nextPointList->point.Y = Y;
-		pointList = pointList->next = nextPointList;
+		Context->pointList = Context->pointList->next = nextPointList;
 	}
 }
 
@@ -81,7 +85,7 @@ void DrawPixel(int X, int Y, int Color)
    by Michael Abrash
 */
 
-void DrawHorizontalLineList(struct HLineList * HLineListPtr,
+void DrawHorizontalLineList(struct DrawContext * Context, struct HLineList * HLineListPtr,
       int Color)
 {
    struct HLine *HLinePtr;
@@ -97,6 +101,6 @@ void DrawHorizontalLineList(struct HLineList * HLineListPtr,
       /* Draw each pixel in the current horizontal line in turn,
          starting with the leftmost one */
       for (X = HLinePtr->XStart; X <= HLinePtr->XEnd; X++)
-         DrawPixel(X, Y, Color);
+         DrawPixel(Context, X, Y, Color);
    }
 }
@@ -46,10 +46,28 @@ struct PointList {
 	struct Point point;
 };
 
+/* ko: Receives the points "drawn" by a fill, each fill of which begins a new list, so that
+   fills drawn into separate contexts, as by separate threads, do not interfere; the points
+   remain valid until the next fill into the same context, or until it is freed by FreeDraw() */
+struct DrawContext {
+	struct PointList* pointList;     /* last point drawn */
+	struct PointList* pointListTop;  /* first point drawn */
+};
+
 #ifdef _CPP_EXTERN // ko: for use by external cpp source
 
-extern "C" struct PointList* FillPolygon(struct PointListHeader *, int, int, int, int);
-extern "C" struct PointList* FillLine(int, int, int, int);
+extern "C" struct PointList* FillPolygon(struct DrawContext *, struct PointListHeader *, int, int, int, int);
+extern "C" struct PointList* FillLine(struct DrawContext *, int, int, int, int);
 extern "C" int LineLength( struct PointList* linePointList );
+extern "C" void FreeDraw(struct DrawContext *);
+
+/* ko: A draw context whose points are freed once it goes out of scope */
+struct ScopedDrawContext : public DrawContext {
+	ScopedDrawContext() { pointList = pointListTop = 0; }
+	~ScopedDrawContext() { FreeDraw( this ); }
+private:
+	ScopedDrawContext( const ScopedDrawContext& ); // not copyable
+	ScopedDrawContext& operator=( const ScopedDrawContext& );
+};
 
 #endif
@@ -0,0 +1,234 @@
+// RmBroadcastServer.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include "RmBroadcastServer.h"
+#include "RmExceptions.h"
+#include "RmInstrument.h"
+
+
+const int RmBroadcastServer::DefaultMaxQueue = 256;
+const int RmBroadcastServer::Burst = 8;
+
+
+RmBroadcastServer::RmBroadcastServer( const short portNumber, const std::string name,
+	int maxQueue, DropPolicy policy )
+: RmServer( portNumber, name ), m_maxQueue( maxQueue ), m_policy( policy ), m_clientRate( 0 ),
+  m_idleTimeout( 0 )
+{
+	RmSocket::setNonBlocking( m_socket );
+}
+
+
+RmBroadcastServer::~RmBroadcastServer()
+{
+	unsubscribeAll();
+}
+
+
+std::string RmBroadcastServer::addressOf( const Subscriber &s )
+{
+	char buff[32];
+	sprintf( buff, "%s:%d", inet_ntoa( s.address.sin_addr ), ntohs( s.address.sin_port ) );
+	return buff;
+}
+
+
+void RmBroadcastServer::drop( int index, const char *reason )
+{
+	std::cout << m_name << " dropped " << addressOf( *m_subscribers[index] ) << " (" << reason << ")\n";
+	delete m_subscribers[index];
+	m_subscribers.erase( m_subscribers.begin() + index );
+}
+
+
+int RmBroadcastServer::find( const sockaddr_in &address ) const
+{
+	for ( unsigned int i = 0; i < m_subscribers.size(); ++i ) {
+		const sockaddr_in &a = m_subscribers[i]->address;
+		if ( a.sin_addr.s_addr == address.sin_addr.s_addr && a.sin_port == address.sin_port ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+int RmBroadcastServer::flush()
+{
+	m_mutex.lock();
+
+	int i;
+	if ( m_idleTimeout > 0 ) {
+		for ( i = m_subscribers.size() - 1; i >= 0; --i ) {
+			if ( m_subscribers[i]->lastHeard.mSecSince() > m_idleTimeout ) drop( i, "idle" );
+		}
+	}
+
+	// Accrue each rate-limited subscriber's allowance, up to one second's worth
+	for ( i = 0; i < static_cast<int>(m_subscribers.size()); ++i )
+	{
+		Subscriber &s = *m_subscribers[i];
+		if ( s.rate <= 0 ) continue;
+		const long elapsed = s.refilled.mSecSince();
+		s.refilled.addMSec( elapsed );
+		s.allowance += s.rate * (elapsed / 1000.0);
+		if ( s.allowance > s.rate ) s.allowance = s.rate;
+	}
+
+	// Subscribers take turns sending up to Burst messages until all are sent, the socket would
+	// block, or none may send more within its rate
+	bool blocked = false;
+	bool sending = true;
+	while ( sending && !blocked )
+	{
+		sending = false;
+		for ( i = 0; i < static_cast<int>(m_subscribers.size()) && !blocked; ++i )
+		{
+			Subscriber &s = *m_subscribers[i];
+			for ( int n = 0; n < Burst && !s.queue.empty(); ++n )
+			{
+				const std::string &m = s.queue.front();
+
+				// A message larger than a full allowance is sent once the allowance is full
+				if ( s.rate > 0 && s.allowance < m.length() && s.allowance < s.rate ) break;
+
+				const int nRet = sendto( m_socket, m.data(), m.length(), 0,
+					(sockaddr*)&s.address, sizeof(s.address) );
+				if ( nRet < 0 ) {
+					if ( RmSocket::wouldBlock() ) blocked = true;
+					else drop( i--, "unreachable" );
+					break;
+				}
+
+				RM_INSTRUMENT_COUNT( RmInstrument::BytesSent, nRet );
+				if ( s.rate > 0 ) s.allowance -= m.length();
+				s.queue.pop_front();
+				++s.sent;
+				sending = true;
+			}
+		}
+	}
+
+	int queued = 0;
+	for ( i = 0; i < static_cast<int>(m_subscribers.size()); ++i ) {
+		queued += m_subscribers[i]->queue.size();
+		if ( m_subscribers[i]->queue.empty() ) m_subscribers[i]->slow = false;
+	}
+
+	m_mutex.unlock();
+	return queued;
+}
+
+
+bool RmBroadcastServer::pollClientString( std::string &s, int timeout )
+{
+	if ( !RmServer::pollClientString( s, timeout ) ) {
+		flush();
+		return false;
+	}
+
+	m_mutex.lock();
+	int i = find( m_clientAddress );
+	if ( i < 0 && s.length() > 0 && s != "quit" )
+	{
+		Subscriber *sub = new Subscriber;
+		sub->address = m_clientAddress;
+		sub->rate = m_clientRate;
+		sub->allowance = m_clientRate;
+		sub->sent = sub->dropped = 0;
+		sub->slow = false;
+		m_subscribers.push_back( sub );
+		i = m_subscribers.size() - 1;
+		std::cout << m_name << " subscribed " << addressOf( *sub ) << "\n";
+
+		// Welcome the sender alone; it is the last client heard from
+		try {
+			RmServer::sendClientData( "Welcome", 7 );
+		}
+		catch ( RmExceptions::SocketException ) {
+			// Delivered with the next flush, if at all; the subscription stands
+		}
+	}
+	else if ( i >= 0 && s == "quit" ) {
+		drop( i, "quit" );
+		i = -1;
+	}
+	else if ( i >= 0 && s.compare( 0, 5, "rate " ) == 0 ) {
+		m_subscribers[i]->rate = atoi( s.c_str() + 5 );
+		m_subscribers[i]->allowance = m_subscribers[i]->rate;
+		m_subscribers[i]->refilled.setToNow();
+	}
+	if ( i >= 0 ) m_subscribers[i]->lastHeard.setToNow();
+	m_mutex.unlock();
+
+	flush();
+	return true;
+}
+
+
+void RmBroadcastServer::sendClientData( const char *data, int length )
+{
+	m_mutex.lock();
+	for ( int i = m_subscribers.size() - 1; i >= 0; --i )
+	{
+		Subscriber &s = *m_subscribers[i];
+		s.queue.push_back( std::string( data, length ) );
+		if ( static_cast<int>(s.queue.size()) <= m_maxQueue ) continue;
+
+		if ( !s.slow ) {
+			s.slow = true;
+			std::cout << m_name << " client " << addressOf( s ) << " is slow\n";
+		}
+		if ( m_policy == DropClient ) {
+			drop( i, "slow" );
+		}
+		else {
+			s.queue.pop_front();
+			++s.dropped;
+		}
+	}
+	m_mutex.unlock();
+
+	flush();
+}
+
+
+std::string RmBroadcastServer::status() const
+{
+	std::string status;
+	char buff[100];
+
+	m_mutex.lock();
+	for ( unsigned int i = 0; i < m_subscribers.size(); ++i )
+	{
+		const Subscriber &s = *m_subscribers[i];
+		sprintf( buff, " rate %d sent %lu dropped %lu queued %d%s\n", s.rate, s.sent, s.dropped,
+			static_cast<int>(s.queue.size()), s.slow ? " (slow)" : "" );
+		status += addressOf( s ) + buff;
+	}
+	m_mutex.unlock();
+
+	return status;
+}
+
+
+int RmBroadcastServer::subscribers() const
+{
+	m_mutex.lock();
+	const int n = m_subscribers.size();
+	m_mutex.unlock();
+	return n;
+}
+
+
+void RmBroadcastServer::unsubscribeAll()
+{
+	m_mutex.lock();
+	for ( unsigned int i = 0; i < m_subscribers.size(); ++i ) delete m_subscribers[i];
+	m_subscribers.clear();
+	m_mutex.unlock();
+}
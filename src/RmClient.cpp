@@ -1,86 +1,96 @@
-// RmClient.cpp
-
-#include <iostream>
-#include "RmClient.h"
-#include "RmExceptions.h"
-
-
-RmClient::RmClient( const char *serverName, const short portNumber )
-{
-	WORD wVersionRequested = MAKEWORD(1,1);
-   	WSADATA wsaData;
-    int nRet = WSAStartup(wVersionRequested, &wsaData);
-	if (wsaData.wVersion != wVersionRequested)
-	{	
-		throw RmExceptions::SocketException( "RmServer::RmServer()", "Wrong version" );
-	}
-	
-	initClient( serverName, portNumber );
-}
-
-
-RmClient::~RmClient()
-{
-	closesocket( m_socket );
-
-	WSACleanup(); // release WinSock
-}
-
-
-void RmClient::initClient( const char *serverName, const short portNumber )
-{
-	//
-	// Find the server
-	//
-    LPHOSTENT lpHostEntry;
-	
-	lpHostEntry = gethostbyname( serverName );
-    if ( lpHostEntry == NULL )
-    {
-		closesocket( m_socket );
-		throw RmExceptions::SocketException( "RmServer::initClient()", "Unable to get host name" );
-    }
-	
-	
-	//
-	// Create a UDP/IP datagram socket
-	//
-	m_socket = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
-	if ( m_socket == INVALID_SOCKET )
-	{
-		closesocket(m_socket);
-		throw RmExceptions::SocketException( "RmServer::initClient()", "Unable to create socket" );
-	}
-	
-	//
-	// Fill in the address structure for the server
-	//
-	m_serverAddress.sin_family = AF_INET;
-	m_serverAddress.sin_addr = *((LPIN_ADDR)*lpHostEntry->h_addr_list);
-	m_serverAddress.sin_port = htons( portNumber );
-}
-
-
-std::string RmClient::getServerReply()
-{
-	int nFromLen = sizeof(SOCKADDR);
-	memset( m_szBuf, 0, sizeof(m_szBuf) );
-	int nRet = recvfrom( m_socket, m_szBuf, sizeof(m_szBuf), 0, (LPSOCKADDR)&m_serverAddress, 
-		&nFromLen );
-
-	if ( nRet == SOCKET_ERROR ) {
-		throw RmExceptions::SocketException( "RmClient::getReply()", "Socket error" );
-	}
-
-	return std::string( m_szBuf );
-}
-
-
-void RmClient::sendServerString( std::string s )
-{
-	int nRet = sendto( m_socket, s.c_str(), s.length(), 0, (LPSOCKADDR)&m_serverAddress, 
-		sizeof(SOCKADDR) );
-	if ( nRet == SOCKET_ERROR ) {
-		throw RmExceptions::SocketException( "RmClient::sendServerString()", "Socket error" );
-	}
+// RmClient.cpp
+
+#include <iostream>
+#include <cstring>
+#include "RmClient.h"
+#include "RmExceptions.h"
+
+
+RmClient::RmClient( const char *serverName, const short portNumber )
+{
+	RmSocket::startup( "RmClient::RmClient()" );
+
+	try {
+		initClient( serverName, portNumber );
+	}
+	catch ( RmExceptions::Exception ) {
+		RmSocket::cleanup();
+		throw;
+	}
+}
+
+
+RmClient::~RmClient()
+{
+	RmSocket::close( m_socket );
+	RmSocket::cleanup();
+}
+
+
+void RmClient::initClient( const char *serverName, const short portNumber )
+{
+	//
+	// Find the server
+	//
+    hostent *lpHostEntry;
+	
+	lpHostEntry = gethostbyname( serverName );
+    if ( lpHostEntry == NULL )
+    {
+		throw RmExceptions::SocketException( "RmServer::initClient()", "Unable to get host name" );
+    }
+	
+	
+	//
+	// Create a UDP/IP datagram socket
+	//
+	m_socket = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+	if ( m_socket == RmSocket::InvalidSocket )
+	{
+		throw RmExceptions::SocketException( "RmServer::initClient()", "Unable to create socket" );
+	}
+	
+	//
+	// Fill in the address structure for the server
+	//
+	memset( &m_serverAddress, 0, sizeof(m_serverAddress) );
+	m_serverAddress.sin_family = AF_INET;
+	m_serverAddress.sin_addr = *((in_addr*)*lpHostEntry->h_addr_list);
+	m_serverAddress.sin_port = htons( portNumber );
+}
+
+
+std::string RmClient::getServerReply()
+{
+	std::string s;
+	pollServerReply( s, RmSocket::Forever );
+	return s;
+}
+
+
+bool RmClient::pollServerReply( std::string &s, int timeout )
+{
+	if ( RmSocket::waitReadable( &m_socket, 1, timeout ) < 0 ) return false;
+
+	RmSocket::AddressLength nFromLen = sizeof(m_serverAddress);
+	int nRet = recvfrom( m_socket, m_szBuf, sizeof(m_szBuf) - 1, 0, (sockaddr*)&m_serverAddress, 
+		&nFromLen );
+
+	if ( nRet < 0 ) {
+		throw RmExceptions::SocketException( "RmClient::pollServerReply()", "Socket error" );
+	}
+
+	m_szBuf[nRet] = '\0';
+	s = m_szBuf;
+	return true;
+}
+
+
+void RmClient::sendServerString( std::string s )
+{
+	int nRet = sendto( m_socket, s.c_str(), s.length(), 0, (sockaddr*)&m_serverAddress, 
+		sizeof(m_serverAddress) );
+	if ( nRet < 0 ) {
+		throw RmExceptions::SocketException( "RmClient::sendServerString()", "Socket error" );
+	}
 }
\ No newline at end of file
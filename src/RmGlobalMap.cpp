@@ -1,870 +1,1748 @@
-// RmGlobalMap.cpp
-
-/* Notes:
- * On nomenclature.  Variables that have a world (unscaled) or grid (scaled) frame of reference are
- * prepended with a "w" or "g", respectively.
- */
-
-#pragma warning( disable : 4786 )
-
-#include <cstdlib>
-#include <cmath>
-#include <iostream>
-#include <string>
-#include "RmGlobalMap.h"
-using RmGlobalMap::RegionId;
-#include "RmUtilityExt.h"
-#include "RmExceptions.h"
-using namespace RmExceptions;
-#include "RmUtility.h"
-
-
-using RmUtility::BoundBox;
-using RmUtility::Coord;
-using RmUtility::Pose;
-using RmUtility::SonarReading;
-using RmUtility::MappedSonarReading;
-
-
-RmGlobalMap::RmGlobalMap( RmSettings* s )
-	: RmBayesCertaintyGrid( s, Coord() ),
-	  m_settings(s), m_finalized(false), m_currentMap(NULL), m_wDistance(0.0), 
-	  m_regionMap(), m_maxRegionId(0)
-{
-	static const char *signature_ = "RmGlobalMap::RmGlobalMap(RmSettings*)";
-	if ( s == NULL ) throw InvalidParameterException( signature_, "RmSettings may not be null" );
-
-	// Open localization log file
-	if ( s->Localize && s->GridName != "" ) {
-		m_debugLogName = s->GridName;
-		m_debugLogName.append( ".log" );
-		m_debugLog.open( m_debugLogName.c_str() );
-		m_debugLog.setf( std::ios_base::fixed, std::ios_base::floatfield );
-		m_debugLog.precision( 4 );
-	}
-}
-
-
-void RmGlobalMap::addToRegionMap( RmLocalMap *mt )
-{
-	// Integrates newly built independent L_t into G
-
-	// Validate input
-	assert( mt != NULL );
-	assert( mt->cumDistance() > 0 );
-	assert( m_maps.size() > 0 );
-
-	// Init region boundary (rt) to that of the local map at time t (lt)
-	// Note: map boundaries are expanded by one on their north and eastern borders so as to
-	// compensate for the polygon filling routine which excludes cells along those borders
-	RmPolygon rt( mt->bound().expandBy( 1, 0, 1, 0 ) );
-
-	// Init history of processed regions to region 0, that is, the non-region
-	std::set<RegionId> processedRegions;
-	processedRegions.insert( 0 ); // non-region has id of 0, which is treated as processed
-
-	// For each prior local map (mi{i=t-1..0})
-	std::vector<RmLocalMap*>::reverse_iterator mip = m_maps.rbegin();
-	while ( ++mip != m_maps.rend() )
-	{
-		// If prior local map i (bi) intersects that at time t (bx)
-		const RmPolygon bi( (*mip)->bound().expandBy( 1, 0, 1, 0 ) );
-		const RmPolygon bx( bi.intersectedWith( rt ) );
-		if ( bx.numContours() > 0 ) 
-		{
-			// For each cell in global map (G) over intersection (bx)
-			std::vector<Coord> fill;
-			bx.fillInto( &fill );
-			std::vector<Coord>::const_iterator cell;
-			for( cell = fill.begin(); cell != fill.end(); ++cell )
-			{
-				// Get region assigned to that cell
-				const RegionId regionId = m_regionMap.valueAt( cell->x, cell->y );
-
-				// If region not previously processed
-				if ( processedRegions.count( regionId ) == 0 )
-				{
-					// Get region's intersection (rx) with map bound intersection (bx)
-					Region *rc = m_regions[regionId];
-					// ***
-					const RmPolygon rx( rc->boundary.intersectedWith( bx ) );
-					// Subtract region intersection (rx) from bound of map at time t (rt)
-					rt -= rx;
-
-					// Subtract region intersection (rx) from region at current cell (rc)
-					RmPolygon bcx( rc->boundary - rx );
-
-					// [Remove Rc->L that no longer intersect]
-
-					// If region at cell (rc) is now empty, delete the region
-					// Note: must use temp bcx so deleteRegion() has rc->boundary to work with
-					if ( bcx.numContours() == 0 ) deleteRegion( &rc );
-					else rc->boundary = bcx;
-					
-					// Create new region (rnew) as intersection of cell region + map intersection
-					// Fill new region (rnew) over global map (G) with Rnew.id
-					Region *rnew = newRegion( rx );
-
-					// Add map at time i (mi) and t (mt) to new region (rnew)
-					rnew->maps.insert( *mip );
-					rnew->maps.insert( mt );
-
-					// Add maps from cell region (rc) that intersect new region (rnew)
-					if ( rc != NULL ) { // (if not just deleted)
-						std::set<RmLocalMap*>::const_iterator mcp;					
-						for ( mcp = rc->maps.begin(); mcp != rc->maps.end(); ++mcp ) 
-						{
-							// Ignore those already assigned to the region
-							if ( *mcp == *mip || *mcp == mt ) continue;
-
-							// If intersects the region
-							if ( rx.intersectedWith( 
-								RmPolygon( (*mcp)->bound() ) ).numContours() > 0 ) 
-							{
-								rnew->maps.insert( *mcp );
-							}
-						}
-					}
-
-					// Mark intersecting region as processed (original and new)
-					processedRegions.insert( regionId );
-					processedRegions.insert( rnew->id );
-				}
-			}
-		}
-	}
-
-	
-	// If B not empty
-	if ( rt.numContours() != 0 )
-	{
-		// Create new region R_t with boundary Bt
-		// For each G region cell in L_t, replace with R_new.id
-		Region *rnew = newRegion( rt );
-
-		// Add L_t to R_new
-		rnew->maps.insert( mt );
-	}
-}
-
-
-std::string RmGlobalMap::clearMapString( const BoundBox &gBound ) const
-{
-	char *buff = new char[(gBound.ul.y - gBound.lr.y + 1) * (gBound.lr.x - gBound.ul.x + 1) * 17 + 1];
-	char *buffPtr = &buff[0];
-
-	for ( int gY = gBound.ul.y; gY >= gBound.lr.y; --gY ) {
-		for ( int gX = gBound.ul.x; gX <= gBound.lr.x; ++gX ) {
-			sprintf( buffPtr, "%d %d %.4f;", gX, gY, RmBayesCertaintyGrid::InitVal );
-			buffPtr += strlen( buffPtr );
-		}
-	}
-
-	std::string logString( buff );
-	delete[] buff;
-
-	return logString;
-}
-
-
-float RmGlobalMap::convolvedValueAt( int x, int y ) const
-{
-	RegionId rId; // region id
-
-	// If the requested cell is out of bounds are not covered by a region,
-	// return the default value
-	if ( !inBounds( Coord( x, y ) ) || (rId = m_regionMap[x][y]) == 0 ) {
-		return RmBayesCertaintyGrid::InitVal;
-	}
-
-	// Get the region covering the cell
-	std::map<RegionId,Region*>::const_iterator ri( m_regions.find( rId ) ); // region iterator
-	assert( ri != m_regions.end() );
-	Region *r = (*ri).second;
-
-	// Sum non-empty probabilities for each local map assigned to the region
-	float gPr = 0.0f; // global map prior probability
-	int cnt = 0;
-	std::set<RmLocalMap*>::const_iterator mi; // map iterator
-	for ( mi = r->maps.begin(); mi != r->maps.end(); ++mi )
-	{
-		// Convolve values
-		float pr = (*mi)->valueAt( x, y );
-		if ( pr != RmBayesCertaintyGrid::InitVal ) {
-			gPr += pr;
-			++cnt;
-		}
-	}
-	gPr = cnt == 0 ? RmBayesCertaintyGrid::InitVal : gPr / cnt;
-
-	return gPr;
-}
-
-
-void RmGlobalMap::deleteRegion( Region **const r )
-{
-	assert( *r != NULL );
-	assert( (*r)->id > 0 );
-
-	Region *rorig = *r; // save state so can assert it doesn't change
-
-	fillRegionMap( *r, 0 );
-	m_usedRegionIds.push( (*r)->id );
-	m_regions.erase( (*r)->id );
-
-	assert( rorig == *r ); // this failed when calling this method from within an iteration
-		// over m_regions in RmGlobalMap::empty() because m_regions.erase() would delete *r first,
-		// and a second attempt below would cause a crash
-
-	delete *r;
-	*r = NULL;
-}
-
-
-void RmGlobalMap::empty()
-{
-	// Free memory allocated for local maps
-	std::vector<RmLocalMap*>::const_iterator map;
-	for ( map = m_maps.begin(); map != m_maps.end(); ++map ) delete *map;
-	m_maps.clear();
-
-	// Free memory allocated for regions
-	std::map<RegionId,Region*>::const_iterator region;
-	for ( region = m_regions.begin(); region != m_regions.end(); ++region ) 
-	{
-		const Region *r = (*region).second;
-		delete r;
-		r = NULL;
-	}
-	m_regions.clear(); // empty collection of region pointers
-	m_regionMap.empty(); // empty the region grid
-	while ( !m_usedRegionIds.empty() ) m_usedRegionIds.pop(); // empty collection of used region ids
-	m_maxRegionId = 0; // reset next region id
-
-	m_wDistance = 0.0;
-	m_currentMap = NULL;
-	m_gAccumShift = Pose();
-	m_finalized = false;
-	m_debugLog.seekp( 0 ); // in lieu of closing and reopening, which doesn't work in dll mode
-
-	RmMutableCartesianGrid<float>::empty();
-}
-
-
-void RmGlobalMap::fillRegionMap( const Region *const r, const RegionId id )
-{
-	assert( r != NULL );
-	assert( id <= m_maxRegionId );
-
-	std::vector<Coord> fill;
-	r->boundary.fillInto( &fill );
-	std::vector<Coord>::const_iterator cell;
-	for( cell = fill.begin(); cell != fill.end(); ++cell )
-	{
-		// Replace with R_new.id
-		m_regionMap.valueAt( cell->x, cell->y ) = id;
-	}
-}
-
-
-void RmGlobalMap::finalize()
-{
-	if ( m_finalized ) return;
-
-	if ( m_currentMap != NULL ) addToRegionMap( m_currentMap );
-	integrate();
-
-	m_finalized = true;
-}
-
-
-std::string RmGlobalMap::installNewMap( const SonarReading& wNewReading )
-{
-	// NOTE:  
-	// In this context, the "current" map is the map just built in its entirety but not yet
-	// convolved with the global map; the "new" map isn't created until after this current
-	// map has been relocalized and convolved, and a new map pose localization accomplished
-	// using newReading
-
-	// Given three consecutive local maps, A, B, and C, with A being the first map built:
-	// Pose A is neither localized prior to construction nor relocalized after construction
-	//		because there is no current or prior map data to localize against
-	// Pose B is localized prior to construction using map data from A, 
-	//		and relocalized after construction using its own data
-	// Pose C is processed in like manner to B, but in reference to B, and so on
-
-	static SonarReading wCurrentReading_; // saves reading used for current map's pose
-	std::string logString;
-
-	if ( m_currentMap != NULL )
-	{
-		RmPolygon dirtyRegion( m_currentMap->bound() );
-
-		//////
-		// Relocalize map just finished building (at t-1)
-
-		if ( m_settings->Localize && m_maps.size() > 1 ) 
-		{
-			// NOTE: m_current map will be non-null and m_maps size will be == 1
-			// at the transition between maps A and B, as described above;
-			// The test for size > 1 prevents a doomed attempt to relocalize map A
-
-			// Convolve local map into global map
-			addToRegionMap( m_currentMap );
-
-			// Get updated relocalized pose for local map
-			RmLocalMap &priorMap = *m_maps[m_maps.size() - 2]; // at transition between B and C, priorMap = A
-			Pose gLocPose = localizedPose( priorMap, wCurrentReading_, m_debugLog );
-			Pose gOldPose = m_currentMap->pose().scaled( m_settings->CellSize );
-			gOldPose.theta = priorMap.pose().coord.scaled( m_settings->CellSize ).angleTo( gOldPose.coord );
-			Pose gPoseShift = gLocPose - gOldPose; // scaled
-
-			// Restore global map to pre-convolved state
-			removeFromRegionMap( m_currentMap );
-
-			// Shift local map by relocalized pose shift
-			m_gAccumShift += gPoseShift;
-			m_currentMap->reorientBy( gPoseShift.scaled( 1.0 / m_settings->CellSize ) );
-
-			// Expand dirty region to include shift
-			dirtyRegion.unionWith( RmPolygon( m_currentMap->bound() ) );
-
-			if ( m_debugLog ) m_debugLog << "installNewMap() relocalize : " << gOldPose << ", " << gLocPose << ", " 
-				<< gPoseShift << ", " << m_gAccumShift << std::endl;
-		}	
-
-
-		//////
-		// Convolve newly finished map with global map
-
-		// Add to region map
-		addToRegionMap( m_currentMap );
-		logString += integrate( dirtyRegion, true );
-
-
-		//////
-		// Localize new map based on map just finished
-
-		if ( m_settings->Localize ) 
-		{
-			// Find delta between selected pose of new and finished local map
-			// Shift local map pose by delta (heading?)
-			// calc angle between coords of current and new map
-
-			Pose gLocPose = localizedPose( *m_currentMap, wNewReading, m_debugLog );
-			Pose gPrePose( wNewReading.robotPose.scaled( m_settings->CellSize ) );
-			gPrePose.theta = m_currentMap->pose().coord.scaled( m_settings->CellSize ).angleTo( gPrePose.coord );
-			Pose gPoseShift = gLocPose - gPrePose;
-			m_gAccumShift += gPoseShift;
-
-			if ( m_debugLog ) m_debugLog << "installNewMap() localize : " << gPrePose << ", " << gLocPose << ", " 
-				<< gPoseShift << ", " << m_gAccumShift << std::endl;
-		}
-	}
-
-
-	//////
-	// Create new map, beginning with sonar data just used
-
-	wCurrentReading_ = wNewReading;
-	wCurrentReading_.robotPose = wNewReading.robotPose + m_gAccumShift.scaled( 1.0 / m_settings->CellSize );
-	m_maps.push_back( m_currentMap = new RmLocalMap( m_settings, wCurrentReading_.robotPose ) );
-
-	return logString;
-}
-
-
-void RmGlobalMap::integrate()
-{
-	// For each cell in the region map (which represents the entire global map)
-	const BoundBox bound( m_regionMap.bound() );
-	for ( int y = bound.ul.y; y >= bound.lr.y; --y ) {
-		for ( int x = bound.ul.x; x <= bound.lr.x; ++x ) 
-		{
-			// Store the convolved value of all local maps over the cell
-			const RegionId rId = m_regionMap.valueAt( x, y );
-			valueAt( x, y ) = convolvedValueAt( x, y );
-		}
-	}
-}
-
-
-
-const std::string RmGlobalMap::integrate( const RmPolygon &bound, bool retVal )
-{
-	// get cells filling region
-	std::vector<Coord> fill;
-	bound.fillInto( &fill );
-
-	// create update string buffer
-	// format is "-xxx -yyy 0.dddd;"
-	char *buff = new char[(fill.size() * 17 + 1) * sizeof(char)];
-	char *buffPtr = buff;
-	*buffPtr = '\0';
-
-	// for each cell
-	std::vector<Coord>::const_iterator ci;
-	for ( ci = fill.begin(); ci != fill.end(); ++ci ) 
-	{
-		const float pr = convolvedValueAt( ci->x, ci->y );
-		valueAt( ci->x, ci->y ) = pr;
-		
-		// update log string by appending over previous terminating null
-		if ( retVal ) {
-			sprintf( buffPtr, "%d %d %.4f;", ci->x, ci->y, pr );
-			buffPtr += strlen( buffPtr );
-		}
-	}
-
-	// tack on local map update string
-	std::string updateString( buff );
-	delete[] buff;
-
-	return updateString;
-}
-
-
-
-#undef _LOG
-
-Pose RmGlobalMap::localizedPose( 
-	const RmLocalMap &priorMap, const SonarReading& wReading, std::ofstream& log ) const
-{
-	// Note:  unscaled -> in   out -> scaled
-
-	static int cnt_ = 0;
-	++cnt_;
-	#ifdef _LOG
-	log << "\n\nLOCAL MAP " << ((cnt_+1)/2) << "\nDimension: " << priorMap.width() << " x " << priorMap.height() << "\n";
-	log << "SonarReading:\n" << wReading << "\n";
-	#endif
-
-	const RmBayesSonarModel sonarModel( m_settings ); // used to calc Pr(Occ)
-	const Pose gPose( wReading.robotPose.scaled( m_settings->CellSize ) );
-
-	// Calculate probability distribution of pose using motion model
-	// Factors:  distance and degree of turns, where
-	//    height increases proportionally to distance traveled
-	//    width increases proportional to degrees turned
-	const int h = m_settings->MotionModel.MinHeight + 
-		priorMap.cumDistance() / m_settings->MotionModel.UnitDistance;
-	const int w = m_settings->MotionModel.MinWidth + 
-		priorMap.cumTurn() / m_settings->MotionModel.UnitTurn;
-	RmMutableCartesianGrid<float> gPoseDist( RmUtility::gaussGrid( w, h, gPose.coord, gPose.theta, 
-		m_settings->MotionModel.GaussianSigma, m_settings->MotionModel.BendFactor ) );
-
-	#ifdef _LOG
-	log << "cumDistance(" << priorMap.cumDistance()
-		<< ") cumTurn(" << priorMap.cumTurn() << ") gPoseDist[" << w << "][" << h << "]\n";
-	#endif
-
-	//*** Debug
-	// #ifndef _USRDLL
-	#ifdef _LOG
-	if ( log )
-	{
-		char *buff = new char[m_settings->GridName.length() + 7];
-
-		// Global map
-		sprintf( buff, "%s%02d.gd", m_settings->GridName.c_str(), cnt_ );
-		//sprintf( buff, "%s.gd", m_settings->GridName.c_str() );
-		integrate();
-		RmMutableCartesianGrid<float>::put( buff );
-
-		// Global map with pose distributions
-		static std::vector<RmMutableCartesianGrid<float> > gPoseDists_;
-		gPoseDists.push_back( gPoseDist );
-		RmMutableCartesianGrid<float> gpm( *this );
-		std::vector<RmMutableCartesianGrid<float> >::const_iterator it;
-		for ( it = gPoseDists_.begin(); it < gPoseDists_.end(); ++it ) gpm.mergeWith( *it );
-		sprintf( buff, "%s%02dp.gd", m_settings->GridName.c_str(), cnt_ );
-		//sprintf( buff, "%sp.gd", m_settings->GridName.c_str() );
-		gpm.put( buff );
-
-		delete[] buff;
-	}
-	#endif
-	// #endif
-	//*** End Debug
-	
-	// Histogram matrix over pose for tabulating selected poses for all sonars
-	RmMutableCartesianGrid<float> gPoseHist( gPoseDist );
-	gPoseHist.clear();
-	int maxPoseHist = 0; // highest value in histogram matrix
-	
-	// Create pose selection matrix, reinitialized for each sonar
-	// Note: while gPoseSel is a histogrammic matrix, are using float rather than int because can't
-	// easily copy configuration of gPoseDist any other way, and template class copy constructor
-	// requires same type.
-	RmMutableCartesianGrid<float> gPoseSel( gPoseDist ); // convolves prOcc with gPoseDist
-	#ifdef _LOG
-	RmMutableCartesianGrid<float> gPoseObs( gPoseDist ); // tracks obstructions; log use only
-	RmMutableCartesianGrid<float> gPoseGlo( gPoseDist ); // global map about range reading; log use only
-	RmMutableCartesianGrid<float> gPoseOcc( gPoseDist ); // occ grid about range reading; log use only
-	gPoseOcc.setInitValue( 0.5f );
-	#endif
-
-	// For each sonar
-	bool noneInRange = true; // indicates no sonar readings in range
-	SonarReading wReadingCopy( wReading ); // _UNSCALED_LOCALIZATION copy to be modified
-	for ( int i = 0; i < RmPioneerController::NumSonars; ++i )
-	{
-		// Calc grid-based vector (direction and magnitude) for the range reading
-		wReadingCopy.sonarNumber = i;
-		wReadingCopy.distance = wReadingCopy.all[i];
-		MappedSonarReading &gMR = 
-			RmPioneerController::rangeReading( wReadingCopy ).scale( m_settings->CellSize );
-			// rangeReading() is best used with unscaled data
-		#ifdef _LOG
-		log << "\n" << gMR;
-		#endif
-
-		// Skip out-of-range readings
-		// (placed after calculation of mr so mr log entry can first be entered)
-		if ( wReadingCopy.distance > RmPioneerController::SonarRange ) {
-			#ifdef _LOG
-			log << "Skipping out of range reading.\n";
-			#endif
-			continue;
-		}
-		noneInRange = false;
-
-
-		// Init pose selection and log matrices
-		gPoseSel.clear();
-		#ifdef _LOG
-		gPoseObs.clear();
-		gPoseOcc.setOrigin( gMR.objectCoord );
-		gPoseOcc.clear();
-		#endif
-
-		// For each cell in pose distribution matrix
-		float maxPoseSel = 0.0; // highest value in pose selection matrix
-		const BoundBox gBound = gPoseDist.bound();
-		const Coord gSonarShift = gMR.sonarPose.coord - gPose.coord;
-		const Coord gObjectShift = gMR.objectCoord - gMR.sonarPose.coord;
-		for ( int gY = gBound.ul.y; gY >= gBound.lr.y; --gY ) {
-			for ( int gX = gBound.ul.x; gX <= gBound.lr.x; ++gX ) 
-			{
-				// If cell at terminal end of range reading vector is unobstructed, 
-				// record pose selection likelihood
-				const Coord gStart = Coord( gX, gY ) + gSonarShift;
-				const Coord gEnd = gStart + gObjectShift;
-				if ( !obstructionBetween( gStart, gEnd ) ) 
-				{
-					#ifdef _LOG
-					// Record unostructed path for log output
-					gPoseObs[gX][gY] = 1.0f;
-					#endif
-
-					// get prior prob of occupied from global map
-					const float priorPrOcc = convolvedValueAt( gEnd.x, gEnd.y );
-
-					// get new prob of occupied for this pose dist cell
-					const float prOcc = sonarModel.prOccupiedGivenSn( 
-						priorPrOcc, RmBayesSonarModel::RegionI, gMR.reading.distance );
-					#ifdef _LOG
-					gPoseOcc[gEnd.x][gEnd.y] = prOcc;
-					#endif
-
-					const float s = gPoseSel[gX][gY] = prOcc * gPoseDist[gX][gY];
-					
-					if ( s > maxPoseSel ) maxPoseSel = s;
-				}
-			}
-		}
-
-		// Increment in pose histogram the cells corresponding to 
-		// those in pose selection matrix with highest prob
-		if ( maxPoseSel > 0 ) {
-			for ( gY = gPoseSel.bound().ul.y; gY >= gPoseSel.bound().lr.y; --gY ) {
-				for ( int gX = gPoseSel.bound().ul.x; gX <= gPoseSel.bound().lr.x; ++gX ) 
-				{
-					if ( gPoseSel[gX][gY] == maxPoseSel ) {
-						const int h = ++gPoseHist[gX][gY]; // store so don't have to call [][] twice
-						if ( h > maxPoseHist ) maxPoseHist = h;
-					}
-				}
-			}
-		}
-
-		#ifdef _LOG
-		gPoseGlo.setOrigin( gMR.objectCoord );
-		copyInto( gPoseGlo );
-		log << "PrOcc at object = " << gPoseOcc[gMR.objectCoord.x][gMR.objectCoord.y] << ", prior = " << gPoseGlo[gMR.objectCoord.x][gMR.objectCoord.y] << "\n";
-		log << "\nposeDistribution over Robot Pose, by local map, " << "Bound: " << gPoseDist.bound() << " Origin: " 
-			<< gPoseDist.origin() << "\n" << gPoseDist;
-		log << "\nglobalMap over Object, by sonar, " << "Bound: " << gPoseGlo.bound() << " Origin: " 
-			<< gPoseGlo.origin() << "\n" << gPoseGlo;
-		log << "\nposeObstructions over Object, by sonar, 0 = obstructed (path from Robot Pose to Object)\n" << gPoseObs;
-		log << "\nprOcc over Object, by unobstructed sonar\n" << gPoseOcc;
-		log << "\nposeSelelections over Object, by sonar (gPoseDist * prOcc * gPoseObs)\n" << gPoseSel << "\n";
-		log << "poseHistogram over Robot Pose, by local map (max gPoseSel)\n" << gPoseHist << "\n";
-		
-		log << "===== End Sonar " << i << "\n";
-		#endif
-	}
-
-	// If no poses were selected, all sonar readings were out of range
-	// Can only return original pose
-	if ( maxPoseHist == 0 ) {
-		#ifdef _LOG
-		log << "\nNo sonar readings in range!\n\n";
-		#endif
-		Pose gLocPose( wReading.robotPose.scaled( m_settings->CellSize ) );
-		gLocPose.theta = priorMap.pose().coord.angleTo( wReading.robotPose.coord );
-		return gLocPose;
-	}
-
-	// Get poses with max pose histogram value and record corresponding max post dist value
-	std::vector<Coord> gSelectedPoses;
-	float maxSelPoseDist = 0.0f;
-	for ( int gY = gPoseHist.bound().ul.y; gY >= gPoseHist.bound().lr.y; --gY ) {
-		for ( int gX = gPoseHist.bound().ul.x; gX <= gPoseHist.bound().lr.x; ++gX ) 
-		{
-			if ( gPoseHist[gX][gY] == maxPoseHist ) {
-				gSelectedPoses.push_back( Coord( gX, gY ) );
-				const float pd = gPoseDist[gX][gY]; // store so don't have to call [][] twice
-				if ( pd > maxSelPoseDist ) maxSelPoseDist = pd;
-			}
-		}
-	}
-
-	// Filter all but those with the highest underlying maximum pose distribution
-	log << "maxSelPoseDist = " << maxSelPoseDist << "\n";
-	std::vector<Coord>::iterator gSelectedPose = gSelectedPoses.begin();
-	while ( gSelectedPose < gSelectedPoses.end() )
-	{
-		const Coord gc( *gSelectedPose );
-		log << gc << ":" << gPoseDist[gc.x][gc.y] << " ";
-		if ( gPoseDist[gc.x][gc.y] < maxSelPoseDist ) {
-			gSelectedPoses.erase( gSelectedPose ); // implicit ++gSelectedPose
-			log << "erased\n";
-		}
-		else {
-			++gSelectedPose;
-			log << "retained\n";
-		}
-	}
-
-	// If more than one selected pose, take the first (for now)
-	if ( gSelectedPoses.size() != 1 ) 
-	{
-		#ifdef _LOG
-		log << "maxSelPoseDist = " << maxSelPoseDist << "\n";
-		log << "candidate poses: ";
-		for ( gSelectedPose = gSelectedPoses.begin(); gSelectedPose < gSelectedPoses.end(); ++gSelectedPose )
-		{
-			log << *gSelectedPose << " ";
-		}
-		log << "\n";
-		#endif
-		char buff[50];
-		sprintf( buff, "%d poses remain in filtered selection matrix", gSelectedPoses.size() );
-		RmExceptions::Exception e( NULL, "RmGlobalMap::localizedPose()", buff );
-
-		// This isn't an "error" so much as it is a condition;
-		// Notify and keep going
-		std::cerr << e;
-
-		// Additional filters for narrowing down selections:
-		// - highest avg of surrounding cells, etc.
-		// - closes proximity to original pose
-	}
-
-	Coord gSelCoord( gSelectedPoses.front() );
-
-	// Return the selected position and angle to that pos from current map's starting position
-	Pose gLocPose( gSelCoord, priorMap.pose().coord.scaled( m_settings->CellSize ).angleTo( gSelCoord ) );
-
-	#ifdef _LOG
-	log << "selPose: " << gLocPose << std::endl;
-	#endif
-
-	return gLocPose;
-}
-
-
-RmGlobalMap::Region* RmGlobalMap::newRegion( const RmPolygon &bound )
-{
-	RegionId id;
-	if ( m_usedRegionIds.empty() ) id = ++m_maxRegionId;
-	else {
-		id = m_usedRegionIds.front();
-		m_usedRegionIds.pop();
-	}
-
-	Region *r = new Region( id, bound );
-	m_regions[id] = r;
-	
-	fillRegionMap( r, id );
-
-	return r;
-}
-
-
-bool RmGlobalMap::obstructionBetween( const Coord& gStart, const Coord& gEnd ) const
-{
-	// Reasons for differences from original:
-	// - Checking for obstruction to gcObject rather than f (in RmBayesCertaintyGrid obstruction check)
-	// - Not processing last point in linePointList
-	// - Checking global map
-
-	bool obstructed = false;
-	float prGlobal = 0.0f;
-	float prLocal = 0.0f;
-	const float prObstr = m_settings->ObstructedCertainty;
-
-	for ( PointList* gLinePointList = FillLine( gStart.x, gStart.y, gEnd.x, gEnd.y ); // [start..end)
-		gLinePointList; gLinePointList = gLinePointList->next )
-	{
-		const int gX = gLinePointList->point.X;
-		const int gY = gLinePointList->point.Y;
-
-		// These tests short-circuit further testing of either local or global bounds 
-		// once it has been determined one of them has been exceeded
-		int oneInBounds = 0;
-		if ( prGlobal != -1.0f ) {
-			if ( m_regionMap.inBounds( gX, gY ) ) {
-				prGlobal = convolvedValueAt( gX, gY );
-				++oneInBounds;
-			}
-			else prGlobal = -1.0f;
-		}
-		if ( prLocal != -1.0f ) {
-			if ( m_currentMap->inBounds( gX, gY ) ) {
-				prLocal = m_currentMap->valueAt( gX, gY );
-				++oneInBounds;
-			}
-			else prLocal = -1.0f;
-		}
-
-		// This test short-circuits all future testing if neither one are in-bounds
-		if ( !oneInBounds ) 
-			break;
-
-		if ( prLocal >= prObstr || prGlobal >= prObstr )
-		{
-			obstructed = true;
-			break;
-		}
-	}
-
-	return obstructed;
-}
-
-
-std::ostream& RmGlobalMap::put( std::ostream& os ) const
-{ 
-	m_settings->put( os, "% " );
-
-	return RmBayesCertaintyGrid::put( os );
-}
-
-
-void RmGlobalMap::removeFromRegionMap( RmLocalMap *map )
-{
-	assert( map != NULL );
-
-	// Set up tracking of processed regions
-	std::set<RegionId> regionsProcessed;
-	regionsProcessed.insert( 0 ); // non-region has id of 0, which is treated as processed
-
-	// For each cell within the map's bounds (with explicit inclusion of n/e borders)
-	RmPolygon bo( map->bound().expandBy( 1, 0, 1, 0 ) );
-	std::vector<Coord> fill;
-	bo.fillInto( &fill );
-	std::vector<Coord>::const_iterator ci;
-	for ( ci = fill.begin(); ci != fill.end(); ++ci ) 
-	{
-		// For regions not already processed
-		const RegionId regionId = m_regionMap.valueAt( ci->x, ci->y );
-		if ( regionsProcessed.count( regionId ) == 0 ) 
-		{
-			// Remove the map from the region
-			Region *r = m_regions[regionId];
-			r->maps.erase( map );
-
-			// If no maps cover the region any longer, delete it
-			if ( r->maps.size() == 0 ) deleteRegion( &r );
-
-			// Mark region as processed
-			regionsProcessed.insert( regionId );
-		}
-	}
-}
-
-
-const std::string RmGlobalMap::update( const SonarReading& wReading )
-{
-	if ( m_finalized ) return "";
-
-	// Accummulate distance traveled for current map
-	static bool newMap_ = true;
-	static Coord wLastPos_;
-	Coord wCurrPos = wReading.robotPose.coord;
-	if ( !newMap_ ) m_wDistance += wLastPos_.distanceFrom( wCurrPos );
-	wLastPos_ = wCurrPos;
-	newMap_ = false;
-
-	// Initialize new map on first run
-	// Would do in constructor but would have to assume origin pose of Pose()
-	std::string newMapString;
-	if ( m_currentMap == NULL )
-	{
-		m_debugLog << "Settings:\n" << *m_settings << "\n";
-		newMapString = installNewMap( wReading );
-	}
-
-	// If total distance exceeds prescribed amount
-	else if ( m_settings->LocalMapDistance > 0 && m_wDistance > m_settings->LocalMapDistance )
-	{
-		// Create new map
-		// Add to map collection
-		// Set current local map to new map
-		if ( m_settings->Localize ) newMapString = installNewMap( wReading );
-		else installNewMap( wReading );
-
-		newMap_ = true;
-		m_wDistance = 0.0;
-	}
-
-	// Modify reading by pose shift updated in installNewMap()
-	SonarReading wShiftedReading( wReading );
-	wShiftedReading.robotPose += m_gAccumShift.scaled( 1.0 / m_settings->CellSize );
-
-	// Prepare default pose string
-	Pose gRobotPose( wShiftedReading.robotPose.scaled( m_settings->CellSize ) );
-	char logPose[30];
-	sprintf( logPose, "%d %d %d %d %d\n", gRobotPose.coord.x, gRobotPose.coord.y, 
-		static_cast<int>(wReading.robotPose.theta), wReading.sonarNumber, wReading.distance );
-
-	// Skip obstructed readings (cell and axis models only)
-	const RmUtility::MappedSonarReading wMR = RmPioneerController::rangeReading( wShiftedReading );
-	if ( m_settings->SonarModel != RmUtility::Cone && m_settings->IgnoreObstructed && 
-		obstructionBetween( gridCoord( wMR.sonarPose.coord ), gridCoord( wMR.objectCoord ) ) ) {
-		return "";
-	}
-
-	// Pass reading on to current local map
-	std::string logString = m_currentMap->update( wMR );
-
-	// If update string is empty (due to out-of-range or disabled sonar)
-	// but we have a new map update string, include log line 1 for return to viewer
-	if ( logString.length() == 0 && newMapString.length() > 0 ) logString = logPose;
-	else logString = logString.substr( 0, logString.length() - 2 );
-	logString += newMapString;
-
-	return logString;
-}
-
-
-template<class T>
-std::ostream& operator<<( std::ostream& os, const std::vector<T>& v )
-{
-	std::vector<T>::const_iterator it;
-	for( it = v.begin(); it != v.end(); ++it ) {
-		os << *it << " ";
-	}
-	return os;
-}
+// RmGlobalMap.cpp
+
+/* Notes:
+ * On nomenclature.  Variables that have a world (unscaled) or grid (scaled) frame of reference are
+ * prepended with a "w" or "g", respectively.
+ */
+
+#pragma warning( disable : 4786 )
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "Aria.h"
+#include "RmGlobalMap.h"
+using RmGlobalMap::RegionId;
+#include "RmUtilityExt.h"
+#include "RmExceptions.h"
+using namespace RmExceptions;
+#include "RmUtility.h"
+#include "RmBinaryIO.h"
+#include "RmInstrument.h"
+#include "RmLocalizationTrace.h"
+#include "RmTrace.h"
+
+
+using RmUtility::BoundBox;
+using RmUtility::Coord;
+using RmUtility::Pose;
+using RmUtility::SonarReading;
+using RmUtility::MappedSonarReading;
+
+
+const int RmGlobalMap::SnapshotVersion = 6;
+const int RmGlobalMap::VersionTileSize = 16;
+
+/** Identifies a file as a global map snapshot; see RmGlobalMap::write() */
+static const char *SnapshotMagic = "RMGM";
+
+/** Identifies a file as a spill of retired local maps, and its version; see RmGlobalMap::retire() */
+static const char *SpillMagic = "RMLS";
+static const int SpillVersion = 1;
+
+
+/**
+ * Returns an estimate of the bytes allocated for each node of a std::set or std::map whose
+ * values are of the given size: the value, and the links and color of a red-black tree node.
+ */
+static unsigned long treeNodeBytes( unsigned long valueSize )
+{
+	return valueSize + 4 * sizeof(void*);
+}
+
+
+/**
+ * Supplies the tiles of a global map to RmGridFile::write() by convolving its local maps;
+ * see RmGlobalMap::writeTiled().
+ */
+class ConvolvedTiles : public RmGridFile::TileSource
+{
+public:
+
+	ConvolvedTiles( const RmGlobalMap &map ) : m_map(map) {}
+
+	virtual bool tile( const BoundBox &area, std::vector<float> &cells ) const
+	{
+		bool initialized = true;
+		std::vector<float>::iterator cell = cells.begin();
+		for ( int y = area.ul.y; y >= area.lr.y; --y ) {
+			for ( int x = area.ul.x; x <= area.lr.x; ++x, ++cell ) 
+			{
+				*cell = m_map.regionValueAt( x, y );
+				if ( *cell != RmBayesCertaintyGrid::InitVal ) initialized = false;
+			}
+		}
+		return !initialized;
+	}
+
+private:
+
+	const RmGlobalMap &m_map;
+};
+
+
+/**
+ * Fuses a band of the rows of a global map on a thread of its own; see RmGlobalMap::integrate().
+ */
+class FusedBand : public ArASyncTask
+{
+public:
+
+	FusedBand( RmGlobalMap &map, const BoundBox &band ) 
+		: m_map(map), m_band(band), m_failed(false) {}
+
+	virtual void *runThread( void *arg )
+	{
+		try {
+			m_map.integrateRows( m_band );
+		}
+		catch ( RmExceptions::Exception e ) {
+			m_error = e;
+			m_failed = true;
+		}
+		return NULL;
+	}
+
+	/** Returns true if fusion ended with an exception, which is returned by error() */
+	bool failed() const { return m_failed; }
+
+	const RmExceptions::Exception& error() const { return m_error; }
+
+private:
+
+	RmGlobalMap &m_map;
+	const BoundBox m_band;
+	bool m_failed;
+	RmExceptions::Exception m_error;
+};
+
+
+/**
+ * Records a trace event of the correction of the given robot's pose by localization,
+ * from its prior pose to its localized pose, if tracing.
+ */
+static void tracePoseShift( const char *name, int robot, const Pose &gPrior, const Pose &gLocalized,
+	const Pose &gShift, const Pose &gAccumShift )
+{
+	if ( !RmTrace::recording() ) return;
+	char args[256];
+	sprintf( args, "\"robot\":%d,\"prior\":[%d,%d,%.2f],\"localized\":[%d,%d,%.2f],"
+		"\"shift\":[%d,%d,%.2f],\"accumShift\":[%d,%d,%.2f]", robot,
+		gPrior.coord.x, gPrior.coord.y, gPrior.theta,
+		gLocalized.coord.x, gLocalized.coord.y, gLocalized.theta,
+		gShift.coord.x, gShift.coord.y, gShift.theta,
+		gAccumShift.coord.x, gAccumShift.coord.y, gAccumShift.theta );
+	RmTrace::instant( name, args );
+}
+
+
+Pose RmGlobalMap::accumulatedShift( int robot ) const
+{
+	return robot >= 0 && robot < robots() ? m_trajectories[robot].gAccumShift : Pose();
+}
+
+
+RmGlobalMap::RmGlobalMap( RmSettings* s )
+	: RmBayesCertaintyGrid( s, Coord() ),
+	  m_settings(s), m_localizationTrace(NULL), m_mapPool(16), m_finalized(false), 
+	  m_regionMap(), m_maxRegionId(0), m_checkpointPending(false),
+	  m_quantized(s != NULL && s->QuantizedMap), 
+	  m_quantizedMap(1, 1, Coord(), RmUtility::quantize( InitVal )),
+	  m_retiredSums(1, 1, Coord(), 0.0f), m_retiredCounts(1, 1, Coord(), 0),
+	  m_version(0), m_resetVersion(0)
+{
+	static const char *signature_ = "RmGlobalMap::RmGlobalMap(RmSettings*)";
+	if ( s == NULL ) throw InvalidParameterException( signature_, "RmSettings may not be null" );
+
+	// Open localization trace
+	if ( s->Localize && s->LocalizationTraceName != "" ) {
+		m_localizationTrace = 
+			new RmLocalizationTrace( s->LocalizationTraceName, s->LocalizationDumpInterval );
+	}
+}
+
+
+RmGlobalMap::~RmGlobalMap()
+{
+	releaseMaps();
+	delete m_localizationTrace;
+}
+
+
+bool RmGlobalMap::requestLocalizationDump()
+{
+	if ( m_localizationTrace == NULL ) return false;
+	m_localizationTrace->requestDump();
+	return true;
+}
+
+
+void RmGlobalMap::addToRegionMap( RmLocalMap *mt )
+{
+	RM_INSTRUMENT_TIMER( RmInstrument::AddToRegionMap );
+	RmTrace::Scope trace( "addToRegionMap" );
+
+	// Integrates newly built independent L_t into G
+
+	// Validate input
+	assert( mt != NULL );
+	assert( mt->cumDistance() > 0 );
+	assert( m_maps.size() > 0 );
+
+	// Init region boundary (rt) to that of the local map at time t (lt)
+	// Note: map boundaries are expanded by one on their north and eastern borders so as to
+	// compensate for the polygon filling routine which excludes cells along those borders
+	RmPolygon rt( mt->bound().expandBy( 1, 0, 1, 0 ) );
+
+	// Init history of processed regions to region 0, that is, the non-region
+	RmFlatSet<RegionId> processedRegions;
+	processedRegions.insert( 0 ); // non-region has id of 0, which is treated as processed
+
+	// For each prior local map (mi{i=t-1..0}), that is, each already added to the region map,
+	// whichever the robot that built it
+	std::vector<RmLocalMap*>::reverse_iterator mip;
+	for ( mip = m_maps.rbegin(); mip != m_maps.rend(); ++mip )
+	{
+		if ( *mip == mt || m_regionMaps.count( *mip ) == 0 ) continue;
+
+		// If prior local map i (bi) intersects that at time t (bx)
+		const RmPolygon bi( (*mip)->bound().expandBy( 1, 0, 1, 0 ) );
+		const RmPolygon bx( bi.intersectedWith( rt ) );
+		if ( bx.numContours() > 0 ) 
+		{
+			// For each cell in global map (G) over intersection (bx)
+			std::vector<Coord> fill;
+			bx.fillInto( &fill );
+			std::vector<Coord>::const_iterator cell;
+			for( cell = fill.begin(); cell != fill.end(); ++cell )
+			{
+				// Get region assigned to that cell
+				const RegionId regionId = m_regionMap.valueAt( cell->x, cell->y );
+
+				// If region not previously processed
+				if ( processedRegions.count( regionId ) == 0 )
+				{
+					// Get region's intersection (rx) with map bound intersection (bx)
+					Region *rc = m_regions[regionId];
+					// ***
+					const RmPolygon rx( rc->boundary.intersectedWith( bx ) );
+					// Subtract region intersection (rx) from bound of map at time t (rt)
+					rt -= rx;
+
+					// Subtract region intersection (rx) from region at current cell (rc)
+					RmPolygon bcx( rc->boundary - rx );
+
+					// [Remove Rc->L that no longer intersect]
+
+					// If region at cell (rc) is now empty, delete the region
+					// Note: must use temp bcx so deleteRegion() has rc->boundary to work with
+					if ( bcx.numContours() == 0 ) deleteRegion( &rc );
+					else rc->boundary.swap( bcx );
+					
+					// Create new region (rnew) as intersection of cell region + map intersection
+					// Fill new region (rnew) over global map (G) with Rnew.id
+					Region *rnew = newRegion( rx );
+
+					// Add map at time i (mi) and t (mt) to new region (rnew)
+					rnew->maps.insert( *mip );
+					rnew->maps.insert( mt );
+
+					// Add maps from cell region (rc) that intersect new region (rnew)
+					if ( rc != NULL ) { // (if not just deleted)
+						RmFlatSet<RmLocalMap*>::const_iterator mcp;
+						for ( mcp = rc->maps.begin(); mcp != rc->maps.end(); ++mcp ) 
+						{
+							// Ignore those already assigned to the region
+							if ( *mcp == *mip || *mcp == mt ) continue;
+
+							// If intersects the region
+							if ( rx.intersectedWith( 
+								RmPolygon( (*mcp)->bound() ) ).numContours() > 0 ) 
+							{
+								rnew->maps.insert( *mcp );
+							}
+						}
+					}
+
+					// Mark intersecting region as processed (original and new)
+					processedRegions.insert( regionId );
+					processedRegions.insert( rnew->id );
+				}
+			}
+		}
+	}
+
+	
+	// If B not empty
+	if ( rt.numContours() != 0 )
+	{
+		// Create new region R_t with boundary Bt
+		// For each G region cell in L_t, replace with R_new.id
+		Region *rnew = newRegion( rt );
+
+		// Add L_t to R_new
+		rnew->maps.insert( mt );
+	}
+
+	m_regionMaps.insert( mt );
+}
+
+
+void RmGlobalMap::changedTiles( unsigned long since, std::vector<Coord> &tiles ) const
+{
+	std::map<std::pair<int,int>,unsigned long>::const_iterator ti;
+	for ( ti = m_tileVersions.begin(); ti != m_tileVersions.end(); ++ti ) {
+		if ( ti->second > since ) tiles.push_back( Coord( ti->first.second, ti->first.first ) );
+	}
+}
+
+
+void RmGlobalMap::checkpointIfDue()
+{
+	if ( !m_checkpointPending ) return;
+	if ( m_checkpointed.mSecSince() < m_settings->CheckpointInterval * 1000L ) return;
+
+	m_checkpointPending = false;
+	save( m_checkpointName.c_str() );
+	m_checkpointed.setToNow();
+}
+
+
+std::string RmGlobalMap::clearMapString( const BoundBox &gBound ) const
+{
+	char *buff = new char[(gBound.ul.y - gBound.lr.y + 1) * (gBound.lr.x - gBound.ul.x + 1) * 17 + 1];
+	char *buffPtr = &buff[0];
+
+	for ( int gY = gBound.ul.y; gY >= gBound.lr.y; --gY ) {
+		for ( int gX = gBound.ul.x; gX <= gBound.lr.x; ++gX ) {
+			buffPtr += RmUtility::cellString( 
+				buffPtr, gX, gY, RmBayesCertaintyGrid::InitVal, m_settings->QuantizedStream );
+		}
+	}
+
+	std::string logString( buff );
+	delete[] buff;
+
+	return logString;
+}
+
+
+float RmGlobalMap::convolvedValueAt( int x, int y ) const
+{
+	// If the requested cell is out of the bounds of the fused map, whichever its representation,
+	// return the default value
+	const bool inFusedBounds = m_quantized ? m_quantizedMap.inBounds( x, y ) : inBounds( x, y );
+	return inFusedBounds ? regionValueAt( x, y ) : RmBayesCertaintyGrid::InitVal;
+}
+
+
+void RmGlobalMap::deleteRegion( Region **const r )
+{
+	assert( *r != NULL );
+	assert( (*r)->id > 0 );
+
+	Region *rorig = *r; // save state so can assert it doesn't change
+
+	fillRegionMap( *r, 0 );
+	m_usedRegionIds.push( (*r)->id );
+	m_regions.erase( (*r)->id );
+
+	assert( rorig == *r ); // this failed when calling this method from within an iteration
+		// over m_regions in RmGlobalMap::empty() because m_regions.erase() would delete *r first,
+		// and a second attempt below would cause a crash
+
+	(*r)->~Region();
+	m_regionPool.deallocate( *r );
+	*r = NULL;
+}
+
+
+void RmGlobalMap::releaseMaps()
+{
+	// Each is destroyed, then the storage of all released at once
+	std::vector<RmLocalMap*>::const_iterator map;
+	for ( map = m_maps.begin(); map != m_maps.end(); ++map ) (*map)->~RmLocalMap();
+	m_maps.clear();
+	m_regionMaps.clear();
+	m_mapPool.release();
+
+	std::map<RegionId,Region*>::const_iterator region;
+	for ( region = m_regions.begin(); region != m_regions.end(); ++region ) {
+		(*region).second->~Region();
+	}
+	m_regions.clear(); // empty collection of region pointers
+	m_regionPool.release();
+}
+
+
+void RmGlobalMap::empty()
+{
+	releaseMaps();
+	m_regionMap.empty(); // empty the region grid
+	while ( !m_usedRegionIds.empty() ) m_usedRegionIds.pop(); // empty collection of used region ids
+	m_maxRegionId = 0; // reset next region id
+
+	m_trajectories.clear();
+	m_finalized = false;
+	m_checkpointPending = false;
+	m_checkpointed.setToNow();
+	m_quantized = m_settings->QuantizedMap;
+	m_quantizedMap.empty();
+	m_retiredSums.empty();
+	m_retiredCounts.empty();
+	if ( m_retiredSpill.is_open() ) m_retiredSpill.close();
+	m_tileVersions.clear();
+	m_resetVersion = ++m_version;
+
+	RmMutableCartesianGrid<float>::empty();
+	measureMemory();
+}
+
+
+void RmGlobalMap::fillRegionMap( const Region *const r, const RegionId id )
+{
+	assert( r != NULL );
+	assert( id <= m_maxRegionId );
+
+	std::vector<Coord> fill;
+	r->boundary.fillInto( &fill );
+	std::vector<Coord>::const_iterator cell;
+	for( cell = fill.begin(); cell != fill.end(); ++cell )
+	{
+		// Replace with R_new.id
+		m_regionMap.valueAt( cell->x, cell->y ) = id;
+	}
+}
+
+
+void RmGlobalMap::finalize( bool fuse )
+{
+	if ( m_finalized ) return;
+
+	std::vector<Trajectory>::const_iterator ti;
+	for ( ti = m_trajectories.begin(); ti != m_trajectories.end(); ++ti ) {
+		if ( ti->currentMap == NULL ) continue;
+		addToRegionMap( ti->currentMap );
+		touch( ti->currentMap->bound() );
+	}
+	if ( fuse ) integrate();
+
+	m_finalized = true;
+	measureMemory();
+}
+
+
+float RmGlobalMap::fusedValueAt( int x, int y ) const
+{
+	if ( m_quantized ) {
+		return m_quantizedMap.inBounds( x, y ) ? 
+			RmUtility::dequantize( m_quantizedMap.valueAt( x, y ) ) : InitVal;
+	}
+	return inBounds( x, y ) ? valueAt( x, y ) : InitVal;
+}
+
+
+void RmGlobalMap::fusedMap( RmMutableCartesianGrid<float> &grid ) const
+{
+	if ( !m_quantized ) {
+		grid = *this;
+		return;
+	}
+
+	RmMutableCartesianGrid<float>( m_quantizedMap.bound(), m_quantizedMap.origin(), InitVal ).swap( grid );
+	for ( int row = 0; row < grid.height(); ++row ) 
+	{
+		const unsigned char *q = m_quantizedMap.rowAt( row );
+		float *pr = grid.rowAt( row );
+		for ( int col = 0; col < grid.width(); ++col ) pr[col] = RmUtility::dequantize( q[col] );
+	}
+}
+
+
+std::string RmGlobalMap::installNewMap( const SonarReading& wNewReading, int robot )
+{
+	// NOTE:  
+	// In this context, the "current" map is the map just built in its entirety but not yet
+	// convolved with the global map; the "new" map isn't created until after this current
+	// map has been relocalized and convolved, and a new map pose localization accomplished
+	// using newReading
+
+	// Given three consecutive local maps, A, B, and C, with A being the first map built:
+	// Pose A is neither localized prior to construction nor relocalized after construction
+	//		because there is no current or prior map data to localize against
+	// Pose B is localized prior to construction using map data from A, 
+	//		and relocalized after construction using its own data
+	// Pose C is processed in like manner to B, but in reference to B, and so on
+
+	// Only the robot's own maps are relocalized and localized against in sequence; those of 
+	// other robots contribute by way of the global map
+
+	char traceArgs[20];
+	sprintf( traceArgs, "\"robot\":%d", robot );
+	RmTrace::Scope trace( "installNewMap", traceArgs );
+
+	Trajectory &t = m_trajectories[robot];
+	std::string logString;
+
+	if ( t.currentMap != NULL )
+	{
+		RmPolygon dirtyRegion( t.currentMap->bound() );
+		BoundBox dirtyBound( t.currentMap->bound() );
+
+		//////
+		// Relocalize map just finished building (at t-1)
+
+		if ( m_settings->Localize && t.priorMap != NULL ) 
+		{
+			// NOTE: the current map will be non-null and the prior map null
+			// at the transition between maps A and B, as described above;
+			// The test for a prior map prevents a doomed attempt to relocalize map A
+
+			// Convolve local map into global map
+			addToRegionMap( t.currentMap );
+
+			// Get updated relocalized pose for local map
+			RmLocalMap &priorMap = *t.priorMap; // at transition between B and C, priorMap = A
+			Pose gLocPose = localizedPose( priorMap, t.wCurrentReading, robot );
+			Pose gOldPose = t.currentMap->pose().scaled( m_settings->CellSize );
+			gOldPose.theta = priorMap.pose().coord.scaled( m_settings->CellSize ).angleTo( gOldPose.coord );
+			Pose gPoseShift = gLocPose - gOldPose; // scaled
+
+			// Restore global map to pre-convolved state
+			removeFromRegionMap( t.currentMap );
+
+			// Shift local map by relocalized pose shift
+			t.gAccumShift += gPoseShift;
+			t.currentMap->reorientBy( gPoseShift.scaled( 1.0 / m_settings->CellSize ) );
+
+			// Expand dirty region to include shift
+			dirtyRegion.unionWith( RmPolygon( t.currentMap->bound() ) );
+			dirtyBound.unionWith( t.currentMap->bound() );
+
+			tracePoseShift( "relocalize", robot, gOldPose, gLocPose, gPoseShift, t.gAccumShift );
+		}	
+
+
+		//////
+		// Convolve newly finished map with global map
+
+		// Add to region map
+		addToRegionMap( t.currentMap );
+		logString += integrate( dirtyRegion, true );
+		touch( dirtyBound );
+
+
+		//////
+		// Localize new map based on map just finished
+
+		if ( m_settings->Localize ) 
+		{
+			// Find delta between selected pose of new and finished local map
+			// Shift local map pose by delta (heading?)
+			// calc angle between coords of current and new map
+
+			Pose gLocPose = localizedPose( *t.currentMap, wNewReading, robot );
+			Pose gPrePose( wNewReading.robotPose.scaled( m_settings->CellSize ) );
+			gPrePose.theta = t.currentMap->pose().coord.scaled( m_settings->CellSize ).angleTo( gPrePose.coord );
+			Pose gPoseShift = gLocPose - gPrePose;
+			t.gAccumShift += gPoseShift;
+
+			tracePoseShift( "localize", robot, gPrePose, gLocPose, gPoseShift, t.gAccumShift );
+		}
+	}
+
+
+	//////
+	// Create new map, beginning with sonar data just used
+
+	t.wCurrentReading = wNewReading;
+	t.wCurrentReading.robotPose = wNewReading.robotPose + t.gAccumShift.scaled( 1.0 / m_settings->CellSize );
+	// The prior map, against which the current map has been relocalized, is no longer needed
+	if ( m_settings->RetireMaps && t.priorMap != NULL ) retire( t.priorMap );
+	t.priorMap = t.currentMap;
+	m_maps.push_back( t.currentMap = newLocalMap( t.wCurrentReading.robotPose, t.priorMap ) );
+	m_checkpointPending = m_checkpointName != "";
+	measureMemory();
+
+	return logString;
+}
+
+
+void RmGlobalMap::integrate()
+{
+	RM_INSTRUMENT_TIMER( RmInstrument::Integrate );
+	RmTrace::Scope trace( "integrate" );
+
+	// Grow the fused map over the region map (which represents the entire global map) before
+	// any band is fused, such that no band resizes the grid beneath another
+	const BoundBox bound( m_regionMap.bound() );
+	if ( m_quantized ) {
+		m_quantizedMap.valueAt( bound.ul.x, bound.ul.y );
+		m_quantizedMap.valueAt( bound.lr.x, bound.lr.y );
+	}
+	else {
+		valueAt( bound.ul.x, bound.ul.y );
+		valueAt( bound.lr.x, bound.lr.y );
+	}
+
+	// Divide the rows into as many bands as there are threads, but no more than there are rows
+	const int rows = bound.ul.y - bound.lr.y + 1;
+	const int threads = m_settings->IntegrateThreads < 1 ? 1 : m_settings->IntegrateThreads;
+	const int bands = threads < rows ? threads : rows;
+
+	// Fuse all but the first band on threads of their own, and the first on this one
+	std::vector<FusedBand*> fusers;
+	int b;
+	for ( b = 1; b < bands; ++b ) {
+		fusers.push_back( new FusedBand( *this, BoundBox( bound.ul.x, 
+			bound.ul.y - b * rows / bands, bound.lr.x, bound.ul.y - (b + 1) * rows / bands + 1 ) ) );
+		fusers.back()->runAsync();
+	}
+
+	bool failed = false;
+	RmExceptions::Exception error;
+	try {
+		integrateRows( BoundBox( bound.ul.x, bound.ul.y, bound.lr.x, bound.ul.y - rows / bands + 1 ) );
+	}
+	catch ( RmExceptions::Exception e ) {
+		error = e;
+		failed = true;
+	}
+
+	for ( b = 0; b < static_cast<int>(fusers.size()); ++b ) {
+		fusers[b]->join();
+		if ( !failed && fusers[b]->failed() ) {
+			error = fusers[b]->error();
+			failed = true;
+		}
+		delete fusers[b];
+	}
+	if ( failed ) throw error;
+}
+
+
+void RmGlobalMap::integrateRows( const BoundBox &band )
+{
+	RmTrace::Scope trace( "integrateRows" );
+
+	const RmMutableCartesianGrid<RegionId> &regionMap = m_regionMap;
+	const RmMutableCartesianGrid<float> &retiredSums = m_retiredSums;
+	const RmMutableCartesianGrid<unsigned short> &retiredCounts = m_retiredCounts;
+	const RmGridView<const RegionId> regionView( regionMap.view( band ) );
+	const int width = regionView.width();
+	std::vector<float> sums( width );
+	std::vector<int> counts( width );
+
+	for ( int y = band.ul.y; y >= band.lr.y; --y )
+	{
+		const RegionId *regionRow = regionView.rowAt( y );
+		float *fusedRow = m_quantized ? NULL : view( BoundBox( band.ul.x, y, band.lr.x, y ) ).rowAt( y );
+		unsigned char *quantizedRow = !m_quantized ? NULL : 
+			m_quantizedMap.view( BoundBox( band.ul.x, y, band.lr.x, y ) ).rowAt( y );
+
+		// For each run of cells covered by the same region
+		int end;
+		for ( int begin = 0; begin < width; begin = end )
+		{
+			const RegionId rId = regionRow[begin];
+			for ( end = begin + 1; end < width && regionRow[end] == rId; ++end );
+			std::fill( sums.begin() + begin, sums.begin() + end, 0.0f );
+			std::fill( counts.begin() + begin, counts.begin() + end, 0 );
+
+			// Sum the non-empty probabilities of each local map assigned to the region, 
+			// one row of the map at a time, as per regionValueAt(), but without expanding those
+			// maps the run overhangs, whose cells beyond their bounds are empty
+			if ( rId != 0 )
+			{
+				std::map<RegionId,Region*>::const_iterator ri( m_regions.find( rId ) );
+				assert( ri != m_regions.end() );
+				const BoundBox run( band.ul.x + begin, y, band.ul.x + end - 1, y );
+
+				// Begin with the sums of those maps retired, which span the same cells
+				const RmGridView<const float> sumView( retiredSums.view( run ) );
+				if ( !sumView.empty() ) 
+				{
+					const RmGridView<const unsigned short> countView( retiredCounts.view( run ) );
+					const float *retiredSum = sumView.rowAt( y );
+					const unsigned short *retiredCount = countView.rowAt( y );
+					const int offset = sumView.bound().ul.x - band.ul.x;
+					for ( int c = 0; c < sumView.width(); ++c ) {
+						sums[offset + c] = retiredSum[c];
+						counts[offset + c] = retiredCount[c];
+					}
+				}
+
+				RmFlatSet<RmLocalMap*>::const_iterator mi;
+				for ( mi = (*ri).second->maps.begin(); mi != (*ri).second->maps.end(); ++mi )
+				{
+					const RmLocalMap *map = *mi;
+					if ( map->retired() ) continue;
+					const RmGridView<const float> mapView( map->view( run ) );
+					if ( mapView.empty() ) continue;
+
+					const float *pr = mapView.rowAt( y );
+					const int offset = mapView.bound().ul.x - band.ul.x;
+					float *sum = &sums[offset];
+					int *count = &counts[offset];
+					for ( int c = 0; c < mapView.width(); ++c ) {
+						if ( pr[c] != RmBayesCertaintyGrid::InitVal ) {
+							sum[c] += pr[c];
+							++count[c];
+						}
+					}
+				}
+			}
+
+			// Store the averages
+			for ( int c = begin; c < end; ++c ) 
+			{
+				const float gPr = counts[c] == 0 ? RmBayesCertaintyGrid::InitVal : sums[c] / counts[c];
+				if ( m_quantized ) quantizedRow[c] = RmUtility::quantize( gPr );
+				else fusedRow[c] = gPr;
+			}
+		}
+	}
+}
+
+
+
+const std::string RmGlobalMap::integrate( const RmPolygon &bound, bool retVal )
+{
+	RM_INSTRUMENT_TIMER( RmInstrument::Integrate );
+	RmTrace::Scope trace( "integrate" );
+
+	// get cells filling region
+	std::vector<Coord> fill;
+	bound.fillInto( &fill );
+
+	// create update string buffer
+	// format is "-xxx -yyy 0.dddd;"
+	char *buff = new char[(fill.size() * 17 + 1) * sizeof(char)];
+	char *buffPtr = buff;
+	*buffPtr = '\0';
+
+	// for each cell
+	std::vector<Coord>::const_iterator ci;
+	for ( ci = fill.begin(); ci != fill.end(); ++ci ) 
+	{
+		const float pr = convolvedValueAt( ci->x, ci->y );
+		setFusedValue( ci->x, ci->y, pr );
+		
+		// update log string by appending over previous terminating null
+		if ( retVal ) {
+			buffPtr += RmUtility::cellString( 
+				buffPtr, ci->x, ci->y, pr, m_settings->QuantizedStream );
+		}
+	}
+
+	// tack on local map update string
+	std::string updateString( buff );
+	delete[] buff;
+
+	return updateString;
+}
+
+
+float RmGlobalMap::liveValueAt( int x, int y ) const
+{
+	// The maps being built are not added to the region map until installed or finalized
+	if ( !m_finalized ) 
+	{
+		std::vector<Trajectory>::const_iterator ti;
+		for ( ti = m_trajectories.begin(); ti != m_trajectories.end(); ++ti ) 
+		{
+			if ( ti->currentMap == NULL || !ti->currentMap->inBounds( x, y ) ) continue;
+			const float pr = ti->currentMap->valueAt( x, y );
+			if ( pr != RmBayesCertaintyGrid::InitVal ) return pr;
+		}
+	}
+	return regionValueAt( x, y );
+}
+
+
+
+Pose RmGlobalMap::localizedPose( 
+	const RmLocalMap &priorMap, const SonarReading& wReading, int robot ) const
+{
+	RM_INSTRUMENT_TIMER( RmInstrument::LocalizedPose );
+	char traceArgs[20];
+	sprintf( traceArgs, "\"robot\":%d", robot );
+	RmTrace::Scope trace( "localizedPose", traceArgs );
+
+	// Note:  unscaled -> in   out -> scaled
+
+	const RmBayesSonarModel sonarModel( m_settings ); // used to calc Pr(Occ)
+	const Pose gPose( wReading.robotPose.scaled( m_settings->CellSize ) );
+
+	// Calculate probability distribution of pose using motion model
+	// Factors:  distance and degree of turns, where
+	//    height increases proportionally to distance traveled
+	//    width increases proportional to degrees turned
+	const int h = m_settings->MotionModel.MinHeight + 
+		priorMap.cumDistance() / m_settings->MotionModel.UnitDistance;
+	const int w = m_settings->MotionModel.MinWidth + 
+		priorMap.cumTurn() / m_settings->MotionModel.UnitTurn;
+	RmMutableCartesianGrid<float> gPoseDist( 0, 0, gPose.coord );
+	RmUtility::gaussGrid( gPoseDist, w, h, gPose.coord, gPose.theta, 
+		m_settings->MotionModel.GaussianSigma, m_settings->MotionModel.BendFactor );
+
+	// Begin the trace record of this localization, and dump its grids if due
+	RmLocalizationTrace::Record record;
+	const bool dump = m_localizationTrace != NULL && 
+		m_localizationTrace->beginLocalization( record );
+	std::ostream *log = dump ? &m_localizationTrace->dumpStream() : NULL;
+	record.robot = robot;
+	record.prior = gPose;
+	record.width = w;
+	record.height = h;
+	record.cumDistance = static_cast<float>(priorMap.cumDistance());
+	record.cumTurn = static_cast<float>(priorMap.cumTurn());
+
+	if ( dump ) {
+		*log << "\n\nLOCALIZATION " << record.localization << " robot " << robot 
+			<< "\nDimension: " << priorMap.width() << " x " << priorMap.height() << "\n";
+		*log << "SonarReading:\n" << wReading << "\n";
+		*log << "cumDistance(" << priorMap.cumDistance()
+			<< ") cumTurn(" << priorMap.cumTurn() << ") gPoseDist[" << w << "][" << h << "]\n";
+	}
+	
+	// The grids over pose below take the bound and origin of gPoseDist, but not its values,
+	// which would only be cleared
+	const BoundBox gPoseBound = gPoseDist.bound();
+	const float gPoseInit = gPoseDist.initValue();
+
+	// Histogram matrix over pose for tabulating selected poses for all sonars
+	RmMutableCartesianGrid<float> gPoseHist( gPoseBound, gPoseDist.origin(), gPoseInit );
+	int maxPoseHist = 0; // highest value in histogram matrix
+	
+	// Create pose selection matrix, reinitialized for each sonar
+	RmMutableCartesianGrid<float> gPoseSel( gPoseBound, gPoseDist.origin(), gPoseInit ); 
+		// convolves prOcc with gPoseDist
+	RmMutableCartesianGrid<float> gPoseObs; // tracks obstructions; dump use only
+	RmMutableCartesianGrid<float> gPoseOcc; // occ grid about range reading; dump use only
+	if ( dump ) {
+		RmMutableCartesianGrid<float>( gPoseBound, gPoseDist.origin(), gPoseInit ).swap( gPoseObs );
+		RmMutableCartesianGrid<float>( gPoseBound, gPoseDist.origin(), 0.5f ).swap( gPoseOcc );
+	}
+
+	// For each sonar
+	SonarReading wReadingCopy( wReading ); // _UNSCALED_LOCALIZATION copy to be modified
+	for ( int i = 0; i < RmPioneerController::NumSonars; ++i )
+	{
+		// Calc grid-based vector (direction and magnitude) for the range reading
+		wReadingCopy.sonarNumber = i;
+		wReadingCopy.distance = wReadingCopy.all[i];
+		MappedSonarReading gMR( RmPioneerController::rangeReading( wReadingCopy ) );
+		gMR.scale( m_settings->CellSize ); // rangeReading() is best used with unscaled data
+		RmLocalizationTrace::SonarRecord &sonarRecord = record.sonars[i];
+		sonarRecord.distance = wReadingCopy.distance;
+		if ( dump ) *log << "\n" << gMR;
+
+		// Skip out-of-range readings
+		// (placed after calculation of mr so mr log entry can first be entered)
+		if ( wReadingCopy.distance > RmPioneerController::SonarRange ) {
+			if ( dump ) *log << "Skipping out of range reading.\n";
+			continue;
+		}
+		sonarRecord.inRange = true;
+
+
+		// Init pose selection and dump matrices
+		gPoseSel.clear();
+		if ( dump ) {
+			gPoseObs.clear();
+			gPoseOcc.setOrigin( gMR.objectCoord );
+			gPoseOcc.clear();
+		}
+
+		// For each cell in pose distribution matrix
+		float maxPoseSel = 0.0; // highest value in pose selection matrix
+		int unobstructed = 0; // number of poses from which the reading is unobstructed
+		const Coord gSonarShift = gMR.sonarPose.coord - gPose.coord;
+		const Coord gObjectShift = gMR.objectCoord - gMR.sonarPose.coord;
+		for ( int gY = gPoseBound.ul.y; gY >= gPoseBound.lr.y; --gY ) {
+			for ( int gX = gPoseBound.ul.x; gX <= gPoseBound.lr.x; ++gX ) 
+			{
+				// If cell at terminal end of range reading vector is unobstructed, 
+				// record pose selection likelihood
+				const Coord gStart = Coord( gX, gY ) + gSonarShift;
+				const Coord gEnd = gStart + gObjectShift;
+				if ( !obstructionBetween( gStart, gEnd, robot ) ) 
+				{
+					++unobstructed;
+					if ( dump ) gPoseObs[gX][gY] = 1.0f;
+
+					// get prior prob of occupied from global map
+					const float priorPrOcc = convolvedValueAt( gEnd.x, gEnd.y );
+
+					// get new prob of occupied for this pose dist cell
+					const float prOcc = sonarModel.prOccupiedGivenSn( 
+						priorPrOcc, RmBayesSonarModel::RegionI, gMR.reading.distance );
+					if ( dump ) gPoseOcc[gEnd.x][gEnd.y] = prOcc;
+
+					const float s = gPoseSel[gX][gY] = prOcc * gPoseDist[gX][gY];
+					
+					if ( s > maxPoseSel ) maxPoseSel = s;
+				}
+			}
+		}
+		sonarRecord.unobstructed = unobstructed;
+		sonarRecord.bestScore = maxPoseSel;
+
+		// Increment in pose histogram the cells corresponding to 
+		// those in pose selection matrix with highest prob
+		if ( maxPoseSel > 0 ) {
+			for ( gY = gPoseSel.bound().ul.y; gY >= gPoseSel.bound().lr.y; --gY ) {
+				for ( int gX = gPoseSel.bound().ul.x; gX <= gPoseSel.bound().lr.x; ++gX ) 
+				{
+					if ( gPoseSel[gX][gY] == maxPoseSel ) {
+						const int h = ++gPoseHist[gX][gY]; // store so don't have to call [][] twice
+						if ( h > maxPoseHist ) maxPoseHist = h;
+						++sonarRecord.selected;
+					}
+				}
+			}
+		}
+
+		if ( dump ) {
+			// Window of the global map about range reading, in place
+			const Coord gGloShift( gMR.objectCoord - gPoseDist.origin() );
+			const RmGridView<const float> gPoseGlo( 
+				view( gPoseDist.bound() + BoundBox( gGloShift, gGloShift ) ) );
+			*log << "PrOcc at object = " << gPoseOcc[gMR.objectCoord.x][gMR.objectCoord.y] 
+				<< ", prior = " << fusedValueAt( gMR.objectCoord.x, gMR.objectCoord.y ) << "\n";
+			*log << "\nposeDistribution over Robot Pose, by local map, " << "Bound: " 
+				<< gPoseDist.bound() << " Origin: " << gPoseDist.origin() << "\n" << gPoseDist;
+			*log << "\nglobalMap over Object, by sonar, " << "Bound: " << gPoseGlo.bound() 
+				<< " Origin: " << gMR.objectCoord << "\n" << gPoseGlo;
+			*log << "\nposeObstructions over Object, by sonar, 0 = obstructed "
+				<< "(path from Robot Pose to Object)\n" << gPoseObs;
+			*log << "\nprOcc over Object, by unobstructed sonar\n" << gPoseOcc;
+			*log << "\nposeSelelections over Object, by sonar (gPoseDist * prOcc * gPoseObs)\n" 
+				<< gPoseSel << "\n";
+			*log << "poseHistogram over Robot Pose, by local map (max gPoseSel)\n" 
+				<< gPoseHist << "\n";
+			*log << "===== End Sonar " << i << "\n";
+		}
+	}
+
+	// If no poses were selected, all sonar readings were out of range
+	// Can only return original pose
+	if ( maxPoseHist == 0 ) {
+		if ( dump ) *log << "\nNo sonar readings in range!\n\n";
+		Pose gLocPose( wReading.robotPose.scaled( m_settings->CellSize ) );
+		gLocPose.theta = priorMap.pose().coord.angleTo( wReading.robotPose.coord );
+		record.chosen = gLocPose;
+		traceLocalization( record );
+		return gLocPose;
+	}
+	record.histogramPeak = maxPoseHist;
+
+	// Get poses with max pose histogram value and record corresponding max post dist value
+	std::vector<Coord> gSelectedPoses;
+	float maxSelPoseDist = 0.0f;
+	for ( int gY = gPoseHist.bound().ul.y; gY >= gPoseHist.bound().lr.y; --gY ) {
+		for ( int gX = gPoseHist.bound().ul.x; gX <= gPoseHist.bound().lr.x; ++gX ) 
+		{
+			if ( gPoseHist[gX][gY] == maxPoseHist ) {
+				gSelectedPoses.push_back( Coord( gX, gY ) );
+				const float pd = gPoseDist[gX][gY]; // store so don't have to call [][] twice
+				if ( pd > maxSelPoseDist ) maxSelPoseDist = pd;
+			}
+		}
+	}
+	record.candidates = gSelectedPoses.size();
+
+	// Filter all but those with the highest underlying maximum pose distribution,
+	// compacting those retained in place rather than erasing each of the rest
+	if ( dump ) *log << "maxSelPoseDist = " << maxSelPoseDist << "\n";
+	std::vector<Coord>::iterator gSelectedPose;
+	std::vector<Coord>::iterator gRetainedPose = gSelectedPoses.begin();
+	for ( gSelectedPose = gSelectedPoses.begin(); gSelectedPose < gSelectedPoses.end(); ++gSelectedPose )
+	{
+		const Coord gc( *gSelectedPose );
+		if ( dump ) *log << gc << ":" << gPoseDist[gc.x][gc.y] << " ";
+		if ( gPoseDist[gc.x][gc.y] < maxSelPoseDist ) {
+			if ( dump ) *log << "erased\n";
+		}
+		else {
+			*gRetainedPose++ = gc;
+			if ( dump ) *log << "retained\n";
+		}
+	}
+	gSelectedPoses.erase( gRetainedPose, gSelectedPoses.end() );
+	record.retained = gSelectedPoses.size();
+
+	// If more than one selected pose, take the first (for now)
+	if ( gSelectedPoses.size() != 1 ) 
+	{
+		if ( dump ) {
+			*log << "candidate poses: ";
+			for ( gSelectedPose = gSelectedPoses.begin(); gSelectedPose < gSelectedPoses.end(); 
+				++gSelectedPose )
+			{
+				*log << *gSelectedPose << " ";
+			}
+			*log << "\n";
+		}
+		char buff[50];
+		sprintf( buff, "%d poses remain in filtered selection matrix", gSelectedPoses.size() );
+		RmExceptions::Exception e( NULL, "RmGlobalMap::localizedPose()", buff );
+
+		// This isn't an "error" so much as it is a condition;
+		// Notify and keep going
+		std::cerr << e;
+
+		// Additional filters for narrowing down selections:
+		// - highest avg of surrounding cells, etc.
+		// - closes proximity to original pose
+	}
+
+	Coord gSelCoord( gSelectedPoses.front() );
+
+	// Return the selected position and angle to that pos from current map's starting position
+	Pose gLocPose( gSelCoord, priorMap.pose().coord.scaled( m_settings->CellSize ).angleTo( gSelCoord ) );
+
+	if ( dump ) *log << "selPose: " << gLocPose << std::endl;
+	record.chosen = gLocPose;
+	traceLocalization( record );
+
+	return gLocPose;
+}
+
+
+void RmGlobalMap::traceLocalization( const RmLocalizationTrace::Record &record ) const
+{
+	if ( m_localizationTrace == NULL ) return;
+
+	// A diagnostic that cannot be recorded is not reason to abandon mapping
+	try {
+		m_localizationTrace->write( record );
+	}
+	catch( RmExceptions::IOException e ) {
+		std::cerr << e << "\n";
+	}
+}
+
+
+void RmGlobalMap::measureMemory()
+{
+	MemoryUsage m;
+
+	std::vector<RmLocalMap*>::const_iterator map;
+	for ( map = m_maps.begin(); map != m_maps.end(); ++map ) 
+	{
+		const unsigned long grid = sizeof(RmLocalMap) + (*map)->allocatedBytes();
+		m.localGrids += grid;
+		if ( grid > m.largestLocalGrid ) m.largestLocalGrid = grid;
+		m.sonarHistories += (*map)->historyBytes();
+		if ( (*map)->retired() ) ++m.retiredMaps;
+	}
+	m.localGrids += m_maps.capacity() * sizeof(RmLocalMap*) + 
+		m_mapPool.allocatedBytes() - m_mapPool.live() * sizeof(RmLocalMap);
+	m.localMaps = static_cast<int>(m_maps.size());
+
+	m.regions = m_regionMap.allocatedBytes() + m_regionMaps.allocatedBytes() + 
+		m_regionPool.allocatedBytes() + m_usedRegionIds.size() * sizeof(RegionId);
+	std::map<RegionId,Region*>::const_iterator region;
+	for ( region = m_regions.begin(); region != m_regions.end(); ++region ) 
+	{
+		const Region *r = (*region).second;
+		m.regions += treeNodeBytes( sizeof(std::pair<const RegionId,Region*>) ) + 
+			r->boundary.allocatedBytes() + r->maps.allocatedBytes();
+	}
+	m.regionCount = static_cast<int>(m_regions.size());
+
+	m.globalGrid = allocatedBytes() + m_quantizedMap.allocatedBytes() + 
+		m_retiredSums.allocatedBytes() + m_retiredCounts.allocatedBytes() + m_tileVersions.size() * 
+		treeNodeBytes( sizeof(std::pair<const std::pair<int,int>,unsigned long>) );
+
+	m.total = m.localGrids + m.sonarHistories + m.regions + m.globalGrid;
+
+	m_memoryMutex.lock();
+	m_memoryUsage = m;
+	MemoryUsage &peak = m_memoryPeak;
+	if ( m.localGrids > peak.localGrids ) peak.localGrids = m.localGrids;
+	if ( m.largestLocalGrid > peak.largestLocalGrid ) peak.largestLocalGrid = m.largestLocalGrid;
+	if ( m.sonarHistories > peak.sonarHistories ) peak.sonarHistories = m.sonarHistories;
+	if ( m.regions > peak.regions ) peak.regions = m.regions;
+	if ( m.globalGrid > peak.globalGrid ) peak.globalGrid = m.globalGrid;
+	if ( m.total > peak.total ) peak.total = m.total;
+	if ( m.localMaps > peak.localMaps ) peak.localMaps = m.localMaps;
+	if ( m.retiredMaps > peak.retiredMaps ) peak.retiredMaps = m.retiredMaps;
+	if ( m.regionCount > peak.regionCount ) peak.regionCount = m.regionCount;
+	m_memoryMutex.unlock();
+}
+
+
+RmGlobalMap::MemoryUsage RmGlobalMap::memoryPeak() const
+{
+	m_memoryMutex.lock();
+	const MemoryUsage peak( m_memoryPeak );
+	m_memoryMutex.unlock();
+	return peak;
+}
+
+
+std::string RmGlobalMap::memoryReport() const
+{
+	std::ostringstream os;
+	putMemory( os );
+	return os.str();
+}
+
+
+RmGlobalMap::MemoryUsage RmGlobalMap::memoryUsage() const
+{
+	m_memoryMutex.lock();
+	const MemoryUsage usage( m_memoryUsage );
+	m_memoryMutex.unlock();
+	return usage;
+}
+
+
+RmGlobalMap::Region* RmGlobalMap::newRegion( const RmPolygon &bound )
+{
+	RegionId id;
+	if ( m_usedRegionIds.empty() ) id = ++m_maxRegionId;
+	else {
+		id = m_usedRegionIds.front();
+		m_usedRegionIds.pop();
+	}
+
+	Region *r = new (m_regionPool.allocate()) Region( id, bound );
+	m_regions[id] = r;
+	RM_INSTRUMENT_COUNT( RmInstrument::RegionsCreated, 1 );
+	
+	fillRegionMap( r, id );
+
+	return r;
+}
+
+
+bool RmGlobalMap::obstructionBetween( const Coord& gStart, const Coord& gEnd, int robot ) const
+{
+	// Reasons for differences from original:
+	// - Checking for obstruction to gcObject rather than f (in RmBayesCertaintyGrid obstruction check)
+	// - Not processing last point in linePointList
+	// - Checking global map
+
+	const RmLocalMap *currentMap = 
+		robot >= 0 && robot < robots() ? m_trajectories[robot].currentMap : NULL;
+
+	bool obstructed = false;
+	float prGlobal = 0.0f;
+	float prLocal = currentMap == NULL ? -1.0f : 0.0f;
+	const float prObstr = m_settings->ObstructedCertainty;
+	RM_INSTRUMENT_COUNT( RmInstrument::RaysCast, 1 );
+
+	ScopedDrawContext draw;
+	for ( PointList* gLinePointList = FillLine( &draw, gStart.x, gStart.y, gEnd.x, gEnd.y ); // [start..end)
+		gLinePointList; gLinePointList = gLinePointList->next )
+	{
+		const int gX = gLinePointList->point.X;
+		const int gY = gLinePointList->point.Y;
+
+		// These tests short-circuit further testing of either local or global bounds 
+		// once it has been determined one of them has been exceeded
+		int oneInBounds = 0;
+		if ( prGlobal != -1.0f ) {
+			if ( m_regionMap.inBounds( gX, gY ) ) {
+				prGlobal = convolvedValueAt( gX, gY );
+				++oneInBounds;
+			}
+			else prGlobal = -1.0f;
+		}
+		if ( prLocal != -1.0f ) {
+			if ( currentMap->inBounds( gX, gY ) ) {
+				prLocal = currentMap->valueAt( gX, gY );
+				++oneInBounds;
+			}
+			else prLocal = -1.0f;
+		}
+
+		// This test short-circuits all future testing if neither one are in-bounds
+		if ( !oneInBounds ) 
+			break;
+
+		if ( prLocal >= prObstr || prGlobal >= prObstr )
+		{
+			obstructed = true;
+			break;
+		}
+	}
+
+	return obstructed;
+}
+
+
+std::ostream& RmGlobalMap::put( std::ostream& os ) const
+{ 
+	m_settings->put( os, "% " );
+
+	if ( !m_quantized ) return RmBayesCertaintyGrid::put( os );
+
+	RmMutableCartesianGrid<float> fused;
+	fusedMap( fused );
+	return fused.put( os );
+}
+
+
+std::ostream& RmGlobalMap::putMemory( std::ostream &os ) const
+{
+	const MemoryUsage m( memoryUsage() );
+	const MemoryUsage peak( memoryPeak() );
+
+	char buff[80];
+	sprintf( buff, "%-20s %12s %12s\n", "memory", "current KB", "peak KB" );
+	os << buff;
+	sprintf( buff, "%-20s %12.1f %12.1f\n", "local map grids", 
+		m.localGrids / 1024.0, peak.localGrids / 1024.0 );
+	os << buff;
+	sprintf( buff, "%-20s %12.1f %12.1f\n", "  largest", 
+		m.largestLocalGrid / 1024.0, peak.largestLocalGrid / 1024.0 );
+	os << buff;
+	sprintf( buff, "%-20s %12.1f %12.1f\n", "sonar histories", 
+		m.sonarHistories / 1024.0, peak.sonarHistories / 1024.0 );
+	os << buff;
+	sprintf( buff, "%-20s %12.1f %12.1f\n", "regions", m.regions / 1024.0, peak.regions / 1024.0 );
+	os << buff;
+	sprintf( buff, "%-20s %12.1f %12.1f\n", "global grid", 
+		m.globalGrid / 1024.0, peak.globalGrid / 1024.0 );
+	os << buff;
+	sprintf( buff, "%-20s %12.1f %12.1f\n", "total", m.total / 1024.0, peak.total / 1024.0 );
+	os << buff;
+	sprintf( buff, "%-20s %12d %12d\n", "local maps", m.localMaps, peak.localMaps );
+	os << buff;
+	sprintf( buff, "%-20s %12d %12d\n", "  retired", m.retiredMaps, peak.retiredMaps );
+	os << buff;
+	sprintf( buff, "%-20s %12d %12d\n", "regions (count)", m.regionCount, peak.regionCount );
+	os << buff;
+
+	return os;
+}
+
+
+void RmGlobalMap::read( std::istream &is )
+{
+	static const char *signature_ = "RmGlobalMap::read()";
+
+	empty();
+
+	try 
+	{
+		const int version = RmBinaryIO::readHeader( is, SnapshotMagic );
+		if ( version != SnapshotVersion ) {
+			throw RmExceptions::IOException( signature_, "Unsupported snapshot version" );
+		}
+
+		int cellSize;
+		RmBinaryIO::read( is, cellSize );
+		if ( cellSize != m_settings->CellSize ) {
+			throw InvalidStateException( signature_, "Snapshot cell size does not match settings" );
+		}
+
+		// Session state
+		char finalized;
+		RmBinaryIO::read( is, finalized );
+		m_finalized = finalized != 0;
+
+		// Local maps, in order of creation
+		int numMaps;
+		RmBinaryIO::read( is, numMaps );
+		if ( numMaps < 0 ) throw RmExceptions::IOException( signature_, "Invalid local map count" );
+		for ( int i = 0; i < numMaps; ++i ) {
+			m_maps.push_back( newLocalMap() );
+			m_maps.back()->read( is );
+		}
+
+		// Trajectories, with local maps identified by their position in the collection
+		int numTrajectories;
+		RmBinaryIO::read( is, numTrajectories );
+		if ( numTrajectories < 0 ) {
+			throw RmExceptions::IOException( signature_, "Invalid trajectory count" );
+		}
+		m_trajectories.resize( numTrajectories );
+		std::vector<Trajectory>::iterator ti;
+		for ( ti = m_trajectories.begin(); ti != m_trajectories.end(); ++ti )
+		{
+			char newMap;
+			int currentMap, priorMap;
+			RmBinaryIO::read( is, ti->wDistance );
+			RmBinaryIO::read( is, ti->gAccumShift );
+			RmBinaryIO::read( is, newMap );
+			RmBinaryIO::read( is, ti->wLastPos );
+			RmBinaryIO::read( is, ti->wCurrentReading );
+			RmBinaryIO::read( is, currentMap );
+			RmBinaryIO::read( is, priorMap );
+			RmBinaryIO::read( is, ti->resumeSweep );
+			if ( currentMap < -1 || currentMap >= numMaps || priorMap < -1 || priorMap >= numMaps ) {
+				throw RmExceptions::IOException( signature_, "Invalid current local map" );
+			}
+			ti->newMap = newMap != 0;
+			ti->gRobotPose = ti->wCurrentReading.robotPose.scaled( m_settings->CellSize );
+			ti->currentMap = currentMap == -1 ? NULL : m_maps[currentMap];
+			ti->priorMap = priorMap == -1 ? NULL : m_maps[priorMap];
+		}
+
+		// Every map but those being built has been added to the region map
+		std::set<RmLocalMap*> currentMaps;
+		for ( ti = m_trajectories.begin(); ti != m_trajectories.end(); ++ti ) {
+			if ( !m_finalized ) currentMaps.insert( ti->currentMap );
+		}
+		std::vector<RmLocalMap*>::const_iterator mi;
+		for ( mi = m_maps.begin(); mi != m_maps.end(); ++mi ) {
+			if ( currentMaps.count( *mi ) == 0 ) m_regionMaps.insert( *mi );
+		}
+
+		// Regions, with local maps identified by their position in the collection
+		m_regionMap.read( is );
+		RmBinaryIO::read( is, m_maxRegionId );
+		int numRegions;
+		RmBinaryIO::read( is, numRegions );
+		if ( numRegions < 0 ) throw RmExceptions::IOException( signature_, "Invalid region count" );
+		for ( int r = 0; r < numRegions; ++r )
+		{
+			RegionId id;
+			RmBinaryIO::read( is, id );
+			Region *region = new (m_regionPool.allocate()) Region( id, RmPolygon( BoundBox() ) );
+			m_regions[id] = region;
+			region->boundary.read( is );
+
+			int numRegionMaps;
+			RmBinaryIO::read( is, numRegionMaps );
+			for ( int m = 0; m < numRegionMaps; ++m ) {
+				int mapIndex;
+				RmBinaryIO::read( is, mapIndex );
+				if ( mapIndex < 0 || mapIndex >= numMaps ) {
+					throw RmExceptions::IOException( signature_, "Invalid region local map" );
+				}
+				region->maps.insert( m_maps[mapIndex] );
+			}
+		}
+		int numUsedIds;
+		RmBinaryIO::read( is, numUsedIds );
+		for ( int u = 0; u < numUsedIds; ++u ) {
+			RegionId id;
+			RmBinaryIO::read( is, id );
+			m_usedRegionIds.push( id );
+		}
+
+		// Global map
+		char quantized;
+		RmMutableCartesianGrid<float>::read( is );
+		RmBinaryIO::read( is, quantized );
+		m_quantized = quantized != 0;
+		m_quantizedMap.read( is );
+
+		// Running sums of retired local maps
+		m_retiredSums.read( is );
+		m_retiredCounts.read( is );
+		if ( m_retiredSums.bound().ul != m_retiredCounts.bound().ul || 
+			m_retiredSums.bound().lr != m_retiredCounts.bound().lr ) 
+		{
+			throw RmExceptions::IOException( signature_, "Inconsistent retired map sums" );
+		}
+
+		// Every mapped tile has changed since the reset that began the restore
+		touch( m_regionMap.bound() );
+		for ( ti = m_trajectories.begin(); ti != m_trajectories.end(); ++ti ) {
+			if ( ti->currentMap != NULL ) touch( ti->currentMap->bound() );
+		}
+	}
+	catch ( RmExceptions::Exception ) {
+		empty();
+		throw;
+	}
+
+	measureMemory();
+}
+
+
+float RmGlobalMap::regionValueAt( int x, int y ) const
+{
+	RegionId rId; // region id
+
+	// If the requested cell is not covered by a region, return the default value
+	if ( !m_regionMap.inBounds( x, y ) || (rId = m_regionMap[x][y]) == 0 ) {
+		return RmBayesCertaintyGrid::InitVal;
+	}
+
+	// Get the region covering the cell
+	std::map<RegionId,Region*>::const_iterator ri( m_regions.find( rId ) ); // region iterator
+	assert( ri != m_regions.end() );
+	Region *r = (*ri).second;
+
+	// Sum non-empty probabilities for each local map assigned to the region, beginning with
+	// the sums of those retired
+	float gPr = 0.0f; // global map prior probability
+	int cnt = 0;
+	if ( m_retiredCounts.inBounds( x, y ) ) {
+		gPr = m_retiredSums.valueAt( x, y );
+		cnt = m_retiredCounts.valueAt( x, y );
+	}
+	RmFlatSet<RmLocalMap*>::const_iterator mi; // map iterator
+	for ( mi = r->maps.begin(); mi != r->maps.end(); ++mi )
+	{
+		if ( (*mi)->retired() ) continue;
+
+		// Convolve values
+		float pr = (*mi)->valueAt( x, y );
+		if ( pr != RmBayesCertaintyGrid::InitVal ) {
+			gPr += pr;
+			++cnt;
+		}
+	}
+	gPr = cnt == 0 ? RmBayesCertaintyGrid::InitVal : gPr / cnt;
+
+	return gPr;
+}
+
+
+void RmGlobalMap::removeFromRegionMap( RmLocalMap *map )
+{
+	assert( map != NULL );
+
+	m_regionMaps.erase( map );
+
+	// Set up tracking of processed regions
+	RmFlatSet<RegionId> regionsProcessed;
+	regionsProcessed.insert( 0 ); // non-region has id of 0, which is treated as processed
+
+	// For each cell within the map's bounds (with explicit inclusion of n/e borders)
+	RmPolygon bo( map->bound().expandBy( 1, 0, 1, 0 ) );
+	std::vector<Coord> fill;
+	bo.fillInto( &fill );
+	std::vector<Coord>::const_iterator ci;
+	for ( ci = fill.begin(); ci != fill.end(); ++ci ) 
+	{
+		// For regions not already processed
+		const RegionId regionId = m_regionMap.valueAt( ci->x, ci->y );
+		if ( regionsProcessed.count( regionId ) == 0 ) 
+		{
+			// Remove the map from the region
+			Region *r = m_regions[regionId];
+			r->maps.erase( map );
+
+			// If no maps cover the region any longer, delete it
+			if ( r->maps.size() == 0 ) deleteRegion( &r );
+
+			// Mark region as processed
+			regionsProcessed.insert( regionId );
+		}
+	}
+}
+
+
+void RmGlobalMap::restore( const char *filename )
+{
+	std::ifstream ifs( filename, std::ios::in | std::ios::binary );
+	if ( !ifs ) {
+		throw RmExceptions::IOException( "RmGlobalMap::restore()", "Unable to open snapshot file" );
+	}
+	read( ifs );
+}
+
+
+void RmGlobalMap::retire( RmLocalMap *map )
+{
+	RmTrace::Scope trace( "retire" );
+
+	assert( map != NULL && m_regionMaps.count( map ) > 0 );
+	if ( map->retired() ) return;
+
+	// Spill the map before its grid and history are released
+	if ( m_settings->RetiredMapSpillName != "" ) 
+	{
+		if ( !m_retiredSpill.is_open() ) {
+			const std::string spillName( m_settings->RetiredMapSpillName + ".lms" );
+			m_retiredSpill.open( spillName.c_str(), std::ios::out | std::ios::binary );
+			if ( m_retiredSpill ) RmBinaryIO::writeHeader( m_retiredSpill, SpillMagic, SpillVersion );
+		}
+		const int index = static_cast<int>(
+			std::find( m_maps.begin(), m_maps.end(), map ) - m_maps.begin() );
+		RmBinaryIO::write( m_retiredSpill, index );
+		map->write( m_retiredSpill );
+		m_retiredSpill.flush();
+
+		// Losing the spill is no reason to abandon mapping, nor to hold on to the map
+		if ( !m_retiredSpill ) {
+			std::cerr << IOException( "RmGlobalMap::retire()", "Unable to spill retired local map" ) 
+				<< "\n";
+		}
+	}
+
+	// Grow the running sums over the map, then add each of its non-empty probabilities over
+	// those regions to which it contributes, as per regionValueAt()
+	const BoundBox bound( map->bound() );
+	m_retiredSums.valueAt( bound.ul.x, bound.ul.y );
+	m_retiredSums.valueAt( bound.lr.x, bound.lr.y );
+	m_retiredCounts.valueAt( bound.ul.x, bound.ul.y );
+	m_retiredCounts.valueAt( bound.lr.x, bound.lr.y );
+
+	const RmLocalMap &retiring = *map;
+	const RmMutableCartesianGrid<RegionId> &regionMap = m_regionMap;
+	const RmGridView<const float> mapView( retiring.view( bound ) );
+	const RmGridView<float> sumView( m_retiredSums.view( bound ) );
+	const RmGridView<unsigned short> countView( m_retiredCounts.view( bound ) );
+	RegionId rId = 0;
+	bool covered = false; // whether region rId is covered by the map
+	for ( int y = bound.ul.y; y >= bound.lr.y; --y )
+	{
+		const float *pr = mapView.rowAt( y );
+		float *sum = sumView.rowAt( y );
+		unsigned short *count = countView.rowAt( y );
+		for ( int c = 0; c < mapView.width(); ++c ) 
+		{
+			if ( pr[c] == RmBayesCertaintyGrid::InitVal ) continue;
+
+			const int x = bound.ul.x + c;
+			const RegionId id = regionMap.inBounds( x, y ) ? regionMap.valueAt( x, y ) : 0;
+			if ( id != rId ) {
+				rId = id;
+				std::map<RegionId,Region*>::const_iterator ri( m_regions.find( rId ) );
+				covered = ri != m_regions.end() && (*ri).second->maps.count( map ) > 0;
+			}
+			if ( covered ) {
+				sum[c] += pr[c];
+				++count[c];
+			}
+		}
+	}
+
+	map->retire();
+}
+
+
+int RmGlobalMap::resumeSweep( int robot ) const
+{
+	return robot >= 0 && robot < robots() ? m_trajectories[robot].resumeSweep : -1;
+}
+
+
+Pose RmGlobalMap::robotPose( int robot ) const
+{
+	return robot >= 0 && robot < robots() ? m_trajectories[robot].gRobotPose : Pose();
+}
+
+
+void RmGlobalMap::save( const char *filename ) const
+{
+	static const char *signature_ = "RmGlobalMap::save()";
+
+	std::string tempName( filename );
+	tempName.append( ".tmp" );
+
+	std::ofstream ofs( tempName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+	if ( !ofs ) throw RmExceptions::IOException( signature_, "Unable to open snapshot file for write" );
+	write( ofs );
+	ofs.close();
+	if ( ofs.fail() ) throw RmExceptions::IOException( signature_, "Unable to write snapshot file" );
+
+	// Replace the prior snapshot only once the new one is complete, in a single step such
+	// that the named file holds one snapshot or the other throughout
+	#ifdef WIN32
+	const bool replaced = MoveFileEx( tempName.c_str(), filename, 
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+	#else
+	const bool replaced = rename( tempName.c_str(), filename ) == 0; // atomic under POSIX
+	#endif
+	if ( !replaced ) {
+		throw RmExceptions::IOException( signature_, "Unable to replace snapshot file" );
+	}
+}
+
+
+void RmGlobalMap::setResumeSweep( int robot, int sweep )
+{
+	if ( robot >= 0 && robot < robots() ) m_trajectories[robot].resumeSweep = sweep;
+}
+
+
+BoundBox RmGlobalMap::tileBound( const Coord &tile )
+{
+	const int x = tile.x * VersionTileSize;
+	const int y = tile.y * VersionTileSize;
+	return BoundBox( x, y + VersionTileSize - 1, x + VersionTileSize - 1, y );
+}
+
+
+void RmGlobalMap::touch( const BoundBox &bound )
+{
+	if ( bound.ul.x > bound.lr.x || bound.ul.y < bound.lr.y ) return;
+
+	// Tile indices are rounded toward negative infinity so that tiles never straddle an axis
+	const int n = VersionTileSize;
+	const int west = bound.ul.x >= 0 ? bound.ul.x / n : -((n - 1 - bound.ul.x) / n);
+	const int east = bound.lr.x >= 0 ? bound.lr.x / n : -((n - 1 - bound.lr.x) / n);
+	const int south = bound.lr.y >= 0 ? bound.lr.y / n : -((n - 1 - bound.lr.y) / n);
+	const int north = bound.ul.y >= 0 ? bound.ul.y / n : -((n - 1 - bound.ul.y) / n);
+
+	++m_version;
+	for ( int ty = south; ty <= north; ++ty ) {
+		for ( int tx = west; tx <= east; ++tx ) m_tileVersions[std::make_pair( ty, tx )] = m_version;
+	}
+}
+
+
+const std::string RmGlobalMap::update( const SonarReading& wReading, int robot )
+{
+	if ( robot < 0 ) {
+		throw InvalidParameterException( "RmGlobalMap::update()", "Robot number may not be negative" );
+	}
+	if ( m_finalized ) return "";
+
+	// Begin the robot's trajectory with its first reading
+	if ( robot >= robots() ) m_trajectories.resize( robot + 1 );
+	Trajectory &t = m_trajectories[robot];
+
+	// Accummulate distance traveled for current map
+	Coord wCurrPos = wReading.robotPose.coord;
+	if ( !t.newMap ) t.wDistance += t.wLastPos.distanceFrom( wCurrPos );
+	t.wLastPos = wCurrPos;
+	t.newMap = false;
+
+	// Initialize new map on first run
+	// Would do in constructor but would have to assume origin pose of Pose()
+	std::string newMapString;
+	if ( t.currentMap == NULL )
+	{
+		newMapString = installNewMap( wReading, robot );
+	}
+
+	// If total distance exceeds prescribed amount
+	else if ( m_settings->LocalMapDistance > 0 && t.wDistance > m_settings->LocalMapDistance )
+	{
+		// Create new map
+		// Add to map collection
+		// Set current local map to new map
+		if ( m_settings->Localize ) newMapString = installNewMap( wReading, robot );
+		else installNewMap( wReading, robot );
+
+		t.newMap = true;
+		t.wDistance = 0.0;
+	}
+
+	// Modify reading by pose shift updated in installNewMap()
+	SonarReading wShiftedReading( wReading );
+	wShiftedReading.robotPose += t.gAccumShift.scaled( 1.0 / m_settings->CellSize );
+
+	// Prepare default pose string
+	Pose gRobotPose( wShiftedReading.robotPose.scaled( m_settings->CellSize ) );
+	t.gRobotPose = gRobotPose;
+	char logPose[30];
+	sprintf( logPose, "%d %d %d %d %d\n", gRobotPose.coord.x, gRobotPose.coord.y, 
+		static_cast<int>(wReading.robotPose.theta), wReading.sonarNumber, wReading.distance );
+
+	// Skip obstructed readings (cell and axis models only)
+	const RmUtility::MappedSonarReading wMR = RmPioneerController::rangeReading( wShiftedReading );
+	if ( m_settings->SonarModel != RmUtility::Cone && m_settings->IgnoreObstructed && 
+		obstructionBetween( gridCoord( wMR.sonarPose.coord ), gridCoord( wMR.objectCoord ), robot ) ) {
+		return "";
+	}
+
+	// Pass reading on to current local map
+	std::string logString = t.currentMap->update( wMR );
+	if ( logString.length() > 0 ) touch( t.currentMap->updateBound() );
+
+	// If update string is empty (due to out-of-range or disabled sonar)
+	// but we have a new map update string, include log line 1 for return to viewer
+	if ( logString.length() == 0 && newMapString.length() > 0 ) logString = logPose;
+	else logString = logString.substr( 0, logString.length() - 2 );
+	logString += newMapString;
+
+	return logString;
+}
+
+
+void RmGlobalMap::write( std::ostream &os ) const
+{
+	RmBinaryIO::writeHeader( os, SnapshotMagic, SnapshotVersion );
+	RmBinaryIO::write( os, m_settings->CellSize );
+
+	// Session state
+	RmBinaryIO::write( os, static_cast<char>(m_finalized) );
+
+	// Local maps, in order of creation
+	std::map<const RmLocalMap*,int> mapIndexes;
+	mapIndexes[NULL] = -1;
+	RmBinaryIO::write( os, static_cast<int>(m_maps.size()) );
+	for ( int i = 0; i < m_maps.size(); ++i ) {
+		mapIndexes[m_maps[i]] = i;
+		m_maps[i]->write( os );
+	}
+
+	// Trajectories, with local maps identified by their position in the collection
+	RmBinaryIO::write( os, static_cast<int>(m_trajectories.size()) );
+	std::vector<Trajectory>::const_iterator ti;
+	for ( ti = m_trajectories.begin(); ti != m_trajectories.end(); ++ti )
+	{
+		RmBinaryIO::write( os, ti->wDistance );
+		RmBinaryIO::write( os, ti->gAccumShift );
+		RmBinaryIO::write( os, static_cast<char>(ti->newMap) );
+		RmBinaryIO::write( os, ti->wLastPos );
+		RmBinaryIO::write( os, ti->wCurrentReading );
+		RmBinaryIO::write( os, mapIndexes[ti->currentMap] );
+		RmBinaryIO::write( os, mapIndexes[ti->priorMap] );
+		RmBinaryIO::write( os, ti->resumeSweep );
+	}
+
+	// Regions, with local maps identified by their position in the collection
+	m_regionMap.write( os );
+	RmBinaryIO::write( os, m_maxRegionId );
+	RmBinaryIO::write( os, static_cast<int>(m_regions.size()) );
+	std::map<RegionId,Region*>::const_iterator ri;
+	for ( ri = m_regions.begin(); ri != m_regions.end(); ++ri )
+	{
+		const Region *r = (*ri).second;
+		RmBinaryIO::write( os, r->id );
+		r->boundary.write( os );
+		RmBinaryIO::write( os, static_cast<int>(r->maps.size()) );
+		RmFlatSet<RmLocalMap*>::const_iterator mi;
+		for ( mi = r->maps.begin(); mi != r->maps.end(); ++mi ) {
+			RmBinaryIO::write( os, mapIndexes[*mi] );
+		}
+	}
+	std::queue<RegionId> usedIds( m_usedRegionIds );
+	RmBinaryIO::write( os, static_cast<int>(usedIds.size()) );
+	for ( ; !usedIds.empty(); usedIds.pop() ) RmBinaryIO::write( os, usedIds.front() );
+
+	// Global map
+	RmMutableCartesianGrid<float>::write( os );
+	RmBinaryIO::write( os, static_cast<char>(m_quantized) );
+	m_quantizedMap.write( os );
+
+	// Running sums of retired local maps
+	m_retiredSums.write( os );
+	m_retiredCounts.write( os );
+
+	if ( !os ) throw RmExceptions::IOException( "RmGlobalMap::write()", "Unable to write snapshot" );
+}
+
+
+void RmGlobalMap::writeTiled( const char *filename, RmGridFile::CellType type,
+	RmGridFile::Compression compression, int tileSize ) const
+{
+	RmGridFile::write( ConvolvedTiles( *this ), m_regionMap.bound(), origin(), InitVal, 
+		filename, m_settings->CellSize, type, compression, tileSize );
+}
+
+
+template<class T>
+std::ostream& operator<<( std::ostream& os, const std::vector<T>& v )
+{
+	std::vector<T>::const_iterator it;
+	for( it = v.begin(); it != v.end(); ++it ) {
+		os << *it << " ";
+	}
+	return os;
+}
@@ -0,0 +1,509 @@
+// RmGridFile.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include "RmGridFile.h"
+#include "RmBinaryIO.h"
+#include "RmExceptions.h"
+
+using RmUtility::BoundBox;
+using RmUtility::Coord;
+
+
+const int RmGridFile::DefaultTileSize = 64;
+const int RmGridFile::Version = 2;
+
+/** Identifies a file as a binary grid file */
+static const char *Magic = "RMGD";
+
+
+/** The location of a tile's payload within the file */
+struct TileEntry
+{
+	/** The offset of the payload from the beginning of the file; zero if absent */
+	unsigned int offset;
+
+	/** The length of the payload, in bytes */
+	unsigned int length;
+};
+
+
+/**
+ * Appends the raw bytes of v to the payload.
+ */
+template<class T>
+static void append( std::vector<char> &payload, const T &v )
+{
+	const char *p = reinterpret_cast<const char*>(&v);
+	payload.insert( payload.end(), p, p + sizeof(T) );
+}
+
+
+/**
+ * Appends n cells to the payload, either raw or as a series of (count, value) pairs.
+ */
+template<class T>
+static void encodeCells( const T *cells, int n, bool runLength, std::vector<char> &payload )
+{
+	if ( !runLength ) {
+		const char *p = reinterpret_cast<const char*>(cells);
+		payload.insert( payload.end(), p, p + n * sizeof(T) );
+		return;
+	}
+
+	int i = 0;
+	while ( i < n )
+	{
+		const T v = cells[i];
+		unsigned short run = 1;
+		while ( i + run < n && run < 65535 && cells[i + run] == v ) ++run;
+		append( payload, run );
+		append( payload, v );
+		i += run;
+	}
+}
+
+
+/**
+ * Decodes n cells from a payload produced by encodeCells().
+ */
+template<class T>
+static void decodeCells( const std::vector<char> &payload, bool runLength, int n, T *cells )
+{
+	static const char *signature_ = "RmGridFile::decode()";
+
+	if ( !runLength ) {
+		if ( payload.size() != n * sizeof(T) ) {
+			throw RmExceptions::IOException( signature_, "Tile length does not match its dimensions" );
+		}
+		if ( n > 0 ) memcpy( cells, &payload[0], n * sizeof(T) );
+		return;
+	}
+
+	const int pairSize = sizeof(unsigned short) + sizeof(T);
+	int i = 0;
+	unsigned int pos = 0;
+	for ( ; pos + pairSize <= payload.size(); pos += pairSize )
+	{
+		unsigned short run;
+		T v;
+		memcpy( &run, &payload[pos], sizeof(unsigned short) );
+		memcpy( &v, &payload[pos + sizeof(unsigned short)], sizeof(T) );
+		if ( i + run > n ) break;
+		std::fill( cells + i, cells + i + run, v );
+		i += run;
+	}
+
+	if ( i != n || pos != payload.size() ) {
+		throw RmExceptions::IOException( signature_, "Tile run lengths do not match its dimensions" );
+	}
+}
+
+
+/**
+ * Encodes the given cells, as laid out in a tile, into a payload of the given type 
+ * and compression.
+ */
+static void encode( const std::vector<float> &cells, const RmGridFile::Header &header,
+	std::vector<char> &payload )
+{
+	const bool runLength = header.compression == RmGridFile::RunLength;
+	const int n = cells.size();
+
+	if ( header.cellType == RmGridFile::Quantized8 )
+	{
+		std::vector<unsigned char> q( n );
+		for ( int i = 0; i < n; ++i ) q[i] = RmUtility::quantize( cells[i] );
+		encodeCells( &q[0], n, runLength, payload );
+	}
+	else encodeCells( &cells[0], n, runLength, payload );
+}
+
+
+/**
+ * Encodes the given quantized cells, as laid out in a tile, into a payload of the given type
+ * and compression.
+ */
+static void encode( const std::vector<unsigned char> &cells, const RmGridFile::Header &header,
+	std::vector<char> &payload )
+{
+	const bool runLength = header.compression == RmGridFile::RunLength;
+	const int n = cells.size();
+
+	if ( header.cellType == RmGridFile::Float32 )
+	{
+		std::vector<float> pr( n );
+		for ( int i = 0; i < n; ++i ) {
+			pr[i] = cells[i] == RmUtility::QuantizedUnknown ? header.initVal : RmUtility::dequantize( cells[i] );
+		}
+		encodeCells( &pr[0], n, runLength, payload );
+	}
+	else encodeCells( &cells[0], n, runLength, payload );
+}
+
+
+/**
+ * Decodes a payload produced by encode() into n cells.
+ * @throws an RmExceptions::IOException if the payload is inconsistent with the cell count
+ */
+static void decode( const std::vector<char> &payload, const RmGridFile::Header &header, int n,
+	std::vector<float> &cells )
+{
+	const bool runLength = header.compression == RmGridFile::RunLength;
+	cells.resize( n );
+
+	if ( header.cellType == RmGridFile::Quantized8 )
+	{
+		std::vector<unsigned char> q( n );
+		decodeCells( payload, runLength, n, &q[0] );
+		for ( int i = 0; i < n; ++i ) {
+			cells[i] = q[i] == RmUtility::QuantizedUnknown ? header.initVal : RmUtility::dequantize( q[i] );
+		}
+	}
+	else decodeCells( payload, runLength, n, &cells[0] );
+}
+
+
+/**
+ * Decodes a payload produced by encode() into n quantized cells.
+ * @throws an RmExceptions::IOException if the payload is inconsistent with the cell count
+ */
+static void decode( const std::vector<char> &payload, const RmGridFile::Header &header, int n,
+	std::vector<unsigned char> &cells )
+{
+	const bool runLength = header.compression == RmGridFile::RunLength;
+	cells.resize( n );
+
+	if ( header.cellType == RmGridFile::Float32 )
+	{
+		std::vector<float> pr( n );
+		decodeCells( payload, runLength, n, &pr[0] );
+		for ( int i = 0; i < n; ++i ) cells[i] = RmUtility::quantize( pr[i] );
+	}
+	else decodeCells( payload, runLength, n, &cells[0] );
+}
+
+
+/** Converts a probability to the given cell type */
+static void toCell( float pr, float &cell ) { cell = pr; }
+static void toCell( float pr, unsigned char &cell ) { cell = RmUtility::quantize( pr ); }
+
+
+/**
+ * Returns the description of a grid of the given dimensions as it is to be written.
+ * @throws an RmExceptions::InvalidParameterException if the tile size is not positive
+ */
+static RmGridFile::Header describe( const BoundBox &bound, const Coord &origin, float initVal, 
+	int cellSize, RmGridFile::CellType type, RmGridFile::Compression compression, int tileSize )
+{
+	if ( tileSize <= 0 ) throw RmExceptions::InvalidParameterException( "RmGridFile::write()",
+		"Tile size must be positive" );
+
+	RmGridFile::Header header;
+	header.cellType = type;
+	header.compression = compression;
+	header.cellSize = cellSize;
+	header.tileSize = tileSize;
+	header.initVal = initVal;
+	header.bound = bound;
+	header.origin = origin;
+
+	return header;
+}
+
+
+/**
+ * Supplies the tiles of a grid held in memory to writeTiles().
+ */
+template<class T>
+class GridTiles
+{
+public:
+
+	GridTiles( const RmMutableCartesianGrid<T> &grid ) : m_grid(grid) 
+	{
+		if ( grid.width() == 0 || grid.height() == 0 ) throw RmExceptions::InvalidParameterException(
+			"RmGridFile::write()", "Grid has no cells" );
+	}
+
+	/** See RmGridFile::TileSource::tile() */
+	bool tile( const BoundBox &area, std::vector<T> &cells ) const
+	{
+		const int col = area.ul.x - m_grid.bound().ul.x;
+		const int row = m_grid.bound().ul.y - area.ul.y;
+		const int tw = area.width();
+		const T initVal = m_grid.initValue();
+
+		bool initialized = true;
+		for ( int j = 0; j < area.height(); ++j ) 
+		{
+			const T *src = m_grid.rowAt( row + j ) + col;
+			for ( int i = 0; i < tw && initialized; ++i ) initialized = src[i] == initVal;
+			std::copy( src, src + tw, cells.begin() + j * tw );
+		}
+		return !initialized;
+	}
+
+private:
+
+	const RmMutableCartesianGrid<T> &m_grid;
+};
+
+
+/**
+ * Writes the tile directory and tiles supplied by the given source to a file positioned 
+ * just beyond its header, and closes the file.
+ * Tiles every cell of which has the initialization value are omitted.
+ * @param cells scratch storage of the cell type supplied by the source
+ * @throws an RmExceptions::IOException if the file cannot be written
+ */
+template<class Source, class T>
+static void writeTiles( std::ofstream &ofs, const Source &source, const RmGridFile::Header &header,
+	std::vector<T> &cells )
+{
+	// Reserve the tile directory, which is filled in once the tile offsets are known
+	const int tileSize = header.tileSize;
+	const int tilesX = header.tilesX();
+	const int tilesY = header.tilesY();
+	std::vector<TileEntry> directory( tilesX * tilesY );
+	const std::streampos directoryPos = ofs.tellp();
+	RmBinaryIO::writeArray( ofs, &directory[0], directory.size() );
+
+	// Write each tile, clipped to the bound of the grid
+	const BoundBox &bound = header.bound;
+	std::vector<char> payload;
+	for ( int ty = 0; ty < tilesY; ++ty ) {
+		for ( int tx = 0; tx < tilesX; ++tx )
+		{
+			const Coord ul( bound.ul.x + tx * tileSize, bound.ul.y - ty * tileSize );
+			BoundBox area( ul.x, ul.y, ul.x + tileSize - 1, ul.y - tileSize + 1 );
+			area.intersectWith( bound );
+
+			cells.resize( area.width() * area.height() );
+			if ( !source.tile( area, cells ) ) continue;
+
+			payload.clear();
+			encode( cells, header, payload );
+
+			RmBinaryIO::align( ofs );
+			TileEntry &entry = directory[ty * tilesX + tx];
+			entry.offset = static_cast<unsigned int>(ofs.tellp());
+			entry.length = payload.size();
+			RmBinaryIO::writeArray( ofs, &payload[0], payload.size() );
+		}
+	}
+
+	ofs.seekp( directoryPos );
+	RmBinaryIO::writeArray( ofs, &directory[0], directory.size() );
+	ofs.close();
+	if ( ofs.fail() ) throw RmExceptions::IOException( "RmGridFile::write()", 
+		"Unable to write grid file" );
+}
+
+
+/**
+ * Replaces the given grid with the given area of that described by the header, reading the
+ * tile directory and those tiles that intersect the area from a file positioned just beyond 
+ * the header.
+ * @throws an RmExceptions::IOException if the file is truncated or inconsistent
+ * @throws an RmExceptions::InvalidParameterException if the area lies outside the grid
+ */
+template<class T>
+static void readTiles( std::ifstream &ifs, const RmGridFile::Header &h, const BoundBox &area,
+	RmMutableCartesianGrid<T> &grid )
+{
+	const int tilesX = h.tilesX();
+	const int tilesY = h.tilesY();
+	std::vector<TileEntry> directory( tilesX * tilesY );
+	RmBinaryIO::readArray( ifs, &directory[0], directory.size() );
+
+	BoundBox clip( area );
+	clip.intersectWith( h.bound );
+	if ( clip.ul.x > clip.lr.x || clip.ul.y < clip.lr.y ) {
+		throw RmExceptions::InvalidParameterException( "RmGridFile::read()", 
+			"Area does not intersect the grid" );
+	}
+
+	T initVal;
+	toCell( h.initVal, initVal );
+	grid = RmMutableCartesianGrid<T>( clip, h.origin, initVal );
+
+	// Read each tile present in the file that intersects the area, copying the intersecting 
+	// cells row by row into the grid
+	const int firstX = (clip.ul.x - h.bound.ul.x) / h.tileSize;
+	const int lastX = (clip.lr.x - h.bound.ul.x) / h.tileSize;
+	const int firstY = (h.bound.ul.y - clip.ul.y) / h.tileSize;
+	const int lastY = (h.bound.ul.y - clip.lr.y) / h.tileSize;
+	std::vector<T> cells;
+	std::vector<char> payload;
+	for ( int ty = firstY; ty <= lastY; ++ty ) {
+		for ( int tx = firstX; tx <= lastX; ++tx )
+		{
+			const TileEntry &entry = directory[ty * tilesX + tx];
+			if ( entry.offset == 0 ) continue;
+
+			const Coord ul( h.bound.ul.x + tx * h.tileSize, h.bound.ul.y - ty * h.tileSize );
+			BoundBox tile( ul.x, ul.y, ul.x + h.tileSize - 1, ul.y - h.tileSize + 1 );
+			tile.intersectWith( h.bound );
+			BoundBox part( tile );
+			part.intersectWith( clip );
+
+			ifs.seekg( entry.offset );
+			payload.resize( entry.length );
+			RmBinaryIO::readArray( ifs, &payload[0], payload.size() );
+			decode( payload, h, tile.width() * tile.height(), cells );
+
+			for ( int y = part.ul.y; y >= part.lr.y; --y ) {
+				const T *src = &cells[0] + (tile.ul.y - y) * tile.width() + (part.ul.x - tile.ul.x);
+				std::copy( src, src + part.width(), 
+					grid.rowAt( clip.ul.y - y ) + (part.ul.x - clip.ul.x) );
+			}
+		}
+	}
+}
+
+
+void RmGridFile::write( const RmMutableCartesianGrid<float> &grid, const char *filename,
+	int cellSize, CellType type, Compression compression, int tileSize )
+{
+	const GridTiles<float> source( grid );
+	const Header header = describe( grid.bound(), grid.origin(), grid.initValue(), 
+		cellSize, type, compression, tileSize );
+	std::ofstream ofs( filename, std::ios::out | std::ios::binary | std::ios::trunc );
+	if ( !ofs ) throw RmExceptions::IOException( "RmGridFile::write()", 
+		"Unable to open grid file for write" );
+	writeHeader( ofs, header );
+	std::vector<float> cells;
+	writeTiles( ofs, source, header, cells );
+}
+
+
+void RmGridFile::write( const RmMutableCartesianGrid<unsigned char> &grid, const char *filename,
+	int cellSize, CellType type, Compression compression, int tileSize )
+{
+	const GridTiles<unsigned char> source( grid );
+	const Header header = describe( grid.bound(), grid.origin(), 
+		RmUtility::dequantize( grid.initValue() ), cellSize, type, compression, tileSize );
+	std::ofstream ofs( filename, std::ios::out | std::ios::binary | std::ios::trunc );
+	if ( !ofs ) throw RmExceptions::IOException( "RmGridFile::write()", 
+		"Unable to open grid file for write" );
+	writeHeader( ofs, header );
+	std::vector<unsigned char> cells;
+	writeTiles( ofs, source, header, cells );
+}
+
+
+void RmGridFile::write( const TileSource &source, const RmUtility::BoundBox &bound, 
+	const RmUtility::Coord &origin, float initVal, const char *filename, int cellSize, 
+	CellType type, Compression compression, int tileSize )
+{
+	const Header header = describe( bound, origin, initVal, cellSize, type, compression, tileSize );
+	std::ofstream ofs( filename, std::ios::out | std::ios::binary | std::ios::trunc );
+	if ( !ofs ) throw RmExceptions::IOException( "RmGridFile::write()", 
+		"Unable to open grid file for write" );
+	writeHeader( ofs, header );
+	std::vector<float> cells;
+	writeTiles( ofs, source, header, cells );
+}
+
+
+void RmGridFile::read( const char *filename, RmMutableCartesianGrid<float> &grid, Header *header )
+{
+	std::ifstream ifs( filename, std::ios::in | std::ios::binary );
+	if ( !ifs ) throw RmExceptions::IOException( "RmGridFile::read()", "Unable to open grid file" );
+	const Header h = readHeader( ifs );
+	readTiles( ifs, h, h.bound, grid );
+	if ( header != NULL ) *header = h;
+}
+
+
+void RmGridFile::read( const char *filename, RmMutableCartesianGrid<unsigned char> &grid, 
+	Header *header )
+{
+	std::ifstream ifs( filename, std::ios::in | std::ios::binary );
+	if ( !ifs ) throw RmExceptions::IOException( "RmGridFile::read()", "Unable to open grid file" );
+	const Header h = readHeader( ifs );
+	readTiles( ifs, h, h.bound, grid );
+	if ( header != NULL ) *header = h;
+}
+
+
+void RmGridFile::read( const char *filename, const RmUtility::BoundBox &area, 
+	RmMutableCartesianGrid<float> &grid, Header *header )
+{
+	std::ifstream ifs( filename, std::ios::in | std::ios::binary );
+	if ( !ifs ) throw RmExceptions::IOException( "RmGridFile::read()", "Unable to open grid file" );
+	const Header h = readHeader( ifs );
+	readTiles( ifs, h, area, grid );
+	if ( header != NULL ) *header = h;
+}
+
+
+void RmGridFile::read( const char *filename, const RmUtility::BoundBox &area, 
+	RmMutableCartesianGrid<unsigned char> &grid, Header *header )
+{
+	std::ifstream ifs( filename, std::ios::in | std::ios::binary );
+	if ( !ifs ) throw RmExceptions::IOException( "RmGridFile::read()", "Unable to open grid file" );
+	const Header h = readHeader( ifs );
+	readTiles( ifs, h, area, grid );
+	if ( header != NULL ) *header = h;
+}
+
+
+RmGridFile::Header RmGridFile::readHeader( const char *filename )
+{
+	std::ifstream ifs( filename, std::ios::in | std::ios::binary );
+	if ( !ifs ) throw RmExceptions::IOException( "RmGridFile::readHeader()", "Unable to open grid file" );
+	return readHeader( ifs );
+}
+
+
+void RmGridFile::writeHeader( std::ostream &os, const Header &header )
+{
+	RmBinaryIO::writeHeader( os, Magic, Version );
+	RmBinaryIO::write( os, static_cast<int>(header.cellType) );
+	RmBinaryIO::write( os, static_cast<int>(header.compression) );
+	RmBinaryIO::write( os, header.cellSize );
+	RmBinaryIO::write( os, header.tileSize );
+	RmBinaryIO::write( os, header.initVal );
+	RmBinaryIO::write( os, header.bound );
+	RmBinaryIO::write( os, header.origin );
+}
+
+
+RmGridFile::Header RmGridFile::readHeader( std::istream &is )
+{
+	static const char *signature_ = "RmGridFile::readHeader()";
+
+	if ( RmBinaryIO::readHeader( is, Magic ) != Version ) {
+		throw RmExceptions::IOException( signature_, "Unsupported grid file version" );
+	}
+
+	Header header;
+	int type, compression;
+	RmBinaryIO::read( is, type );
+	RmBinaryIO::read( is, compression );
+	RmBinaryIO::read( is, header.cellSize );
+	RmBinaryIO::read( is, header.tileSize );
+	RmBinaryIO::read( is, header.initVal );
+	RmBinaryIO::read( is, header.bound );
+	RmBinaryIO::read( is, header.origin );
+
+	if ( type != Float32 && type != Quantized8 ) {
+		throw RmExceptions::IOException( signature_, "Unrecognized cell type" );
+	}
+	if ( compression != Raw && compression != RunLength ) {
+		throw RmExceptions::IOException( signature_, "Unrecognized compression" );
+	}
+	if ( header.tileSize <= 0 || header.bound.ul.x > header.bound.lr.x ||
+		header.bound.ul.y < header.bound.lr.y ) {
+		throw RmExceptions::IOException( signature_, "Invalid grid dimensions" );
+	}
+	header.cellType = static_cast<CellType>(type);
+	header.compression = static_cast<Compression>(compression);
+
+	return header;
+}
@@ -0,0 +1,179 @@
+// RmInstrument.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cstdio>
+#include <sstream>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "Aria.h"
+#include "RmInstrument.h"
+
+
+/** The figures accumulated by a stage */
+struct StageRecord
+{
+	unsigned long calls;
+	double total, max; // seconds
+	unsigned long histogram[RmInstrument::Buckets];
+};
+
+static StageRecord stages[RmInstrument::StageCount];
+static double counters[RmInstrument::CounterCount];
+static ArMutex mutex; // serializes access to stages and counters
+
+static const char *stageNames[] = { "update", "addToRegionMap", "localizedPose", "integrate",
+	"logFormat", "sendClientReply" };
+static const char *counterNames[] = { "cellsUpdated", "raysCast", "regionsCreated", "bytesSent",
+	"sweepsDropped" };
+
+
+/**
+ * Returns the upper bound, in microseconds, of the bucket of the given histogram within which
+ * the given fraction of its durations fall.
+ */
+static double quantile( const StageRecord &s, double fraction )
+{
+	const double target = fraction * s.calls;
+	double seen = 0;
+	for ( int b = 0; b < RmInstrument::Buckets - 1; ++b ) {
+		seen += s.histogram[b];
+		if ( seen >= target ) return static_cast<double>(1L << b);
+	}
+	return s.max * 1e6;
+}
+
+
+double RmInstrument::wallSeconds()
+{
+#ifdef WIN32
+	static LARGE_INTEGER frequency = { 0 };
+	if ( frequency.QuadPart == 0 ) QueryPerformanceFrequency( &frequency );
+	LARGE_INTEGER count;
+	QueryPerformanceCounter( &count );
+	return static_cast<double>(count.QuadPart) / frequency.QuadPart;
+#else
+	timeval now;
+	gettimeofday( &now, NULL );
+	return now.tv_sec + now.tv_usec / 1e6;
+#endif
+}
+
+
+void RmInstrument::record( Stage stage, double seconds )
+{
+	// Bucket b holds durations of less than 2^b microseconds, and at least half that
+	int bucket = 0;
+	for ( double limit = 1e-6; bucket < Buckets - 1 && seconds >= limit; limit *= 2 ) ++bucket;
+
+	mutex.lock();
+	StageRecord &s = stages[stage];
+	++s.calls;
+	s.total += seconds;
+	if ( seconds > s.max ) s.max = seconds;
+	++s.histogram[bucket];
+	mutex.unlock();
+}
+
+
+void RmInstrument::count( Counter counter, double n )
+{
+	mutex.lock();
+	counters[counter] += n;
+	mutex.unlock();
+}
+
+
+double RmInstrument::counted( Counter counter )
+{
+	mutex.lock();
+	const double n = counters[counter];
+	mutex.unlock();
+	return n;
+}
+
+
+const char* RmInstrument::name( Stage stage )
+{
+	return stageNames[stage];
+}
+
+
+const char* RmInstrument::name( Counter counter )
+{
+	return counterNames[counter];
+}
+
+
+void RmInstrument::report( std::ostream &os )
+{
+	#ifndef _INSTRUMENT
+	os << "Instrumentation not compiled (define _INSTRUMENT)\n";
+	#endif
+
+	// Copied, such that the stream is written without holding the lock
+	mutex.lock();
+	StageRecord s[StageCount];
+	double c[CounterCount];
+	int i;
+	for ( i = 0; i < StageCount; ++i ) s[i] = stages[i];
+	for ( i = 0; i < CounterCount; ++i ) c[i] = counters[i];
+	mutex.unlock();
+
+	char buff[120];
+	sprintf( buff, "%-16s %10s %12s %10s %10s %8s %8s\n",
+		"stage", "calls", "total ms", "mean us", "max us", "p50 us", "p99 us" );
+	os << buff;
+	for ( i = 0; i < StageCount; ++i ) {
+		sprintf( buff, "%-16s %10lu %12.3f %10.1f %10.1f %8.0f %8.0f\n", stageNames[i],
+			s[i].calls, s[i].total * 1e3, s[i].calls == 0 ? 0.0 : s[i].total * 1e6 / s[i].calls,
+			s[i].max * 1e6, s[i].calls == 0 ? 0.0 : quantile( s[i], 0.5 ),
+			s[i].calls == 0 ? 0.0 : quantile( s[i], 0.99 ) );
+		os << buff;
+	}
+
+	for ( i = 0; i < CounterCount; ++i ) {
+		sprintf( buff, "%-16s %10.0f\n", counterNames[i], c[i] );
+		os << buff;
+	}
+
+	// Histograms, listing only the buckets of any duration, each by its upper bound
+	for ( i = 0; i < StageCount; ++i ) {
+		if ( s[i].calls == 0 ) continue;
+		os << stageNames[i] << " (us):";
+		for ( int b = 0; b < Buckets; ++b ) {
+			if ( s[i].histogram[b] == 0 ) continue;
+			if ( b < Buckets - 1 ) sprintf( buff, " <%ld:%lu", 1L << b, s[i].histogram[b] );
+			else sprintf( buff, " >=%ld:%lu", 1L << (b - 1), s[i].histogram[b] );
+			os << buff;
+		}
+		os << "\n";
+	}
+}
+
+
+std::string RmInstrument::report()
+{
+	std::ostringstream os;
+	report( os );
+	return os.str();
+}
+
+
+void RmInstrument::reset()
+{
+	mutex.lock();
+	int i;
+	for ( i = 0; i < StageCount; ++i ) {
+		stages[i].calls = 0;
+		stages[i].total = stages[i].max = 0.0;
+		for ( int b = 0; b < Buckets; ++b ) stages[i].histogram[b] = 0;
+	}
+	for ( i = 0; i < CounterCount; ++i ) counters[i] = 0.0;
+	mutex.unlock();
+}
@@ -0,0 +1,169 @@
+// RmLocalizationTrace.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cstdio>
+#include "RmLocalizationTrace.h"
+#include "RmBinaryIO.h"
+
+using RmUtility::Pose;
+
+
+const char *RmLocalizationTrace::Magic = "RMLT";
+const int RmLocalizationTrace::Version = 2;
+
+
+RmLocalizationTrace::RmLocalizationTrace( const std::string &name, int dumpInterval )
+: m_name( name ), m_dumpInterval( dumpInterval < 0 ? 0 : dumpInterval ),
+  m_localizations( 0 ), m_dumpRequested( false )
+{
+	const std::string traceName( name + ".lt" );
+	m_trace.open( traceName.c_str(), std::ios::out | std::ios::binary );
+	if ( !m_trace ) throw RmExceptions::IOException(
+		"RmLocalizationTrace::RmLocalizationTrace()", "Unable to open localization trace file" );
+	RmBinaryIO::writeHeader( m_trace, Magic, Version );
+}
+
+
+bool RmLocalizationTrace::beginLocalization( Record &r )
+{
+	r.localization = ++m_localizations;
+	r.robot = 0;
+	r.prior = r.chosen = Pose();
+	r.width = r.height = 0;
+	r.cumDistance = r.cumTurn = 0.0f;
+	for ( int i = 0; i < NUM_SONARS; ++i ) {
+		SonarRecord &s = r.sonars[i];
+		s.distance = s.unobstructed = s.selected = 0;
+		s.inRange = false;
+		s.bestScore = 0.0f;
+	}
+	r.histogramPeak = r.candidates = r.retained = 0;
+
+	m_mutex.lock();
+	r.dumped = m_dumpRequested ||
+		(m_dumpInterval > 0 && (m_localizations - 1) % m_dumpInterval == 0);
+	m_dumpRequested = false;
+	m_mutex.unlock();
+
+	return r.dumped;
+}
+
+
+void RmLocalizationTrace::requestDump()
+{
+	m_mutex.lock();
+	m_dumpRequested = true;
+	m_mutex.unlock();
+}
+
+
+std::ostream& RmLocalizationTrace::dumpStream()
+{
+	if ( !m_dump.is_open() ) {
+		const std::string dumpName( m_name + ".ltd" );
+		m_dump.open( dumpName.c_str() );
+		m_dump.setf( std::ios_base::fixed, std::ios_base::floatfield );
+		m_dump.precision( 4 );
+	}
+	return m_dump;
+}
+
+
+void RmLocalizationTrace::write( const Record &r )
+{
+	RmBinaryIO::write( m_trace, r.localization );
+	RmBinaryIO::write( m_trace, r.robot );
+	RmBinaryIO::write( m_trace, r.prior );
+	RmBinaryIO::write( m_trace, r.width );
+	RmBinaryIO::write( m_trace, r.height );
+	RmBinaryIO::write( m_trace, r.cumDistance );
+	RmBinaryIO::write( m_trace, r.cumTurn );
+	for ( int i = 0; i < NUM_SONARS; ++i ) {
+		const SonarRecord &s = r.sonars[i];
+		const short distance = static_cast<short>(s.distance);
+		const char inRange = s.inRange ? 1 : 0;
+		RmBinaryIO::write( m_trace, distance );
+		RmBinaryIO::write( m_trace, inRange );
+		RmBinaryIO::write( m_trace, s.unobstructed );
+		RmBinaryIO::write( m_trace, s.selected );
+		RmBinaryIO::write( m_trace, s.bestScore );
+	}
+	RmBinaryIO::write( m_trace, r.histogramPeak );
+	RmBinaryIO::write( m_trace, r.candidates );
+	RmBinaryIO::write( m_trace, r.retained );
+	RmBinaryIO::write( m_trace, r.chosen );
+	const char dumped = r.dumped ? 1 : 0;
+	RmBinaryIO::write( m_trace, dumped );
+
+	// Flushed, such that the trace is complete up to the last localization should the
+	// session end abruptly
+	m_trace.flush();
+	if ( !m_trace ) throw RmExceptions::IOException(
+		"RmLocalizationTrace::write()", "Unable to write localization trace file" );
+}
+
+
+void RmLocalizationTrace::readHeader( std::istream &is )
+{
+	if ( RmBinaryIO::readHeader( is, Magic ) != Version ) throw RmExceptions::IOException(
+		"RmLocalizationTrace::readHeader()", "Unsupported localization trace version" );
+}
+
+
+bool RmLocalizationTrace::read( std::istream &is, Record &r )
+{
+	// End of file is expected only between records
+	if ( is.peek() == EOF ) return false;
+
+	RmBinaryIO::read( is, r.localization );
+	RmBinaryIO::read( is, r.robot );
+	RmBinaryIO::read( is, r.prior );
+	RmBinaryIO::read( is, r.width );
+	RmBinaryIO::read( is, r.height );
+	RmBinaryIO::read( is, r.cumDistance );
+	RmBinaryIO::read( is, r.cumTurn );
+	for ( int i = 0; i < NUM_SONARS; ++i ) {
+		SonarRecord &s = r.sonars[i];
+		short distance;
+		char inRange;
+		RmBinaryIO::read( is, distance );
+		RmBinaryIO::read( is, inRange );
+		RmBinaryIO::read( is, s.unobstructed );
+		RmBinaryIO::read( is, s.selected );
+		RmBinaryIO::read( is, s.bestScore );
+		s.distance = distance;
+		s.inRange = inRange != 0;
+	}
+	RmBinaryIO::read( is, r.histogramPeak );
+	RmBinaryIO::read( is, r.candidates );
+	RmBinaryIO::read( is, r.retained );
+	RmBinaryIO::read( is, r.chosen );
+	char dumped;
+	RmBinaryIO::read( is, dumped );
+	r.dumped = dumped != 0;
+
+	return true;
+}
+
+
+std::ostream& operator<<( std::ostream &os, const RmLocalizationTrace::Record &r )
+{
+	char buff[256];
+	sprintf( buff, "localization %d robot %d prior (%d,%d):%.2f dist %dx%d cumDistance %.1f "
+		"cumTurn %.1f peak %d candidates %d retained %d chosen (%d,%d):%.2f%s\n",
+		r.localization, r.robot, r.prior.coord.x, r.prior.coord.y, r.prior.theta,
+		r.width, r.height, r.cumDistance, r.cumTurn, r.histogramPeak, r.candidates, r.retained,
+		r.chosen.coord.x, r.chosen.coord.y, r.chosen.theta, r.dumped ? " dumped" : "" );
+	os << buff;
+
+	for ( int i = 0; i < NUM_SONARS; ++i ) {
+		const RmLocalizationTrace::SonarRecord &s = r.sonars[i];
+		if ( !s.inRange ) continue;
+		sprintf( buff, "  sonar %2d range %4d unobstructed %d selected %d best %.6f\n",
+			i, s.distance, s.unobstructed, s.selected, s.bestScore );
+		os << buff;
+	}
+
+	return os;
+}
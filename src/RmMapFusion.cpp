@@ -0,0 +1,191 @@
+// RmMapFusion.cpp
+
+#pragma warning( disable : 4786 )
+#pragma warning( disable : 4355 ) // 'this' used in base member initializer list
+
+#include "RmMapFusion.h"
+#include "RmSonarMap.h"
+#include "RmSonarMapper.h"
+
+using RmUtility::BoundBox;
+using RmUtility::SonarReading;
+
+
+/**
+ * Ingests the sonar data of one robot on a thread of its own, collecting it into sweeps by
+ * an RmSonarMapper that updates the fused map, as an RmSonarMap, on behalf of the robot;
+ * see RmMapFusion.
+ */
+class FusedRobot : public RmSonarMap, public ArASyncTask
+{
+public:
+
+	FusedRobot( RmMapFusion &fusion, int robot, std::istream &sonarData )
+		: m_fusion(fusion), m_robot(robot), m_sonarData(sonarData),
+		  m_mapper(fusion.m_settings, this), m_resume(fusion.m_map.resumeSweep( robot )), 
+		  m_failed(false) {}
+
+	virtual void *runThread( void *arg )
+	{
+		try {
+			char buffer[300];
+			int sweep = 0; // the position of the next sweep within the sonar data
+			while( m_sonarData.getline( buffer, 300 ) )
+			{
+				// Skip comments
+				if ( buffer[0] == '%' ) continue;
+
+				// Skip sweeps already mapped by a restored session
+				const int s = sweep++;
+				if ( s < m_resume ) continue;
+
+				// Map entire sonar sweep
+				SonarReading readings( buffer );
+				m_fusion.ingest( m_mapper, readings, s, m_resume, m_robot );
+			}
+		}
+		catch ( RmExceptions::Exception e ) {
+			m_error = e;
+			m_failed = true;
+		}
+		return NULL;
+	}
+
+	/** Returns true if ingest ended with an exception, which is returned by error() */
+	bool failed() const { return m_failed; }
+
+	const RmExceptions::Exception& error() const { return m_error; }
+
+	// Called by the mapper from within RmMapFusion::ingest(), and so while holding the lock
+	virtual const std::string update( const SonarReading &reading ) {
+		return m_fusion.m_map.update( reading, m_robot );
+	}
+
+	// The remainder of the interface is not used by RmSonarMapper, but is provided for
+	// completeness, holding the lock as does ingest()
+
+	virtual std::ostream& put( std::ostream &os ) const {
+		m_fusion.lock();
+		m_fusion.m_map.put( os );
+		m_fusion.unlock();
+		return os;
+	}
+
+	virtual int width() const {
+		m_fusion.lock();
+		const int w = m_fusion.m_map.width();
+		m_fusion.unlock();
+		return w;
+	}
+
+	virtual int height() const {
+		m_fusion.lock();
+		const int h = m_fusion.m_map.height();
+		m_fusion.unlock();
+		return h;
+	}
+
+	virtual BoundBox bound() const {
+		m_fusion.lock();
+		const BoundBox b( m_fusion.m_map.bound() );
+		m_fusion.unlock();
+		return b;
+	}
+
+	virtual void empty() {
+		m_fusion.lock();
+		m_fusion.m_map.empty();
+		m_fusion.unlock();
+	}
+
+	virtual void clear() {
+		m_fusion.lock();
+		m_fusion.m_map.clear();
+		m_fusion.unlock();
+	}
+
+private:
+
+	RmMapFusion &m_fusion;
+	const int m_robot;
+	std::istream &m_sonarData;
+	RmSonarMapper m_mapper;
+	const int m_resume; // the sweep at which mapping is resumed; see RmGlobalMap::resumeSweep()
+	bool m_failed;
+	RmExceptions::Exception m_error;
+};
+
+
+RmMapFusion::RmMapFusion( RmGlobalMap &map, const RmSettings &settings,
+	RmMapSnapshotter *snapshotter )
+: m_map( map ), m_settings( settings ), m_snapshotter( snapshotter ),
+  m_running( false ), m_started( false )
+{
+}
+
+
+RmMapFusion::~RmMapFusion()
+{
+	std::vector<FusedRobot*>::iterator ri;
+	if ( m_running ) {
+		for ( ri = m_robots.begin(); ri != m_robots.end(); ++ri ) (*ri)->join();
+	}
+	for ( ri = m_robots.begin(); ri != m_robots.end(); ++ri ) delete *ri;
+}
+
+
+int RmMapFusion::addRobot( std::istream &sonarData )
+{
+	if ( m_started ) {
+		throw RmExceptions::InvalidStateException( "RmMapFusion::addRobot()",
+			"Robots may not be added once started" );
+	}
+
+	m_robots.push_back( new FusedRobot( *this, robots(), sonarData ) );
+	return robots() - 1;
+}
+
+
+void RmMapFusion::ingest( RmSonarMapper &mapper, SonarReading &readings, int sweep, 
+	int resume, int robot )
+{
+	lock();
+	try {
+		if ( sweep == resume ) mapper.resumeAt( readings );
+		else if ( mapper.mapReadings( readings ) ) m_map.setResumeSweep( robot, sweep );
+		m_map.checkpointIfDue();
+		if ( m_snapshotter != NULL ) m_snapshotter->takeIfDue();
+		unlock();
+	}
+	catch ( ... ) {
+		unlock();
+		throw;
+	}
+}
+
+
+void RmMapFusion::join()
+{
+	if ( !m_running ) return;
+
+	std::vector<FusedRobot*>::iterator ri;
+	for ( ri = m_robots.begin(); ri != m_robots.end(); ++ri ) (*ri)->join();
+	m_running = false;
+
+	for ( ri = m_robots.begin(); ri != m_robots.end(); ++ri ) {
+		if ( (*ri)->failed() ) throw (*ri)->error();
+	}
+}
+
+
+void RmMapFusion::start()
+{
+	if ( m_started ) {
+		throw RmExceptions::InvalidStateException( "RmMapFusion::start()",
+			"Robots may only be started once" );
+	}
+
+	m_started = m_running = true;
+	std::vector<FusedRobot*>::iterator ri;
+	for ( ri = m_robots.begin(); ri != m_robots.end(); ++ri ) (*ri)->runAsync();
+}
@@ -0,0 +1,240 @@
+// RmMapPublisher.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cstdlib>
+#include <cstring>
+#include "RmMapPublisher.h"
+#include "RmViewerStream.h"
+#include "RmUtility.h"
+#include "RmExceptions.h"
+#include "RmInstrument.h"
+
+using RmUtility::BoundBox;
+using RmUtility::Coord;
+using RmSocket::put16;
+using RmSocket::put32;
+
+
+const int RmMapPublisher::HeaderSize = 20;
+const unsigned char RmMapPublisher::Version = 1;
+const int RmMapPublisher::DefaultKeyframeInterval = 50;
+const int RmMapPublisher::DefaultPublishInterval = 200;
+
+/** The largest tile entry: its 7-byte heading followed by every cell, raw */
+static const int MaxTileBytes = 7 + RmGlobalMap::VersionTileSize * RmGlobalMap::VersionTileSize;
+
+
+RmMapPublisher::RmMapPublisher( const RmGlobalMap &map, Transport &transport, int keyframeInterval )
+: m_map( map ), m_transport( transport ), m_keyframeInterval( keyframeInterval ),
+  m_heard( false ), m_keyframeDue( true ), m_sinceKeyframe( 0 ), m_acking( false ), m_acked( 0 ), m_sent( 0 )
+{
+	if ( m_transport.maxFrame() < HeaderSize + MaxTileBytes ) {
+		throw RmExceptions::InvalidParameterException( "RmMapPublisher::RmMapPublisher()",
+			"Transport frame too small to carry a tile" );
+	}
+}
+
+
+void RmMapPublisher::acknowledge( unsigned long version )
+{
+	if ( version > m_sent || (m_acking && version < m_acked) ) return;
+	m_acked = version;
+	m_acking = true;
+}
+
+
+void RmMapPublisher::encodeTile( const RmGlobalMap &map, const Coord &tile, std::string &frame )
+{
+	const int n = RmGlobalMap::VersionTileSize;
+	const BoundBox bound( RmGlobalMap::tileBound( tile ) );
+
+	std::string raw;
+	raw.reserve( n * n );
+	for ( int y = bound.ul.y; y >= bound.lr.y; --y ) {
+		for ( int x = bound.ul.x; x <= bound.lr.x; ++x ) {
+			raw += static_cast<char>( RmUtility::quantize( map.liveValueAt( x, y ) ) );
+		}
+	}
+
+	// Run-length encode as (count, value) pairs, abandoning it once no shorter than raw
+	std::string runs;
+	std::string::size_type i = 0;
+	while ( i < raw.length() && runs.length() < raw.length() )
+	{
+		int run = 1;
+		while ( i + run < raw.length() && run < 255 && raw[i + run] == raw[i] ) ++run;
+		runs += static_cast<char>( run );
+		runs += raw[i];
+		i += run;
+	}
+	const bool runLength = runs.length() < raw.length();
+
+	put16( frame, tile.x );
+	put16( frame, tile.y );
+	frame += static_cast<char>( runLength ? 1 : 0 );
+	put16( frame, static_cast<int>( runLength ? runs.length() : raw.length() ) );
+	frame += runLength ? runs : raw;
+}
+
+
+void RmMapPublisher::handleAction( ArRobot *robot )
+{
+	while ( service( 0 ) ) m_heard = true;
+	if ( !m_heard || m_published.mSecSince() < DefaultPublishInterval ) return;
+
+	m_published.setToNow();
+	try {
+		publish();
+	}
+	catch ( RmExceptions::SocketException ) {
+		// Wait for the client to reply before publishing to it again
+		m_heard = false;
+	}
+}
+
+
+int RmMapPublisher::publish()
+{
+	if ( m_keyframeInterval > 0 && ++m_sinceKeyframe > m_keyframeInterval ) m_keyframeDue = true;
+
+	const unsigned long base = m_acking ? m_acked : m_sent;
+	const bool keyframe = m_keyframeDue || base < m_map.resetVersion();
+
+	std::vector<Coord> tiles;
+	m_map.changedTiles( keyframe ? 0 : base, tiles );
+	if ( tiles.empty() && !keyframe ) return 0;
+
+	// Pack the tiles into frames, leaving the header to be completed once they are counted
+	std::vector<std::string> frames;
+	std::vector<int> tileCounts;
+	const int maxFrame = m_transport.maxFrame();
+	std::vector<Coord>::const_iterator ti = tiles.begin();
+	do
+	{
+		std::string frame( HeaderSize, '\0' );
+		int count = 0;
+		for ( ; ti != tiles.end() && static_cast<int>(frame.length()) + MaxTileBytes <= maxFrame; ++ti ) {
+			encodeTile( m_map, *ti, frame );
+			++count;
+		}
+		frames.push_back( frame );
+		tileCounts.push_back( count );
+	}
+	while ( ti != tiles.end() );
+
+	const unsigned long version = m_map.version();
+	for ( unsigned int f = 0; f < frames.size(); ++f )
+	{
+		std::string header;
+		header += 'R';
+		header += 'D';
+		header += static_cast<char>( Version );
+		header += static_cast<char>( keyframe ? 1 : 0 );
+		put32( header, version );
+		put32( header, keyframe ? 0 : base );
+		put16( header, f );
+		put16( header, frames.size() );
+		put16( header, RmGlobalMap::VersionTileSize );
+		put16( header, tileCounts[f] );
+		frames[f].replace( 0, HeaderSize, header );
+
+		m_transport.send( frames[f] );
+	}
+
+	m_sent = version;
+	if ( keyframe ) {
+		m_keyframeDue = false;
+		m_sinceKeyframe = 0;
+	}
+
+	return tiles.size();
+}
+
+
+bool RmMapPublisher::service( int timeout )
+{
+	std::string line;
+	if ( !m_transport.receive( line, timeout ) ) return false;
+
+	if ( line.compare( 0, 4, "ack " ) == 0 ) acknowledge( strtoul( line.c_str() + 4, NULL, 10 ) );
+	else if ( line == "keyframe" ) requestKeyframe();
+	return true;
+}
+
+
+//////
+// DatagramTransport
+
+
+int RmMapPublisher::DatagramTransport::maxFrame() const
+{
+	return RmViewerStream::DefaultPayload;
+}
+
+
+void RmMapPublisher::DatagramTransport::send( const std::string &frame )
+{
+	m_server->sendClientData( frame.data(), frame.length() );
+}
+
+
+bool RmMapPublisher::DatagramTransport::receive( std::string &line, int timeout )
+{
+	if ( !m_server->pollClientString( line, timeout ) ) return false;
+	if ( line.length() > 0 && line[line.length() - 1] == '\n' ) line.erase( line.length() - 1 );
+	return true;
+}
+
+
+//////
+// StreamTransport
+
+
+int RmMapPublisher::StreamTransport::maxFrame() const
+{
+	return 65535;
+}
+
+
+void RmMapPublisher::StreamTransport::send( const std::string &frame )
+{
+	std::string message;
+	message.reserve( 4 + frame.length() );
+	put32( message, frame.length() );
+	message += frame;
+
+	// A stream socket may accept less than all of a message per call
+	const char *p = message.data();
+	int remaining = message.length();
+	while ( remaining > 0 )
+	{
+		const int nRet = ::send( m_socket, p, remaining, 0 );
+		if ( nRet <= 0 ) {
+			throw RmExceptions::SocketException(
+				"RmMapPublisher::StreamTransport::send()", "Socket error" );
+		}
+		RM_INSTRUMENT_COUNT( RmInstrument::BytesSent, nRet );
+		p += nRet;
+		remaining -= nRet;
+	}
+}
+
+
+bool RmMapPublisher::StreamTransport::receive( std::string &line, int timeout )
+{
+	std::string::size_type eol;
+	while ( (eol = m_received.find( '\n' )) == std::string::npos )
+	{
+		if ( RmSocket::waitReadable( &m_socket, 1, timeout ) < 0 ) return false;
+
+		char buff[256];
+		const int nRet = recv( m_socket, buff, sizeof(buff), 0 );
+		if ( nRet <= 0 ) return false; // closed by the client
+		m_received.append( buff, nRet );
+	}
+
+	line = m_received.substr( 0, eol );
+	m_received.erase( 0, eol + 1 );
+	return true;
+}
@@ -0,0 +1,130 @@
+// RmMapQueryServer.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include "RmMapQueryServer.h"
+
+using RmUtility::BoundBox;
+using RmUtility::Coord;
+using RmUtility::Pose;
+
+
+const int RmMapQueryServer::MaxCells = 60000;
+
+
+RmMapQueryServer::RmMapQueryServer( const short portNumber, RmMapSnapshotter &snapshotter,
+	const std::string name )
+: RmServer( portNumber, name ), m_snapshotter( snapshotter )
+{
+}
+
+
+void RmMapQueryServer::answer( const RmMapSnapshot *snapshot, const std::string &query,
+	std::string &reply )
+{
+	std::istringstream is( query );
+	std::string keyword;
+	is >> keyword;
+
+	char buff[100];
+	sprintf( buff, " %lu", snapshot->version() );
+	reply = keyword + buff;
+
+	if ( keyword == "pose" )
+	{
+		int robot = 0;
+		if ( (!(is >> robot) && !is.eof()) || robot < 0 || (robot > 0 && robot >= snapshot->robots()) ) {
+			reply = "error invalid robot";
+			return;
+		}
+		const Pose pose( snapshot->robotPose( robot ) );
+		const Pose shift( snapshot->accumulatedShift( robot ) );
+		sprintf( buff, " %d %d %.2f %d %d %.2f", pose.coord.x, pose.coord.y, pose.theta,
+			shift.coord.x, shift.coord.y, shift.theta );
+		reply += buff;
+	}
+
+	else if ( keyword == "bound" )
+	{
+		const BoundBox bound( snapshot->bound() );
+		sprintf( buff, " %d %d %d %d", bound.ul.x, bound.ul.y, bound.lr.x, bound.lr.y );
+		reply += buff;
+	}
+
+	else if ( keyword == "cells" )
+	{
+		BoundBox bound;
+		if ( !(is >> bound.ul.x >> bound.ul.y >> bound.lr.x >> bound.lr.y) ||
+			 bound.ul.x > bound.lr.x || bound.ul.y < bound.lr.y ) {
+			reply = "error invalid bound";
+			return;
+		}
+		if ( (bound.lr.x - bound.ul.x + 1.0) * (bound.ul.y - bound.lr.y + 1.0) > MaxCells ) {
+			reply = "error bound too large";
+			return;
+		}
+		sprintf( buff, " %d %d %d %d\n", bound.ul.x, bound.ul.y, bound.lr.x, bound.lr.y );
+		reply += buff;
+		snapshot->cells( bound, reply );
+	}
+
+	else if ( keyword == "occupancy" )
+	{
+		int x, y;
+		int n = 0;
+		while ( is >> x >> y ) {
+			sprintf( buff, " %d", RmUtility::quantize( snapshot->valueAt( x, y ) ) );
+			reply += buff;
+			++n;
+		}
+		if ( n == 0 || !is.eof() ) reply = "error invalid point";
+	}
+
+	else if ( keyword == "ray" )
+	{
+		Pose from;
+		int range;
+		if ( !(is >> from.coord.x >> from.coord.y >> from.theta >> range) || range < 0 ) {
+			reply = "error invalid ray";
+			return;
+		}
+
+		// No cell is obstructed beyond the farthest corner of the bound, and no ray is
+		// followed further than an area query may span
+		const BoundBox bound( snapshot->bound() );
+		const double dx = from.coord.x - bound.ul.x > bound.lr.x - from.coord.x ? 
+			from.coord.x - bound.ul.x : bound.lr.x - from.coord.x;
+		const double dy = from.coord.y - bound.lr.y > bound.ul.y - from.coord.y ? 
+			from.coord.y - bound.lr.y : bound.ul.y - from.coord.y;
+		const double reach = ceil( sqrt( dx * dx + dy * dy ) );
+		const double limit = reach < MaxCells ? reach : MaxCells;
+		if ( range > limit ) range = static_cast<int>( limit );
+
+		Coord hit;
+		if ( snapshot->rayCast( from, range, hit ) ) {
+			sprintf( buff, " hit %d %d", hit.x, hit.y );
+			reply += buff;
+		}
+		else reply += " clear";
+	}
+
+	else reply = "error unrecognized query";
+}
+
+
+bool RmMapQueryServer::service( int timeout )
+{
+	std::string query;
+	if ( !pollClientString( query, timeout ) ) return false;
+
+	const RmMapSnapshot *snapshot = m_snapshotter.acquire();
+	std::string reply;
+	answer( snapshot, query, reply );
+	m_snapshotter.release( snapshot );
+
+	sendClientData( reply.data(), reply.length() );
+	return true;
+}
@@ -0,0 +1,131 @@
+// RmMapReplica.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cstdio>
+#include <algorithm>
+#include "RmMapReplica.h"
+#include "RmMapPublisher.h"
+#include "RmBayesCertaintyGrid.h"
+#include "RmSocket.h"
+#include "RmUtility.h"
+#include "RmExceptions.h"
+
+using RmSocket::get16;
+using RmSocket::get32;
+
+
+/** The size of the heading of each tile within a frame */
+static const int TileHeadingSize = 7;
+
+
+RmMapReplica::RmMapReplica()
+: m_grid( 1, 1, RmUtility::Coord(), RmUtility::quantize( RmBayesCertaintyGrid::InitVal ) ),
+  m_current( false ), m_version( 0 ), m_newest( 0 ), m_base( 0 ), m_framesSeen( 0 ),
+  m_frameCount( 0 ), m_keyframe( false )
+{
+}
+
+
+bool RmMapReplica::apply( const char *data, int length )
+{
+	static const char *signature_ = "RmMapReplica::apply()";
+
+	if ( length < RmMapPublisher::HeaderSize || data[0] != 'R' || data[1] != 'D' ) {
+		throw RmExceptions::IOException( signature_, "Not a map publisher frame" );
+	}
+
+	const bool keyframe = (data[3] & 1) != 0;
+	const unsigned long version = get32( data + 4 );
+	const unsigned long base = get32( data + 8 );
+	const int index = get16( data + 12 ) & 0xffff;
+	const int frameCount = get16( data + 14 ) & 0xffff;
+	const int n = get16( data + 16 ) & 0xffff;
+	const int tileCount = get16( data + 18 ) & 0xffff;
+	if ( index >= frameCount || n == 0 ) {
+		throw RmExceptions::IOException( signature_, "Invalid frame header" );
+	}
+
+	// Discard frames of older updates, and those already seen
+	if ( m_frameCount > 0 && version < m_newest ) return false;
+	if ( m_frameCount == 0 || version != m_newest || base != m_base ||
+		 keyframe != m_keyframe || frameCount != m_frameCount )
+	{
+		m_newest = version;
+		m_base = base;
+		m_keyframe = keyframe;
+		m_frameCount = frameCount;
+		m_framesSeen = 0;
+		m_seen.assign( frameCount, false );
+
+		if ( keyframe ) {
+			m_grid.empty();
+			m_current = false;
+		}
+	}
+	if ( m_seen[index] ) return false;
+
+	// Replace the cells of each tile
+	std::vector<unsigned char> cells( n * n );
+	int pos = RmMapPublisher::HeaderSize;
+	for ( int t = 0; t < tileCount; ++t )
+	{
+		if ( pos + TileHeadingSize > length ) {
+			throw RmExceptions::IOException( signature_, "Truncated tile" );
+		}
+		const int tx = get16( data + pos );
+		const int ty = get16( data + pos + 2 );
+		const bool runLength = data[pos + 4] != 0;
+		const int tileLength = get16( data + pos + 5 ) & 0xffff;
+		pos += TileHeadingSize;
+		if ( pos + tileLength > length ) {
+			throw RmExceptions::IOException( signature_, "Truncated tile" );
+		}
+
+		int i = 0;
+		if ( runLength ) {
+			for ( int p = pos; p + 1 < pos + tileLength; p += 2 ) {
+				const int run = data[p] & 0xff;
+				if ( i + run > n * n ) break;
+				std::fill( cells.begin() + i, cells.begin() + i + run,
+					static_cast<unsigned char>( data[p + 1] ) );
+				i += run;
+			}
+		}
+		else if ( tileLength == n * n ) {
+			std::copy( data + pos, data + pos + tileLength, cells.begin() );
+			i = tileLength;
+		}
+		if ( i != n * n ) {
+			throw RmExceptions::IOException( signature_, "Tile length does not match its dimensions" );
+		}
+		pos += tileLength;
+
+		// Expand the replica to include the tile, then copy it in row by row
+		const RmUtility::BoundBox bound( tx * n, ty * n + n - 1, tx * n + n - 1, ty * n );
+		m_grid.valueAt( bound.ul.x, bound.ul.y );
+		m_grid.valueAt( bound.lr.x, bound.lr.y );
+		const RmGridView<unsigned char> view( m_grid.view( bound ) );
+		for ( int r = 0; r < n; ++r ) {
+			std::copy( cells.begin() + r * n, cells.begin() + (r + 1) * n, view.rowAt( bound.ul.y - r ) );
+		}
+	}
+
+	m_seen[index] = true;
+	if ( ++m_framesSeen == m_frameCount && (keyframe || (m_current && m_version >= base)) ) {
+		m_current = true;
+		m_version = version;
+	}
+
+	return true;
+}
+
+
+std::string RmMapReplica::reply() const
+{
+	if ( !m_current ) return "keyframe";
+
+	char buff[20];
+	sprintf( buff, "ack %lu", m_version );
+	return buff;
+}
@@ -0,0 +1,171 @@
+// RmMapSnapshot.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cstdlib>
+#include <algorithm>
+#include "RmMapSnapshot.h"
+#include "RmBayesCertaintyGrid.h"
+
+using RmUtility::BoundBox;
+using RmUtility::Coord;
+using RmUtility::Pose;
+
+
+RmMapSnapshot::RmMapSnapshot( const RmGlobalMap &map, float obstructedCertainty,
+	const RmMapSnapshot *prior )
+: m_version( map.version() ), m_resetVersion( map.resetVersion() ),
+  m_obstructed( obstructedCertainty )
+{
+	const int n = RmGlobalMap::VersionTileSize;
+
+	for ( int robot = 0; robot < map.robots(); ++robot ) {
+		m_robotPoses.push_back( map.robotPose( robot ) );
+		m_accumShifts.push_back( map.accumulatedShift( robot ) );
+	}
+
+	// Share the tiles of the prior snapshot unless the map has since been emptied or restored
+	unsigned long since = 0;
+	TileMap::iterator mi;
+	if ( prior != NULL && prior->m_resetVersion == m_resetVersion ) {
+		m_tiles = prior->m_tiles;
+		for ( mi = m_tiles.begin(); mi != m_tiles.end(); ++mi ) ++mi->second->references;
+		since = prior->m_version;
+	}
+
+	// Replace, rather than modify, those that have changed
+	std::vector<Coord> changed;
+	map.changedTiles( since, changed );
+	std::vector<Coord>::const_iterator ti;
+	for ( ti = changed.begin(); ti != changed.end(); ++ti )
+	{
+		Tile *tile = new Tile;
+		tile->cells.resize( n * n );
+		tile->references = 1;
+		const BoundBox bound( RmGlobalMap::tileBound( *ti ) );
+		int i = 0;
+		for ( int y = bound.ul.y; y >= bound.lr.y; --y ) {
+			for ( int x = bound.ul.x; x <= bound.lr.x; ++x ) tile->cells[i++] = map.liveValueAt( x, y );
+		}
+
+		Tile *&shared = m_tiles[std::make_pair( ti->y, ti->x )];
+		if ( shared != NULL && --shared->references == 0 ) delete shared;
+		shared = tile;
+	}
+
+	// Bound the mapped tiles
+	m_bound = BoundBox( 0, 0, 0, 0 );
+	for ( mi = m_tiles.begin(); mi != m_tiles.end(); ++mi )
+	{
+		const BoundBox b( RmGlobalMap::tileBound( Coord( mi->first.second, mi->first.first ) ) );
+		if ( mi == m_tiles.begin() ) m_bound = b;
+		if ( b.ul.x < m_bound.ul.x ) m_bound.ul.x = b.ul.x;
+		if ( b.ul.y > m_bound.ul.y ) m_bound.ul.y = b.ul.y;
+		if ( b.lr.x > m_bound.lr.x ) m_bound.lr.x = b.lr.x;
+		if ( b.lr.y < m_bound.lr.y ) m_bound.lr.y = b.lr.y;
+	}
+}
+
+
+RmMapSnapshot::~RmMapSnapshot()
+{
+	TileMap::iterator mi;
+	for ( mi = m_tiles.begin(); mi != m_tiles.end(); ++mi ) {
+		if ( --mi->second->references == 0 ) delete mi->second;
+	}
+}
+
+
+Pose RmMapSnapshot::accumulatedShift( int robot ) const
+{
+	return robot >= 0 && robot < robots() ? m_accumShifts[robot] : Pose();
+}
+
+
+void RmMapSnapshot::cells( const BoundBox &bound, std::string &s ) const
+{
+	for ( int y = bound.ul.y; y >= bound.lr.y; --y ) {
+		for ( int x = bound.ul.x; x <= bound.lr.x; ++x ) {
+			s += static_cast<char>( RmUtility::quantize( valueAt( x, y ) ) );
+		}
+	}
+}
+
+
+void RmMapSnapshot::grid( RmMutableCartesianGrid<float> &grid ) const
+{
+	RmMutableCartesianGrid<float>( m_bound, Coord(), RmBayesCertaintyGrid::InitVal ).swap( grid );
+
+	// Copy each tile in row by row
+	const int n = RmGlobalMap::VersionTileSize;
+	TileMap::const_iterator mi;
+	for ( mi = m_tiles.begin(); mi != m_tiles.end(); ++mi )
+	{
+		const BoundBox bound( RmGlobalMap::tileBound( Coord( mi->first.second, mi->first.first ) ) );
+		const RmGridView<float> view( grid.view( bound ) );
+		for ( int r = 0; r < n; ++r ) {
+			std::copy( mi->second->cells.begin() + r * n, mi->second->cells.begin() + (r + 1) * n,
+				view.rowAt( bound.ul.y - r ) );
+		}
+	}
+}
+
+
+bool RmMapSnapshot::rayCast( const Pose &from, int range, Coord &hit ) const
+{
+	// Bresenham's line algorithm, over the octant in which the ray lies; the line drawing
+	// routines of the polygon library are not used, as they are not reentrant
+	const Coord end( from.coord.mappedTo( from.theta, range ) );
+	const int dx = abs( end.x - from.coord.x );
+	const int dy = abs( end.y - from.coord.y );
+	const int sx = end.x < from.coord.x ? -1 : 1;
+	const int sy = end.y < from.coord.y ? -1 : 1;
+
+	Coord c( from.coord );
+	int e = dx - dy;
+	while ( c.x != end.x || c.y != end.y )
+	{
+		const int e2 = 2 * e;
+		if ( e2 > -dy ) {
+			e -= dy;
+			c.x += sx;
+		}
+		if ( e2 < dx ) {
+			e += dx;
+			c.y += sy;
+		}
+
+		if ( valueAt( c.x, c.y ) >= m_obstructed ) {
+			hit = c;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+Pose RmMapSnapshot::robotPose( int robot ) const
+{
+	return robot >= 0 && robot < robots() ? m_robotPoses[robot] : Pose();
+}
+
+
+int RmMapSnapshot::tileOf( int c )
+{
+	// Rounded toward negative infinity, as by RmGlobalMap
+	const int n = RmGlobalMap::VersionTileSize;
+	return c >= 0 ? c / n : -((n - 1 - c) / n);
+}
+
+
+float RmMapSnapshot::valueAt( int x, int y ) const
+{
+	const int tx = tileOf( x );
+	const int ty = tileOf( y );
+	const TileMap::const_iterator ti = m_tiles.find( std::make_pair( ty, tx ) );
+	if ( ti == m_tiles.end() ) return RmBayesCertaintyGrid::InitVal;
+
+	const int n = RmGlobalMap::VersionTileSize;
+	return ti->second->cells[(ty * n + n - 1 - y) * n + (x - tx * n)];
+}
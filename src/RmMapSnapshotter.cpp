@@ -0,0 +1,68 @@
+// RmMapSnapshotter.cpp
+
+#pragma warning( disable : 4786 )
+
+#include "RmMapSnapshotter.h"
+
+
+const int RmMapSnapshotter::DefaultInterval = 200;
+
+
+RmMapSnapshotter::RmMapSnapshotter( const RmGlobalMap &map, const RmSettings &settings,
+	int interval )
+: m_map( map ), m_settings( settings ), m_interval( interval ),
+  m_latest( new RmMapSnapshot( map, settings.ObstructedCertainty ) )
+{
+}
+
+
+RmMapSnapshotter::~RmMapSnapshotter()
+{
+	for ( unsigned int i = 0; i < m_retired.size(); ++i ) delete m_retired[i];
+	delete m_latest;
+}
+
+
+const RmMapSnapshot* RmMapSnapshotter::acquire()
+{
+	m_mutex.lock();
+	const RmMapSnapshot *snapshot = m_latest;
+	++m_readers[snapshot];
+	m_mutex.unlock();
+	return snapshot;
+}
+
+
+void RmMapSnapshotter::release( const RmMapSnapshot *snapshot )
+{
+	m_mutex.lock();
+	std::map<const RmMapSnapshot*,int>::iterator ri = m_readers.find( snapshot );
+	if ( ri != m_readers.end() && --ri->second == 0 ) m_readers.erase( ri );
+	m_mutex.unlock();
+}
+
+
+void RmMapSnapshotter::take()
+{
+	// The latest snapshot is replaced only by this thread, so may be read without the mutex
+	if ( m_latest->version() == m_map.version() ) return;
+
+	const RmMapSnapshot *snapshot =
+		new RmMapSnapshot( m_map, m_settings.ObstructedCertainty, m_latest );
+	m_taken.setToNow();
+
+	// Publish the snapshot, and collect those superseded snapshots no reader holds
+	std::vector<const RmMapSnapshot*> unheld;
+	int i;
+	m_mutex.lock();
+	m_retired.push_back( m_latest );
+	m_latest = snapshot;
+	for ( i = m_retired.size() - 1; i >= 0; --i ) {
+		if ( m_readers.find( m_retired[i] ) != m_readers.end() ) continue;
+		unheld.push_back( m_retired[i] );
+		m_retired.erase( m_retired.begin() + i );
+	}
+	m_mutex.unlock();
+
+	for ( i = 0; i < static_cast<int>(unheld.size()); ++i ) delete unheld[i];
+}
@@ -1,212 +1,313 @@
-// RmPolygon.cpp
-
-#pragma warning( disable : 4786 )
-
-#include "RmPolygon.h"
-using RmUtility::Coord;
-
-RmPolygon::RmPolygon( const RmUtility::BoundBox &bound )
-{
-	// Modeled after 
-	// void gpc::gpc_read_polygon(FILE *fp, int read_hole_flags, gpc_polygon *p)
-
-	gpc_polygon *p = &m_polygon;
-	p->num_contours = 1;
-	p->hole = new int[p->num_contours];
-	p->contour = new gpc_vertex_list[p->num_contours];
-	const int c = 0;
-    p->contour[c].num_vertices = 4;
-	p->hole[c] = 0;
-
-	p->contour[c].vertex = new gpc_vertex[p->contour[c].num_vertices];
-	p->contour[c].vertex[0].x = bound.ul.x;
-	p->contour[c].vertex[0].y = bound.ul.y;
-	p->contour[c].vertex[1].x = bound.lr.x;
-	p->contour[c].vertex[1].y = bound.ul.y;
-	p->contour[c].vertex[2].x = bound.lr.x;
-	p->contour[c].vertex[2].y = bound.lr.y;
-	p->contour[c].vertex[3].x = bound.ul.x;
-	p->contour[c].vertex[3].y = bound.lr.y;
-
-	// Have native polygon code validate this bound
-	// If invalid, will have num_contours of 0
-	intersectWith( *this );
-}
-
-
-RmPolygon::RmPolygon( const gpc_polygon &polygon )
-{
-	createFrom( polygon );
-}
-
-
-RmPolygon::RmPolygon( const RmPolygon &polygon )
-{
-	createFrom( polygon.m_polygon );
-}
-
-
-RmPolygon::~RmPolygon()
-{
-	free();
-}
-
-
-RmPolygon& RmPolygon::operator=( const RmPolygon &polygon )
-{
-	free();
-	createFrom( polygon.m_polygon );
-	return *this;
-}
-
-
-void RmPolygon::createFrom( const gpc_polygon &polygon )
-{
-	// Modeled after 
-	// void gpc::gpc_read_polygon(FILE *fp, int read_hole_flags, gpc_polygon *p)
-
-	gpc_polygon *p = &m_polygon;
-	p->num_contours = polygon.num_contours;
-	p->hole = new int[p->num_contours];
-	p->contour = new gpc_vertex_list[p->num_contours];
-	for ( int c = 0; c < p->num_contours; ++c ) {
-		p->hole[c] = polygon.hole[c];
-		p->contour[c].num_vertices = polygon.contour[c].num_vertices;
-		p->contour[c].vertex = new gpc_vertex[p->contour[c].num_vertices];
-		for ( int v = 0; v < p->contour[c].num_vertices; ++v ) {
-			p->contour[c].vertex[v] = polygon.contour[c].vertex[v];
-		}
-	}
-}
-
-
-void RmPolygon::free()
-{
-	// Modeled after 
-	// void gpc::gpc_free_polygon(gpc_polygon *p)
-
-	for ( int c = 0; c < m_polygon.num_contours; ++c ) {
-		delete [] m_polygon.contour[c].vertex;
-	}
-	delete [] m_polygon.contour;
-	delete [] m_polygon.hole;
-}
-
-
-RmPolygon& RmPolygon::intersectWith( const RmPolygon &polygon )
-{
-	RmPolygon clip( polygon );
-	gpc_polygon_clip( GPC_INT, &m_polygon, &clip.m_polygon, &m_polygon );
-	return *this;
-}
-
-
-RmPolygon RmPolygon::intersectedWith( const RmPolygon &clip ) const
-{
-	RmPolygon subj( *this );
-	return subj.intersectWith( clip );
-}
-
-
-RmPolygon& RmPolygon::subtractOut( const RmPolygon &polygon )
-{
-	RmPolygon clip( polygon );
-	gpc_polygon_clip( GPC_DIFF, &m_polygon, &clip.m_polygon, &m_polygon );
-	return *this;
-}
-
-
-RmPolygon RmPolygon::subtractedOut( const RmPolygon &clip ) const
-{
-	RmPolygon subj( *this );
-	return subj.subtractOut( clip );
-}
-
-
-RmPolygon& RmPolygon::unionWith( const RmPolygon &polygon )
-{
-	RmPolygon clip( polygon );
-	gpc_polygon_clip( GPC_UNION, &m_polygon, &clip.m_polygon, &m_polygon );
-	return *this;
-}
-
-
-RmPolygon RmPolygon::unionedWith( const RmPolygon &clip ) const
-{
-	RmPolygon subj( *this );
-	return subj.unionWith( clip );
-}
-
-
-std::ostream& RmPolygon::put( std::ostream &os ) const
-{
-	os << m_polygon.num_contours << "\n";
-	for ( int c = 0; c < m_polygon.num_contours; ++c ) {
-		os << m_polygon.contour[c].num_vertices << "\n";
-		os << m_polygon.hole[c] << "\n";
-		for ( int v = 0; v < m_polygon.contour[c].num_vertices; ++v ) {
-			os << "  " << m_polygon.contour[c].vertex[v].x << " " 
-				<< m_polygon.contour[c].vertex[v].y << "\n";
-		}
-	}
-
-	return os;
-}
-
-
-std::ostream& operator<<( std::ostream &os, const RmPolygon &p )
-{
-	return p.put( os );
-}
-
-
-void RmPolygon::fillInto( std::vector<Coord> *fv ) const
-{
-	// For each contour polygon
-	for ( int c = 0; c < m_polygon.num_contours; ++c )
-	{
-		// Skip holes
-		if ( m_polygon.hole[c] ) continue; 
-
-		// Convert points for use by polyfill routine
-		struct Point *points = new Point[m_polygon.contour[c].num_vertices];
-		for ( int v = 0; v < m_polygon.contour[c].num_vertices; ++v ) {
-			points[v].X = static_cast<int>(m_polygon.contour[c].vertex[v].x);
-			points[v].Y = static_cast<int>(m_polygon.contour[c].vertex[v].y);
-		}
-
-		PointListHeader pointListHeader = { m_polygon.contour[c].num_vertices, points };
-
-		// Fill contour
-		PointList *fill = FillPolygon( 
-			&pointListHeader, 0 /*color*/, NONCONVEX, 0 /*x-offset*/, 0 /*y-offset*/ );
-
-		// Push into vector
-		while ( fill ) {
-			fv->push_back( Coord( fill->point.X, fill->point.Y ) );
-			fill = fill->next;
-		}
-	}
-}
-
-
-std::vector<Coord> RmPolygon::fill() const
-{
-	std::vector<Coord> fill;
-	fillInto( &fill );
-	return fill;
-}
-
-
-std::vector<Coord> RmPolygon::line( const Coord &from, const Coord &to )
-{
-	std::vector<Coord> line;
-	PointList* linePointList = FillLine( from.x, from.y, to.x, to.y );  // [start..end)
-	while ( linePointList ) 
-	{
-		line.push_back( Coord( linePointList->point.X, linePointList->point.Y ) );
-		linePointList = linePointList->next;
-	}
-
-	return line;
-}
+// RmPolygon.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <algorithm>
+#include "RmPolygon.h"
+#include "RmBinaryIO.h"
+using RmUtility::Coord;
+
+RmPolygon::RmPolygon()
+	: m_storage(NULL)
+{
+	m_polygon.num_contours = 0;
+	m_polygon.hole = NULL;
+	m_polygon.contour = NULL;
+}
+
+
+RmPolygon::RmPolygon( const RmUtility::BoundBox &bound )
+	: m_storage(NULL)
+{
+	gpc_vertex vertex[4];
+	vertex[0].x = bound.ul.x;
+	vertex[0].y = bound.ul.y;
+	vertex[1].x = bound.lr.x;
+	vertex[1].y = bound.ul.y;
+	vertex[2].x = bound.lr.x;
+	vertex[2].y = bound.lr.y;
+	vertex[3].x = bound.ul.x;
+	vertex[3].y = bound.lr.y;
+
+	// Have native polygon code validate this bound, clipping it against itself, each within
+	// a polygon of its own since gpc flags the contours of each as it clips
+	// If invalid, will have num_contours of 0
+	int hole = 0;
+	gpc_vertex_list subjContour = { 4, vertex }, clipContour = { 4, vertex };
+	gpc_polygon subj = { 1, &hole, &subjContour }, clip = { 1, &hole, &clipContour };
+	m_polygon.num_contours = 0;
+	this->clip( GPC_INT, subj, clip );
+}
+
+
+RmPolygon::RmPolygon( const gpc_polygon &polygon )
+{
+	createFrom( polygon );
+}
+
+
+RmPolygon::RmPolygon( const RmPolygon &polygon )
+{
+	createFrom( polygon.m_polygon );
+}
+
+
+RmPolygon::~RmPolygon()
+{
+	free();
+}
+
+
+RmPolygon& RmPolygon::operator=( const RmPolygon &polygon )
+{
+	if ( this != &polygon ) {
+		free();
+		createFrom( polygon.m_polygon );
+	}
+	return *this;
+}
+
+
+void RmPolygon::swap( RmPolygon &polygon )
+{
+	std::swap( m_polygon, polygon.m_polygon );
+	std::swap( m_storage, polygon.m_storage );
+}
+
+
+void RmPolygon::createFrom( const gpc_polygon &polygon )
+{
+	// Whereas gpc allocates the hole flags, contours, and the vertices of each contour 
+	// separately, they are packed into a single allocation, the vertices first so that each
+	// of the three is aligned
+	const int numContours = polygon.num_contours;
+	int numVertices = 0;
+	int c;
+	for ( c = 0; c < numContours; ++c ) numVertices += polygon.contour[c].num_vertices;
+	const int tail = numContours * (sizeof(gpc_vertex_list) + sizeof(int));
+	m_storage = numContours == 0 ? NULL : 
+		new gpc_vertex[numVertices + (tail + sizeof(gpc_vertex) - 1) / sizeof(gpc_vertex)];
+
+	gpc_polygon *p = &m_polygon;
+	p->num_contours = numContours;
+	p->contour = numContours == 0 ? NULL : reinterpret_cast<gpc_vertex_list*>(m_storage + numVertices);
+	p->hole = numContours == 0 ? NULL : reinterpret_cast<int*>(p->contour + numContours);
+	gpc_vertex *vertex = m_storage;
+	for ( c = 0; c < numContours; ++c ) {
+		p->hole[c] = polygon.hole[c];
+		p->contour[c].num_vertices = polygon.contour[c].num_vertices;
+		p->contour[c].vertex = vertex;
+		for ( int v = 0; v < p->contour[c].num_vertices; ++v ) {
+			p->contour[c].vertex[v] = polygon.contour[c].vertex[v];
+		}
+		vertex += p->contour[c].num_vertices;
+	}
+}
+
+
+void RmPolygon::free()
+{
+	delete [] m_storage;
+	m_storage = NULL;
+	m_polygon.num_contours = 0;
+	m_polygon.hole = NULL;
+	m_polygon.contour = NULL;
+}
+
+
+RmPolygon& RmPolygon::clip( gpc_op op, const gpc_polygon &subj, const gpc_polygon &clip )
+{
+	// gpc flags the contours of both subj and clip that cannot contribute to the result by 
+	// negating their vertex counts, restoring each before it returns, so neither need be copied
+	// (though neither may be clipped concurrently); its result, allocated contour by contour,
+	// is packed before being kept
+	gpc_polygon result;
+	gpc_polygon_clip( op, const_cast<gpc_polygon*>(&subj), const_cast<gpc_polygon*>(&clip), &result );
+
+	// The storage of subj is released only once the result is packed, as it may be this
+	gpc_vertex *storage = m_storage;
+	try {
+		createFrom( result );
+	}
+	catch ( ... ) {
+		gpc_free_polygon( &result );
+		throw;
+	}
+	delete [] storage;
+	gpc_free_polygon( &result );
+
+	return *this;
+}
+
+
+RmPolygon& RmPolygon::intersectWith( const RmPolygon &polygon )
+{
+	return clip( GPC_INT, m_polygon, polygon.m_polygon );
+}
+
+
+RmPolygon RmPolygon::intersectedWith( const RmPolygon &polygon ) const
+{
+	RmPolygon result;
+	result.clip( GPC_INT, m_polygon, polygon.m_polygon );
+	return result;
+}
+
+
+RmPolygon& RmPolygon::subtractOut( const RmPolygon &polygon )
+{
+	return clip( GPC_DIFF, m_polygon, polygon.m_polygon );
+}
+
+
+RmPolygon RmPolygon::subtractedOut( const RmPolygon &polygon ) const
+{
+	RmPolygon result;
+	result.clip( GPC_DIFF, m_polygon, polygon.m_polygon );
+	return result;
+}
+
+
+RmPolygon& RmPolygon::unionWith( const RmPolygon &polygon )
+{
+	return clip( GPC_UNION, m_polygon, polygon.m_polygon );
+}
+
+
+RmPolygon RmPolygon::unionedWith( const RmPolygon &polygon ) const
+{
+	RmPolygon result;
+	result.clip( GPC_UNION, m_polygon, polygon.m_polygon );
+	return result;
+}
+
+
+unsigned long RmPolygon::allocatedBytes() const
+{
+	unsigned long bytes = m_polygon.num_contours * (sizeof(int) + sizeof(gpc_vertex_list));
+	for ( int c = 0; c < m_polygon.num_contours; ++c ) {
+		bytes += m_polygon.contour[c].num_vertices * sizeof(gpc_vertex);
+	}
+	return bytes;
+}
+
+
+std::ostream& RmPolygon::put( std::ostream &os ) const
+{
+	os << m_polygon.num_contours << "\n";
+	for ( int c = 0; c < m_polygon.num_contours; ++c ) {
+		os << m_polygon.contour[c].num_vertices << "\n";
+		os << m_polygon.hole[c] << "\n";
+		for ( int v = 0; v < m_polygon.contour[c].num_vertices; ++v ) {
+			os << "  " << m_polygon.contour[c].vertex[v].x << " " 
+				<< m_polygon.contour[c].vertex[v].y << "\n";
+		}
+	}
+
+	return os;
+}
+
+
+std::ostream& operator<<( std::ostream &os, const RmPolygon &p )
+{
+	return p.put( os );
+}
+
+
+void RmPolygon::write( std::ostream &os ) const
+{
+	RmBinaryIO::write( os, m_polygon.num_contours );
+	for ( int c = 0; c < m_polygon.num_contours; ++c ) {
+		RmBinaryIO::write( os, m_polygon.hole[c] );
+		RmBinaryIO::write( os, m_polygon.contour[c].num_vertices );
+		RmBinaryIO::writeArray( os, m_polygon.contour[c].vertex, m_polygon.contour[c].num_vertices );
+	}
+}
+
+
+void RmPolygon::read( std::istream &is )
+{
+	// Read into a temporary so that this polygon is left intact should the stream fail
+	int numContours;
+	RmBinaryIO::read( is, numContours );
+	if ( numContours < 0 ) {
+		throw RmExceptions::IOException( "RmPolygon::read()", "Invalid contour count" );
+	}
+
+	std::vector<int> holes( numContours );
+	std::vector< std::vector<gpc_vertex> > vertices( numContours );
+	std::vector<gpc_vertex_list> contours( numContours );
+	for ( int c = 0; c < numContours; ++c ) 
+	{
+		int numVertices;
+		RmBinaryIO::read( is, holes[c] );
+		RmBinaryIO::read( is, numVertices );
+		if ( numVertices < 0 ) {
+			throw RmExceptions::IOException( "RmPolygon::read()", "Invalid vertex count" );
+		}
+		vertices[c].resize( numVertices );
+		if ( numVertices > 0 ) RmBinaryIO::readArray( is, &vertices[c][0], numVertices );
+		contours[c].num_vertices = numVertices;
+		contours[c].vertex = numVertices == 0 ? NULL : &vertices[c][0];
+	}
+
+	gpc_polygon polygon = { numContours, numContours == 0 ? NULL : &holes[0],
+		numContours == 0 ? NULL : &contours[0] };
+	free();
+	createFrom( polygon );
+}
+
+
+void RmPolygon::fillInto( std::vector<Coord> *fv ) const
+{
+	// For each contour polygon, converting its points into a buffer shared by all
+	std::vector<struct Point> points;
+	for ( int c = 0; c < m_polygon.num_contours; ++c )
+	{
+		// Skip holes
+		if ( m_polygon.hole[c] || m_polygon.contour[c].num_vertices == 0 ) continue; 
+
+		// Convert points for use by polyfill routine
+		points.resize( m_polygon.contour[c].num_vertices );
+		for ( int v = 0; v < m_polygon.contour[c].num_vertices; ++v ) {
+			points[v].X = static_cast<int>(m_polygon.contour[c].vertex[v].x);
+			points[v].Y = static_cast<int>(m_polygon.contour[c].vertex[v].y);
+		}
+
+		PointListHeader pointListHeader = { m_polygon.contour[c].num_vertices, &points[0] };
+
+		// Fill contour
+		ScopedDrawContext draw;
+		PointList *fill = FillPolygon( 
+			&draw, &pointListHeader, 0 /*color*/, NONCONVEX, 0 /*x-offset*/, 0 /*y-offset*/ );
+
+		// Push into vector
+		while ( fill ) {
+			fv->push_back( Coord( fill->point.X, fill->point.Y ) );
+			fill = fill->next;
+		}
+	}
+}
+
+
+std::vector<Coord> RmPolygon::fill() const
+{
+	std::vector<Coord> fill;
+	fillInto( &fill );
+	return fill;
+}
+
+
+std::vector<Coord> RmPolygon::line( const Coord &from, const Coord &to )
+{
+	std::vector<Coord> line;
+	ScopedDrawContext draw;
+	PointList* linePointList = FillLine( &draw, from.x, from.y, to.x, to.y );  // [start..end)
+	while ( linePointList ) 
+	{
+		line.push_back( Coord( linePointList->point.X, linePointList->point.Y ) );
+		linePointList = linePointList->next;
+	}
+
+	return line;
+}
@@ -1,108 +1,142 @@
-// RmServer.cpp
-
-#include <iostream>
-#include "RmServer.h"
-#include "RmExceptions.h"
-
-
-RmServer::RmServer( const short portNumber, const std::string name )
-: m_name(name)
-{
-	WORD wVersionRequested = MAKEWORD(1,1);
-   	WSADATA wsaData;
-    int nRet = WSAStartup(wVersionRequested, &wsaData);
-	if (wsaData.wVersion != wVersionRequested)
-	{	
-		throw RmExceptions::SocketException( "RmServer::RmServer()", "Wrong version" );
-	}
-	
-	initServer( portNumber );
-}
-
-
-RmServer::~RmServer()
-{
-	closesocket( m_socket );
-}
-
-
-int RmServer::initServer( const short portNumber )
-{
-	int nRet;
-	char temp[15] = "";
-	int stopflag = 1;
-	
-	//
-	// Create a UDP/IP datagram socket
-	//
-	m_socket = socket(AF_INET,		// Address family
-					   SOCK_DGRAM,  // Socket type
-					   IPPROTO_UDP);// Protocol
-	if (m_socket == INVALID_SOCKET)
-	{
-		throw RmExceptions::SocketException( "RmServer::initServer()", "Invalid socket" );
-	}
-	
-	
-	//
-	// Fill in the address structure
-	//
-	m_serverAddress.sin_family = AF_INET;
-	m_serverAddress.sin_addr.s_addr = INADDR_ANY;		// Let WinSock assign address
-	m_serverAddress.sin_port = htons(portNumber);		// Use port passed from user
-	
-	//
-	// Bind the server to the socket
-	//
-	nRet = bind(m_socket, (LPSOCKADDR)&m_serverAddress, sizeof(SOCKADDR) );
-	if (nRet == SOCKET_ERROR)
-	{
-		closesocket(m_socket);
-		throw RmExceptions::SocketException( "RmServer::initServer()", "Unable to bind socket" );
-	}
-	
-	
-	//
-	// Verify connection
-	//
-	nRet = gethostname(m_szBuf, sizeof(m_szBuf));
-	if (nRet == SOCKET_ERROR)
-	{
-		closesocket(m_socket);
-		throw RmExceptions::SocketException( "RmServer::initServer()", "Unable to get host name" );
-	}
-	
-	std::cout << m_name << " '" << m_szBuf << "' waiting on port " << portNumber << "\n";
-	
-	return nRet;
-}
-
-
-std::string RmServer::getClientString() 
-{
-	int nLen = sizeof(SOCKADDR);
-	memset( m_szBuf, 0, sizeof(m_szBuf) );
-	int nRet = recvfrom( m_socket, m_szBuf, sizeof(m_szBuf), 0, (LPSOCKADDR)&m_clientAddress, &nLen );
-	return std::string( m_szBuf );
-}
-
-
-void RmServer::sendClientReply( const std::string s )
-{
-	int nRet = sendto( m_socket, s.c_str(), s.length(), 0, (LPSOCKADDR)&m_clientAddress, 
-		sizeof(SOCKADDR) );
-	if ( nRet == SOCKET_ERROR ) {
-		const char *m = message( "Socket error" );
-		throw RmExceptions::SocketException( "RmServer::sendReply()", m );
-	}
-}
-
-const char* RmServer::message( const char *msg ) const
-{
-	static const std::string pre( " [" );
-	static const std::string suf( "]" );
-	std::string m = msg + pre + m_name + suf;
-	char *cmsg = new char[m.length() + 1];
-	strcpy( cmsg, m.c_str() );
-	return cmsg;
-}
\ No newline at end of file
+// RmServer.cpp
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include "RmServer.h"
+#include "RmExceptions.h"
+#include "RmInstrument.h"
+
+
+RmServer::RmServer( const short portNumber, const std::string name )
+: m_name(name)
+{
+	RmSocket::startup( "RmServer::RmServer()" );
+
+	try {
+		initServer( portNumber );
+	}
+	catch ( RmExceptions::Exception ) {
+		RmSocket::cleanup();
+		throw;
+	}
+}
+
+
+RmServer::~RmServer()
+{
+	RmSocket::close( m_socket );
+	RmSocket::cleanup();
+}
+
+
+int RmServer::initServer( const short portNumber )
+{
+	int nRet;
+	char temp[15] = "";
+	int stopflag = 1;
+	
+	//
+	// Create a UDP/IP datagram socket
+	//
+	m_socket = socket(AF_INET,		// Address family
+					   SOCK_DGRAM,  // Socket type
+					   IPPROTO_UDP);// Protocol
+	if (m_socket == RmSocket::InvalidSocket)
+	{
+		throw RmExceptions::SocketException( "RmServer::initServer()", "Invalid socket" );
+	}
+	
+	
+	//
+	// Fill in the address structure
+	//
+	memset( &m_serverAddress, 0, sizeof(m_serverAddress) );
+	m_serverAddress.sin_family = AF_INET;
+	m_serverAddress.sin_addr.s_addr = INADDR_ANY;		// Let the socket library assign address
+	m_serverAddress.sin_port = htons(portNumber);		// Use port passed from user
+	
+	//
+	// Bind the server to the socket
+	//
+	nRet = bind(m_socket, (sockaddr*)&m_serverAddress, sizeof(m_serverAddress) );
+	if (nRet < 0)
+	{
+		RmSocket::close(m_socket);
+		throw RmExceptions::SocketException( "RmServer::initServer()", "Unable to bind socket" );
+	}
+	
+	
+	//
+	// Verify connection
+	//
+	nRet = gethostname(m_szBuf, sizeof(m_szBuf));
+	if (nRet < 0)
+	{
+		RmSocket::close(m_socket);
+		throw RmExceptions::SocketException( "RmServer::initServer()", "Unable to get host name" );
+	}
+	
+	std::cout << m_name << " '" << m_szBuf << "' waiting on port " << portNumber << "\n";
+	
+	return nRet;
+}
+
+
+std::string RmServer::getClientString() 
+{
+	std::string s;
+	pollClientString( s, RmSocket::Forever ); // leaves s empty if nothing was received
+	return s;
+}
+
+
+bool RmServer::pollClientString( std::string &s, int timeout )
+{
+	if ( RmSocket::waitReadable( &m_socket, 1, timeout ) < 0 ) return false;
+
+	RmSocket::AddressLength nLen = sizeof(m_clientAddress);
+	int nRet = recvfrom( m_socket, m_szBuf, sizeof(m_szBuf) - 1, 0, (sockaddr*)&m_clientAddress, 
+		&nLen );
+	if ( nRet < 0 ) return false; // as when a datagram sent earlier was refused by its client
+	m_szBuf[nRet] = '\0';
+	s = m_szBuf;
+	return true;
+}
+
+
+void RmServer::sendClientReply( const std::string s )
+{
+	RM_INSTRUMENT_TIMER( RmInstrument::SendClientReply );
+	sendClientData( s.c_str(), s.length() );
+}
+
+
+void RmServer::sendClientData( const char *data, int length )
+{
+	int nRet = sendto( m_socket, data, length, 0, (sockaddr*)&m_clientAddress, 
+		sizeof(m_clientAddress) );
+	if ( nRet < 0 ) {
+		const char *m = message( "Socket error" );
+		throw RmExceptions::SocketException( "RmServer::sendReply()", m );
+	}
+	RM_INSTRUMENT_COUNT( RmInstrument::BytesSent, nRet );
+}
+
+const char* RmServer::message( const char *msg ) const
+{
+	static const std::string pre( " [" );
+	static const std::string suf( "]" );
+	std::string m = msg + pre + m_name + suf;
+	char *cmsg = new char[m.length() + 1];
+	strcpy( cmsg, m.c_str() );
+	return cmsg;
+}
+
+
+int RmServer::waitForClient( RmServer *const *servers, int count, int timeout )
+{
+	std::vector<RmSocket::Socket> sockets( count );
+	for ( int i = 0; i < count; ++i ) sockets[i] = servers[i]->m_socket;
+	return count == 0 ? -1 : RmSocket::waitReadable( &sockets[0], count, timeout );
+}
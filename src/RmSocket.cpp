@@ -0,0 +1,104 @@
+// RmSocket.cpp
+
+#include "RmSocket.h"
+#include "RmExceptions.h"
+
+#ifndef WIN32
+#include <errno.h>
+#include <fcntl.h>
+#endif
+
+
+#ifdef WIN32
+const RmSocket::Socket RmSocket::InvalidSocket = INVALID_SOCKET;
+#else
+const RmSocket::Socket RmSocket::InvalidSocket = -1;
+#endif
+
+
+void RmSocket::cleanup()
+{
+#ifdef WIN32
+	WSACleanup(); // release WinSock
+#endif
+}
+
+
+void RmSocket::close( Socket s )
+{
+#ifdef WIN32
+	closesocket( s );
+#else
+	::close( s );
+#endif
+}
+
+
+void RmSocket::setNonBlocking( Socket s )
+{
+#ifdef WIN32
+	unsigned long on = 1;
+	const int nRet = ioctlsocket( s, FIONBIO, &on );
+#else
+	const int flags = fcntl( s, F_GETFL, 0 );
+	const int nRet = flags < 0 ? flags : fcntl( s, F_SETFL, flags | O_NONBLOCK );
+#endif
+	if ( nRet < 0 ) {
+		throw RmExceptions::SocketException( "RmSocket::setNonBlocking()", "Unable to set mode" );
+	}
+}
+
+
+void RmSocket::startup( const char *caller )
+{
+#ifdef WIN32
+	WORD wVersionRequested = MAKEWORD(1,1);
+	WSADATA wsaData;
+	WSAStartup( wVersionRequested, &wsaData );
+	if ( wsaData.wVersion != wVersionRequested ) {
+		WSACleanup();
+		throw RmExceptions::SocketException( caller, "Wrong version" );
+	}
+#endif
+}
+
+
+int RmSocket::waitReadable( const Socket *sockets, int count, int timeout )
+{
+	fd_set readable;
+	FD_ZERO( &readable );
+	Socket maxSocket = 0;
+	int i;
+	for ( i = 0; i < count; ++i ) {
+		FD_SET( sockets[i], &readable );
+		if ( sockets[i] > maxSocket ) maxSocket = sockets[i];
+	}
+
+	timeval tv;
+	tv.tv_sec = timeout / 1000;
+	tv.tv_usec = (timeout % 1000) * 1000;
+
+	// The first argument is ignored by WinSock
+	const int nRet = select( maxSocket + 1, &readable, NULL, NULL, timeout < 0 ? NULL : &tv );
+	if ( nRet < 0 ) {
+#ifndef WIN32
+		if ( errno == EINTR ) return -1;
+#endif
+		throw RmExceptions::SocketException( "RmSocket::waitReadable()", "Socket error" );
+	}
+
+	for ( i = 0; nRet > 0 && i < count; ++i ) {
+		if ( FD_ISSET( sockets[i], &readable ) ) return i;
+	}
+	return -1;
+}
+
+
+bool RmSocket::wouldBlock()
+{
+#ifdef WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EWOULDBLOCK || errno == EAGAIN;
+#endif
+}
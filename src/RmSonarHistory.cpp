@@ -0,0 +1,145 @@
+// RmSonarHistory.cpp
+
+#include "RmSonarHistory.h"
+#include "RmBinaryIO.h"
+#include "RmExceptions.h"
+
+using RmUtility::Coord;
+using RmUtility::Pose;
+using RmUtility::SonarReading;
+
+
+/**
+ * Returns the given range clamped to that held by a sweep.
+ */
+static unsigned short heldRange( int range )
+{
+	return static_cast<unsigned short>(range < 0 ? 0 : range > 65535 ? 65535 : range);
+}
+
+
+RmSonarHistory::const_iterator::const_iterator( const Sweep *sweep, const Sweep *end )
+	: m_sweep(sweep), m_end(end), m_sonar(0)
+{
+	if ( m_sweep == m_end ) {
+		m_sonar = NUM_SONARS;
+		return;
+	}
+	seek( 0 );
+}
+
+
+void RmSonarHistory::const_iterator::seek( int sonar )
+{
+	// Upon entering a sweep, its pose and ranges are shared by each of its readings
+	if ( sonar == 0 ) {
+		m_reading.robotPose = m_sweep->robotPose;
+		for ( int i = 0; i < NUM_SONARS; ++i ) m_reading.all[i] = m_sweep->ranges[i];
+	}
+
+	for ( m_sonar = sonar; m_sonar < NUM_SONARS; ++m_sonar ) {
+		if ( m_sweep->sonars & (1 << m_sonar) ) break;
+	}
+	m_reading.sonarNumber = m_sonar;
+	if ( m_sonar < NUM_SONARS ) m_reading.distance = m_reading.all[m_sonar];
+}
+
+
+RmSonarHistory::const_iterator& RmSonarHistory::const_iterator::operator++()
+{
+	seek( m_sonar + 1 );
+
+	// Every sweep holds at least one reading, so the next sweep, if any, begins with one
+	if ( m_sonar == NUM_SONARS && ++m_sweep != m_end ) seek( 0 );
+	return *this;
+}
+
+
+void RmSonarHistory::push_back( const SonarReading &reading )
+{
+	const int sonar = reading.sonarNumber;
+
+	// Part of the last sweep if taken at its pose with its ranges by a sonar following
+	// any it has read
+	bool sweep = !m_sweeps.empty();
+	if ( sweep )
+	{
+		const Sweep &last = m_sweeps.back();
+		sweep = (last.sonars >> sonar) == 0 && last.robotPose == reading.robotPose;
+		for ( int i = 0; sweep && i < NUM_SONARS; ++i ) {
+			sweep = last.ranges[i] == heldRange( reading.all[i] );
+		}
+	}
+
+	if ( !sweep )
+	{
+		m_sweeps.push_back( Sweep() );
+		Sweep &next = m_sweeps.back();
+		next.robotPose = reading.robotPose;
+		next.sonars = 0;
+		for ( int i = 0; i < NUM_SONARS; ++i ) next.ranges[i] = heldRange( reading.all[i] );
+	}
+
+	m_sweeps.back().sonars |= 1 << sonar;
+	++m_size;
+}
+
+
+RmSonarHistory::const_iterator RmSonarHistory::begin() const
+{
+	return m_sweeps.empty() ? const_iterator( NULL, NULL ) :
+		const_iterator( &m_sweeps.front(), &m_sweeps.front() + m_sweeps.size() );
+}
+
+
+RmSonarHistory::const_iterator RmSonarHistory::end() const
+{
+	const Sweep *end = m_sweeps.empty() ? NULL : &m_sweeps.front() + m_sweeps.size();
+	return const_iterator( end, end );
+}
+
+
+void RmSonarHistory::reorientBy( const Pose &shift, const Coord &pivot )
+{
+	for ( std::vector<Sweep>::iterator sweep = m_sweeps.begin(); sweep != m_sweeps.end(); ++sweep )
+	{
+		sweep->robotPose += shift;
+		sweep->robotPose.coord.rotateBy( shift.theta, pivot );
+	}
+}
+
+
+void RmSonarHistory::release()
+{
+	// Swapped rather than cleared, which would retain the capacity
+	std::vector<Sweep>().swap( m_sweeps );
+	m_size = 0;
+}
+
+
+void RmSonarHistory::write( std::ostream &os ) const
+{
+	RmBinaryIO::write( os, m_size );
+	for ( const_iterator reading = begin(); reading != end(); ++reading ) {
+		RmBinaryIO::write( os, *reading );
+	}
+}
+
+
+void RmSonarHistory::read( std::istream &is )
+{
+	release();
+
+	int n;
+	RmBinaryIO::read( is, n );
+	if ( n < 0 ) throw RmExceptions::IOException( "RmSonarHistory::read()", "Invalid history length" );
+	SonarReading reading;
+	for ( int i = 0; i < n; ++i )
+	{
+		RmBinaryIO::read( is, reading );
+		if ( reading.sonarNumber < 0 || reading.sonarNumber >= NUM_SONARS ) {
+			throw RmExceptions::IOException( "RmSonarHistory::read()", "Invalid sonar number" );
+		}
+		push_back( reading );
+	}
+}
@@ -1,8 +1,8 @@
-// RmSonarMap.cpp
-
-#include "RmSonarMap.h"
-
-std::ostream& operator<<( std::ostream& os, const RmSonarMap& map )
-{
-	return map.put( os );
+// RmSonarMap.cpp
+
+#include "RmSonarMap.h"
+
+std::ostream& operator<<( std::ostream& os, const RmSonarMap& map )
+{
+	return map.put( os );
 }
\ No newline at end of file
@@ -0,0 +1,264 @@
+// RmSonarSimulator.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include "RmSonarSimulator.h"
+#include "RmPioneerController.h"
+
+using RmUtility::Coord;
+using RmUtility::RadianFactor;
+using RmUtility::SonarReading;
+
+
+const int RmSonarSimulator::MaxRange = 5000;
+
+
+RmSonarSimulator::RmSonarSimulator( unsigned long seed )
+: m_x( 0 ), m_y( 0 ), m_th( 0 ), m_odoX( 0 ), m_odoY( 0 ), m_odoTh( 0 ),
+  m_distanceScale( 0 ), m_turnScale( 0 ), m_drift( 0 ), m_distanceSigma( 0 ), m_turnSigma( 0 ),
+  m_rangeSigma( 0 ), m_dropout( 0 ), m_beamWidth( 0 ), m_random( seed )
+{
+}
+
+
+void RmSonarSimulator::addPolygon( const std::vector<Coord> &vertices )
+{
+	for ( unsigned int v = 0; v < vertices.size(); ++v ) {
+		const Coord &a = vertices[v];
+		const Coord &b = vertices[(v + 1) % vertices.size()];
+		m_walls.push_back( Wall( a.x, a.y, b.x, b.y ) );
+	}
+}
+
+
+void RmSonarSimulator::addRaster( const std::vector<std::string> &rows, int cellSize )
+{
+	static const char *signature_ = "RmSonarSimulator::addRaster()";
+	if ( cellSize <= 0 ) throw RmExceptions::InvalidParameterException( signature_,
+		"Cell size must be positive" );
+	if ( rows.empty() ) return;
+
+	const int h = static_cast<int>(rows.size());
+	const int w = static_cast<int>(rows[0].length());
+	int r;
+	for ( r = 0; r < h; ++r ) {
+		if ( static_cast<int>(rows[r].length()) != w ) {
+			throw RmExceptions::InvalidParameterException( signature_,
+				"Raster rows must be of the same width" );
+		}
+	}
+
+	const double left = -w * cellSize / 2.0, top = h * cellSize / 2.0;
+	for ( r = 0; r < h; ++r ) {
+		for ( int c = 0; c < w; ++c )
+		{
+			if ( rows[r][c] != '#' ) continue;
+
+			const double x1 = left + c * cellSize, x2 = x1 + cellSize;
+			const double y1 = top - r * cellSize, y2 = y1 - cellSize;
+			if ( r == 0 || rows[r-1][c] != '#' ) m_walls.push_back( Wall( x1, y1, x2, y1 ) );
+			if ( r == h-1 || rows[r+1][c] != '#' ) m_walls.push_back( Wall( x1, y2, x2, y2 ) );
+			if ( c == 0 || rows[r][c-1] != '#' ) m_walls.push_back( Wall( x1, y1, x1, y2 ) );
+			if ( c == w-1 || rows[r][c+1] != '#' ) m_walls.push_back( Wall( x2, y1, x2, y2 ) );
+		}
+	}
+}
+
+
+void RmSonarSimulator::readFloorPlan( std::istream &is )
+{
+	static const char *signature_ = "RmSonarSimulator::readFloorPlan()";
+
+	std::string line;
+	bool more = !std::getline( is, line ).fail();
+	while ( more )
+	{
+		// Skip comments and blank lines between sections
+		if ( line.empty() || line[0] == '%' ) {
+			more = !std::getline( is, line ).fail();
+			continue;
+		}
+
+		std::istringstream header( line );
+		std::string kind;
+		header >> kind;
+
+		if ( kind == "polygon" )
+		{
+			std::vector<Coord> vertices;
+			while ( (more = !std::getline( is, line ).fail()) && !line.empty() ) {
+				if ( line[0] == '%' ) continue;
+				std::istringstream vertex( line );
+				Coord v;
+				if ( !(vertex >> v.x >> v.y) ) {
+					throw RmExceptions::IOException( signature_, "Invalid polygon vertex" );
+				}
+				vertices.push_back( v );
+			}
+			if ( vertices.size() < 2 ) {
+				throw RmExceptions::IOException( signature_, "Polygon has too few vertices" );
+			}
+			addPolygon( vertices );
+		}
+
+		else if ( kind == "raster" )
+		{
+			int cellSize;
+			if ( !(header >> cellSize) || cellSize <= 0 ) {
+				throw RmExceptions::IOException( signature_, "Invalid raster cell size" );
+			}
+			std::vector<std::string> rows;
+			while ( (more = !std::getline( is, line ).fail()) && !line.empty() ) {
+				if ( line[0] != '%' ) rows.push_back( line );
+			}
+			try {
+				addRaster( rows, cellSize );
+			}
+			catch ( RmExceptions::InvalidParameterException ) {
+				throw RmExceptions::IOException( signature_, "Raster rows differ in width" );
+			}
+		}
+
+		else throw RmExceptions::IOException( signature_, "Unrecognized floor plan section" );
+	}
+}
+
+
+void RmSonarSimulator::setOdometryError( double distanceScale, double turnScale, double drift,
+	double distanceSigma, double turnSigma )
+{
+	m_distanceScale = distanceScale;
+	m_turnScale = turnScale;
+	m_drift = drift;
+	m_distanceSigma = distanceSigma;
+	m_turnSigma = turnSigma;
+}
+
+
+void RmSonarSimulator::setSonarNoise( double sigma, double dropout, double beamWidth )
+{
+	m_rangeSigma = sigma;
+	m_dropout = dropout;
+	m_beamWidth = beamWidth;
+}
+
+
+void RmSonarSimulator::setPose( double x, double y, double th )
+{
+	m_odoX = m_x = x;
+	m_odoY = m_y = y;
+	m_odoTh = m_th = th;
+}
+
+
+void RmSonarSimulator::forward( double distance )
+{
+	m_x += distance * cos( m_th * RadianFactor );
+	m_y += distance * sin( m_th * RadianFactor );
+
+	m_odoTh += m_drift * fabs( distance ) / 1000;
+	const double odoDistance = distance * (1 + m_distanceScale) + m_distanceSigma * gaussian();
+	m_odoX += odoDistance * cos( m_odoTh * RadianFactor );
+	m_odoY += odoDistance * sin( m_odoTh * RadianFactor );
+}
+
+
+void RmSonarSimulator::turn( double theta )
+{
+	m_th += theta;
+	m_odoTh += theta * (1 + m_turnScale) + m_turnSigma * gaussian();
+}
+
+
+int RmSonarSimulator::range( int sonar )
+{
+	// The sonars are placed as by RmPioneerController::rangeReading(), whose angles are
+	// measured clockwise from the robot's heading, and so are subtracted here
+	const double sth = m_th - RmPioneerController::ThetaToSonar[sonar];
+	const double sx = m_x + RmPioneerController::DistToSonar[sonar] * cos( sth * RadianFactor );
+	const double sy = m_y + RmPioneerController::DistToSonar[sonar] * sin( sth * RadianFactor );
+	const double axis = m_th - RmPioneerController::SonarTheta[sonar];
+
+	double range = castRay( sx, sy, axis );
+	if ( m_beamWidth > 0 ) {
+		for ( int ray = -2; ray <= 2; ++ray ) {
+			if ( ray == 0 ) continue;
+			const double r = castRay( sx, sy, axis + ray * m_beamWidth / 4 );
+			if ( r < range ) range = r;
+		}
+	}
+
+	if ( m_dropout > 0 && uniform() < m_dropout ) return MaxRange;
+	if ( m_rangeSigma > 0 ) range += m_rangeSigma * gaussian();
+	return range < 0 ? 0 : range >= MaxRange ? MaxRange : static_cast<int>(range + 0.5);
+}
+
+
+SonarReading RmSonarSimulator::sweep()
+{
+	std::ostringstream os;
+	writeSweep( os );
+	std::string line( os.str() );
+	return SonarReading( &line[0] );
+}
+
+
+void RmSonarSimulator::writeSweep( std::ostream &os )
+{
+	// Heading recorded within (-180, 180], as by Aria
+	double th = fmod( m_odoTh, 360.0 );
+	if ( th > 180 ) th -= 360;
+	else if ( th <= -180 ) th += 360;
+
+	char buff[2*12 + 20];
+	sprintf( buff, "%d %d %.6f ", static_cast<int>(floor( m_odoX + 0.5 )),
+		static_cast<int>(floor( m_odoY + 0.5 )), th );
+	std::string line( buff );
+	for ( int i = 0; i < RmPioneerController::NumSonars; ++i ) {
+		sprintf( buff, "%d ", range( i ) );
+		line += buff;
+	}
+	os << line << "\n";
+}
+
+
+double RmSonarSimulator::castRay( double x, double y, double th ) const
+{
+	const double dx = cos( th * RadianFactor ), dy = sin( th * RadianFactor );
+
+	double nearest = MaxRange;
+	std::vector<Wall>::const_iterator wi;
+	for ( wi = m_walls.begin(); wi != m_walls.end(); ++wi )
+	{
+		// Solve (x, y) + t (dx, dy) = (x1, y1) + s (x2 - x1, y2 - y1) for t >= 0, 0 <= s <= 1
+		const double ex = wi->x2 - wi->x1, ey = wi->y2 - wi->y1;
+		const double denom = dx * ey - dy * ex;
+		if ( fabs( denom ) < 1e-12 ) continue; // parallel
+		const double qx = wi->x1 - x, qy = wi->y1 - y;
+		const double t = (qx * ey - qy * ex) / denom;
+		const double s = (qx * dy - qy * dx) / denom;
+		if ( t >= 0 && s >= 0 && s <= 1 && t < nearest ) nearest = t;
+	}
+	return nearest;
+}
+
+
+double RmSonarSimulator::uniform()
+{
+	// Linear congruential generator of Numerical Recipes, kept to 32 bits whatever the width
+	// of unsigned long, such that sequences are the same on every platform
+	m_random = (m_random * 1664525UL + 1013904223UL) & 0xFFFFFFFFUL;
+	return (m_random >> 8) / 16777216.0;
+}
+
+
+double RmSonarSimulator::gaussian()
+{
+	// Box-Muller transform
+	const double u1 = 1.0 - uniform(); // (0, 1]
+	const double u2 = uniform();
+	return sqrt( -2.0 * log( u1 ) ) * cos( 2 * 3.14159265358979 * u2 );
+}
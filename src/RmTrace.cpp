@@ -0,0 +1,181 @@
+// RmTrace.cpp
+
+#pragma warning( disable : 4786 )
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "Aria.h"
+#include "RmTrace.h"
+#include "RmExceptions.h"
+#include "RmInstrument.h"
+
+
+/** A single event, as held by the ring buffer */
+struct TraceEvent
+{
+	const char *name;
+	char phase; // 'B'egin, 'E'nd, or 'i'nstant, as per the Chrome trace event format
+	int thread;
+	double time; // microseconds since recording began
+	char args[RmTrace::MaxArgs + 1];
+};
+
+static std::vector<TraceEvent> events; // the ring buffer
+static unsigned int next = 0; // the index at which the next event is recorded
+static bool wrapped = false; // indicates the oldest events have been overwritten
+static volatile bool active = false;
+static double startTime = 0.0;
+static std::map<unsigned long,int> threads; // numbers each thread in order of its first event
+static ArMutex mutex; // serializes access to all of the above but active
+
+
+/**
+ * Returns the identifier of the calling thread, as given by the platform.
+ */
+static unsigned long threadId()
+{
+#ifdef WIN32
+	return GetCurrentThreadId();
+#else
+	return (unsigned long)pthread_self();
+#endif
+}
+
+
+/**
+ * Records an event of the given phase, if recording.
+ */
+static void record( const char *name, char phase, const char *args )
+{
+	if ( !active ) return;
+	const double now = RmInstrument::wallSeconds();
+	const unsigned long id = threadId();
+
+	mutex.lock();
+	if ( !events.empty() )
+	{
+		std::map<unsigned long,int>::const_iterator ti = threads.find( id );
+		int thread;
+		if ( ti != threads.end() ) thread = ti->second;
+		else {
+			thread = static_cast<int>(threads.size());
+			threads[id] = thread;
+		}
+
+		TraceEvent &e = events[next];
+		e.name = name;
+		e.phase = phase;
+		e.thread = thread;
+		e.time = (now - startTime) * 1e6;
+		e.args[0] = '\0';
+		if ( args != NULL ) {
+			strncpy( e.args, args, RmTrace::MaxArgs );
+			e.args[RmTrace::MaxArgs] = '\0';
+		}
+
+		if ( ++next == events.size() ) {
+			next = 0;
+			wrapped = true;
+		}
+	}
+	mutex.unlock();
+}
+
+
+void RmTrace::start( int capacity )
+{
+	mutex.lock();
+	events.clear();
+	events.resize( capacity < 1 ? 1 : capacity );
+	next = 0;
+	wrapped = false;
+	threads.clear();
+	startTime = RmInstrument::wallSeconds();
+	active = true;
+	mutex.unlock();
+}
+
+
+void RmTrace::stop()
+{
+	active = false;
+}
+
+
+bool RmTrace::recording()
+{
+	return active;
+}
+
+
+void RmTrace::begin( const char *name, const char *args )
+{
+	record( name, 'B', args );
+}
+
+
+void RmTrace::end( const char *name, const char *args )
+{
+	record( name, 'E', args );
+}
+
+
+void RmTrace::instant( const char *name, const char *args )
+{
+	record( name, 'i', args );
+}
+
+
+void RmTrace::write( std::ostream &os )
+{
+	mutex.lock();
+
+	os << "{\"traceEvents\":[\n";
+	os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Mapper\"}}";
+
+	// The stages open on each thread, such that an end whose beginning was overwritten
+	// is omitted
+	std::vector<int> depth( threads.size(), 0 );
+
+	char buff[100];
+	const unsigned int count = wrapped ? events.size() : next;
+	for ( unsigned int i = 0; i < count; ++i )
+	{
+		const TraceEvent &e = events[wrapped ? (next + i) % events.size() : i];
+		if ( e.phase == 'B' ) ++depth[e.thread];
+		else if ( e.phase == 'E' ) {
+			if ( depth[e.thread] == 0 ) continue;
+			--depth[e.thread];
+		}
+
+		sprintf( buff, "\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.1f",
+			e.phase, e.thread, e.time );
+		os << ",\n{\"name\":\"" << e.name << buff;
+		if ( e.phase == 'i' ) os << ",\"s\":\"t\"";
+		if ( e.args[0] != '\0' ) os << ",\"args\":{" << e.args << "}";
+		os << "}";
+	}
+
+	os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	mutex.unlock();
+}
+
+
+void RmTrace::write( const char *filename )
+{
+	std::ofstream os( filename );
+	if ( !os ) throw RmExceptions::IOException( "RmTrace::write()", "Unable to open trace file" );
+	write( os );
+	if ( !os ) throw RmExceptions::IOException( "RmTrace::write()", "Unable to write trace file" );
+}
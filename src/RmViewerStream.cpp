@@ -0,0 +1,137 @@
+// RmViewerStream.cpp
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "RmViewerStream.h"
+#include "RmUtility.h"
+#include "RmExceptions.h"
+
+
+const int RmViewerStream::DefaultPayload = 1400;
+const int RmViewerStream::HeaderSize = 20;
+const int RmViewerStream::CellBytes = 5;
+const unsigned char RmViewerStream::Version = 1;
+
+
+using RmSocket::put16;
+using RmSocket::put32;
+
+
+RmViewerStream::RmViewerStream( RmServer *server, int window, int payload )
+: m_server( server ), m_window( window ), m_payload( payload ), m_sequence( 0 ), m_pending( false )
+{
+	if ( m_payload < HeaderSize + CellBytes ) {
+		throw RmExceptions::InvalidParameterException( "RmViewerStream::RmViewerStream()",
+			"Payload too small to carry a cell" );
+	}
+	memset( m_pose, 0, sizeof(m_pose) );
+}
+
+
+void RmViewerStream::add( const std::string &update )
+{
+	int pose[5];
+	if ( sscanf( update.c_str(), "%d %d %d %d %d",
+		&pose[0], &pose[1], &pose[2], &pose[3], &pose[4] ) != 5 ) return;
+
+	const std::string::size_type eol = update.find( '\n' );
+	if ( eol == std::string::npos ) return;
+
+	if ( !m_pending ) {
+		m_windowStart.setToNow();
+		m_pending = true;
+	}
+	memcpy( m_pose, pose, sizeof(m_pose) );
+
+	// Parse each "x y pr;" that follows the pose line, the last value of a cell replacing any other
+	const char *p = update.c_str() + eol + 1;
+	char *end;
+	while ( *p != '\0' )
+	{
+		const int x = strtol( p, &end, 10 );
+		if ( end == p ) break;
+		p = end;
+		const int y = strtol( p, &end, 10 );
+		if ( end == p ) break;
+		p = end;
+		const double pr = strtod( p, &end );
+		if ( end == p ) break;
+
+		// A decimal probability is quantized; an integer one has been already
+		bool decimal = false;
+		for ( const char *c = p; c != end; ++c ) {
+			if ( *c == '.' ) decimal = true;
+		}
+		m_cells[CellKey( x, y )] = decimal ? RmUtility::quantize( static_cast<float>(pr) )
+			: static_cast<unsigned char>( pr );
+
+		p = end;
+		while ( *p == ';' || *p == ' ' || *p == '\n' ) ++p;
+	}
+
+	flushIfDue();
+}
+
+
+void RmViewerStream::flushIfDue()
+{
+	if ( m_pending && m_windowStart.mSecSince() >= m_window ) flush();
+}
+
+
+void RmViewerStream::flush()
+{
+	if ( !m_pending ) return;
+
+	std::vector<std::string> datagrams;
+	pack( datagrams );
+	if ( m_server == NULL ) return;
+
+	// Sent back-to-back so that a window arrives at the viewer as a burst
+	for ( std::vector<std::string>::const_iterator i = datagrams.begin(); i != datagrams.end(); ++i )
+	{
+		m_server->sendClientData( i->data(), i->length() );
+	}
+}
+
+
+void RmViewerStream::pack( std::vector<std::string> &datagrams )
+{
+	const int perDatagram = (m_payload - HeaderSize) / CellBytes;
+	std::map<CellKey,unsigned char>::const_iterator cell = m_cells.begin();
+
+	// A window of no cells (a reading that altered nothing) still conveys the pose and range
+	do
+	{
+		int n = 0;
+		std::string body;
+		for ( ; cell != m_cells.end() && n < perDatagram; ++cell, ++n ) {
+			put16( body, cell->first.first );
+			put16( body, cell->first.second );
+			body += static_cast<char>( cell->second );
+		}
+
+		std::string d;
+		d.reserve( HeaderSize + body.length() );
+		d += 'R';
+		d += 'V';
+		d += static_cast<char>( Version );
+		d += static_cast<char>( cell == m_cells.end() ? 1 : 0 );
+		put32( d, m_sequence++ );
+		put16( d, m_pose[0] );
+		put16( d, m_pose[1] );
+		put16( d, m_pose[2] );
+		d += static_cast<char>( m_pose[3] );
+		d += '\0';
+		put16( d, m_pose[4] );
+		put16( d, n );
+		d += body;
+
+		datagrams.push_back( d );
+	}
+	while ( cell != m_cells.end() );
+
+	m_cells.clear();
+	m_pending = false;
+}
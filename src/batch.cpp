@@ -0,0 +1,441 @@
+// batch.cpp
+// The batch app that reprocesses archived sonar data over a matrix of settings, running the
+// independent mapping jobs concurrently.
+
+
+// Disable warning C4786: "identifier was truncated to '255' characters in the debug information
+// while compiling class-template member function"
+#pragma warning( disable : 4786 )
+
+
+//////
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Aria.h"
+#include "RmSonarMapper.h"
+#include "RmGlobalMap.h"
+#include "RmGridFile.h"
+#include "RmExceptions.h"
+#include "RmSettings.h"
+
+using namespace RmUtility;
+
+
+//////
+
+
+/**
+ * Encapsulates one mapping job, the mapping of one sonar data file under one combination of
+ * settings, along with its results.
+ */
+struct BatchJob
+{
+	/** Filename, without extension, of the sonar data to be mapped */
+	std::string sonarName;
+
+	/** The settings of this job alone, whose GridName names the grid written by the job */
+	RmSettings *settings;
+
+	/** Number of sonar sweeps mapped, and the number of those that triggered a map update */
+	int sweeps, updates;
+
+	/** Dimension of the finished global map, in grid cells */
+	int width, height;
+
+	/** Wall-clock time taken by the job, in milliseconds */
+	long msecs;
+
+	/** Empty if the job succeeded, else the reason it failed */
+	std::string error;
+
+	BatchJob( const std::string &sonarName_, RmSettings *settings_ )
+		: sonarName(sonarName_), settings(settings_), sweeps(0), updates(0),
+		  width(0), height(0), msecs(0), error() {}
+};
+
+
+enum GridFormat { TextGrid, FloatGrid, ByteGrid };
+
+void runJob( BatchJob &job, GridFormat gridFormat );
+std::vector<std::string> splitList( const char *list );
+void writeSummary( const std::vector<BatchJob*> &jobs, std::ostream &os );
+
+
+//////
+
+
+/**
+ * Provides a pool of threads, each of which repeatedly takes the next job not yet taken
+ * and runs it, until none remain.
+ * Jobs share no state other than the index of the next job, so need no further locking.
+ */
+class BatchWorker : public ArASyncTask
+{
+public:
+
+	BatchWorker( std::vector<BatchJob*> &jobs, unsigned int &nextJob, ArMutex &mutex,
+		GridFormat gridFormat )
+		: m_jobs(jobs), m_nextJob(nextJob), m_mutex(mutex), m_gridFormat(gridFormat) {}
+
+	virtual void *runThread( void *arg )
+	{
+		for ( ;; )
+		{
+			m_mutex.lock();
+			const unsigned int j = m_nextJob++;
+			m_mutex.unlock();
+			if ( j >= m_jobs.size() ) break;
+
+			runJob( *m_jobs[j], m_gridFormat );
+
+			m_mutex.lock(); // serializes the progress report only
+			std::cout << m_jobs[j]->settings->GridName << ": "
+				<< (m_jobs[j]->error == "" ? "done" : m_jobs[j]->error.c_str())
+				<< " (" << m_jobs[j]->msecs << " ms)\n";
+			m_mutex.unlock();
+		}
+		return NULL;
+	}
+
+private:
+
+	std::vector<BatchJob*> &m_jobs;
+	unsigned int &m_nextJob;
+	ArMutex &m_mutex;
+	const GridFormat m_gridFormat;
+};
+
+
+//////
+
+
+/**
+ * Maps each of several pre-recorded sonar data files under every combination of the given
+ * settings, such as when sweeping parameters across many archived runs.
+ * Each combination is an independent job with its own RmSettings, RmGlobalMap, and
+ * RmSonarMapper, such that the jobs are run concurrently by a pool of threads.
+ * The settings not varied by the command line are those of the settings file, which unlike
+ * the main application (see main.cpp) this application only reads, never writes.
+ * Command line arguments allow for specification of
+ * <ul>
+ * <li>Number of jobs run at once (defaults to 2)
+ * <li>Prefix, such as a directory, of every file written
+ * <li>Grid map output format (text, binary, or quantized binary; see RmGridFile)
+ * <li>Comma-separated lists of sonar models, cell sizes, sonar cone half-widths
+ *     (RmSettings::Beta), local map distances, and localization on and/or off
+ * <li>Quantization of the fused global map
+ * <li>Sonar data input files, following all switches
+ * </ul>
+ * Each job writes its grid map to a file named for the sonar data and its settings, and upon
+ * completion of all jobs a tab-delimited summary of each, including its time, is written
+ * to the file <code>summary.txt</code>, similarly prefixed.
+ * Execute this application without any arguments to get specific usage information.
+ */
+int main( int argc, char* argv[] )
+{
+	//////
+	// Get command line arguments
+
+	struct InvalidUsageException {
+		std::string message;
+		InvalidUsageException( const std::string &message_ ) : message(message_) {}
+	};
+
+	int threads = 2;
+	std::string prefix;
+	GridFormat gridFormat = TextGrid; // as read by the viewer
+	bool quantizedMap = false;
+	std::vector<std::string> models, cellSizes, betas, distances, localizes;
+	std::vector<std::string> sonarNames;
+	std::vector<BatchJob*> jobs;
+
+	try {
+		int i;
+		for ( i = 1; i < argc && argv[i][0] == '-'; i += 2 )
+		{
+			if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+
+			// Number of jobs run at once
+			if ( strcmp( argv[i], "-j" ) == 0 ) {
+				threads = atoi( argv[i+1] );
+				if ( threads < 1 ) throw InvalidUsageException( "Invalid thread count" );
+			}
+
+			// Prefix of every output filename
+			else if ( strcmp( argv[i], "-o" ) == 0 ) prefix = argv[i+1];
+
+			// Grid map output format
+			else if ( strcmp( argv[i], "-gf" ) == 0 ) {
+				if ( strcmp( argv[i+1], "text" ) == 0 ) gridFormat = TextGrid;
+				else if ( strcmp( argv[i+1], "float" ) == 0 ) gridFormat = FloatGrid;
+				else if ( strcmp( argv[i+1], "byte" ) == 0 ) gridFormat = ByteGrid;
+				else throw InvalidUsageException( "Invalid grid format specification" );
+			}
+
+			// Quantization of the fused global map held in memory
+			else if ( strcmp( argv[i], "-qm" ) == 0 ) {
+				if ( strcmp( argv[i+1], "off" ) == 0 ) quantizedMap = false;
+				else if ( strcmp( argv[i+1], "on" ) == 0 ) quantizedMap = true;
+			}
+
+			// Settings matrix
+			else if ( strcmp( argv[i], "-m" ) == 0 ) models = splitList( argv[i+1] );
+			else if ( strcmp( argv[i], "-cs" ) == 0 ) cellSizes = splitList( argv[i+1] );
+			else if ( strcmp( argv[i], "-b" ) == 0 ) betas = splitList( argv[i+1] );
+			else if ( strcmp( argv[i], "-ld" ) == 0 ) distances = splitList( argv[i+1] );
+			else if ( strcmp( argv[i], "-l" ) == 0 ) localizes = splitList( argv[i+1] );
+
+			// Unidentified switch
+			else throw InvalidUsageException( std::string( "Invalid switch: " ) + argv[i] );
+		}
+		for ( ; i < argc; ++i ) sonarNames.push_back( argv[i] );
+		if ( sonarNames.empty() ) throw InvalidUsageException( "Missing sonar data files." );
+
+		// Settings left unvaried are those of the settings file
+		RmSettings defaults;
+		char buff[20];
+		if ( models.empty() ) {
+			models.push_back( defaults.SonarModel == RmUtility::SingleCell ? "cell" :
+				defaults.SonarModel == RmUtility::AcousticAxis ? "axis" : "cone" );
+		}
+		if ( cellSizes.empty() ) {
+			sprintf( buff, "%d", defaults.CellSize );
+			cellSizes.push_back( buff );
+		}
+		if ( betas.empty() ) {
+			sprintf( buff, "%d", defaults.Beta );
+			betas.push_back( buff );
+		}
+		if ( distances.empty() ) {
+			sprintf( buff, "%d", defaults.LocalMapDistance );
+			distances.push_back( buff );
+		}
+		if ( localizes.empty() ) localizes.push_back( defaults.Localize ? "on" : "off" );
+
+		// One job per sonar data file per combination of settings
+		std::vector<std::string>::const_iterator si, mi, ci, bi, di, li;
+		for ( si = sonarNames.begin(); si != sonarNames.end(); ++si )
+		for ( mi = models.begin(); mi != models.end(); ++mi )
+		for ( ci = cellSizes.begin(); ci != cellSizes.end(); ++ci )
+		for ( bi = betas.begin(); bi != betas.end(); ++bi )
+		for ( di = distances.begin(); di != distances.end(); ++di )
+		for ( li = localizes.begin(); li != localizes.end(); ++li )
+		{
+			RmSettings *settings = new RmSettings;
+			jobs.push_back( new BatchJob( *si, settings ) );
+
+			if ( *mi == "cell" ) settings->SonarModel = RmUtility::SingleCell;
+			else if ( *mi == "axis" ) settings->SonarModel = RmUtility::AcousticAxis;
+			else if ( *mi == "cone" ) settings->SonarModel = RmUtility::Cone;
+			else throw InvalidUsageException( "Invalid sonar model specification" );
+			settings->CellSize = atoi( ci->c_str() );
+			settings->Beta = atoi( bi->c_str() );
+			settings->LocalMapDistance = atoi( di->c_str() );
+			if ( *li == "on" ) settings->Localize = true;
+			else if ( *li == "off" ) settings->Localize = false;
+			else throw InvalidUsageException( "Invalid localization specification" );
+			settings->QuantizedMap = quantizedMap;
+			settings->SonarName = *si;
+
+			// Grid named for the sonar data, less any path, and the settings
+			const std::string::size_type slash = si->find_last_of( "/\\" );
+			settings->GridName = prefix +
+				(slash == std::string::npos ? *si : si->substr( slash + 1 )) + "_" + *mi +
+				"_c" + *ci + "_b" + *bi + "_d" + *di + (settings->Localize ? "_loc" : "");
+
+			const std::string iv( settings->invalids() );
+			if ( iv.length() > 0 ) {
+				throw InvalidUsageException( "Invalid settings for " + settings->GridName +
+					":\n" + iv );
+			}
+		}
+	}
+	catch( InvalidUsageException &iue ) {
+		std::cout << "\n" << iue.message << "\n";
+		std::cout << "Usage:  " << argv[0] << " [-j threads -o outputPrefix " <<
+			"-gf text|float|byte -qm on|off -m cell,axis,cone -cs cellSize,... " <<
+			"-b beta,... -ld localMapDistance,... -l on,off] sonarLogName ...\n";
+		for ( unsigned int j = 0; j < jobs.size(); ++j ) {
+			delete jobs[j]->settings;
+			delete jobs[j];
+		}
+		return 1;
+	}
+
+
+	//////
+	// Run the jobs
+
+	std::cout << "Running " << jobs.size() << " mapping jobs on " << threads << " threads...\n";
+	ArTime start;
+
+	unsigned int nextJob = 0;
+	ArMutex mutex;
+	std::vector<BatchWorker*> workers;
+	int w;
+	for ( w = 0; w < threads; ++w ) {
+		workers.push_back( new BatchWorker( jobs, nextJob, mutex, gridFormat ) );
+		workers.back()->runAsync();
+	}
+	for ( w = 0; w < threads; ++w ) {
+		workers[w]->join();
+		delete workers[w];
+	}
+
+	long msecs = 0;
+	unsigned int j;
+	for ( j = 0; j < jobs.size(); ++j ) msecs += jobs[j]->msecs;
+	std::cout << "Finished in " << start.mSecSince() << " ms (" << msecs << " ms of jobs)\n";
+
+
+	//////
+	// Summarize
+
+	const std::string summaryName( prefix + "summary.txt" );
+	std::ofstream summary( summaryName.c_str() );
+	if ( summary ) {
+		writeSummary( jobs, summary );
+		std::cout << "Saving summary to " << summaryName << "\n";
+	}
+	else std::cout << "Unable to write summary to " << summaryName << "\n";
+
+	int failed = 0;
+	for ( j = 0; j < jobs.size(); ++j ) {
+		if ( jobs[j]->error != "" ) ++failed;
+		delete jobs[j]->settings;
+		delete jobs[j];
+	}
+
+	return failed == 0 ? 0 : 2;
+}
+
+
+/**
+ * Maps the sonar data of the given job under its settings, as does the main application
+ * when mapping from file (see main.cpp), and writes the finished grid map.
+ * Any failure is recorded by the job rather than thrown.
+ * @param job the job to run, whose results are filled in
+ * @param gridFormat the format in which the grid map is written
+ */
+void runJob( BatchJob &job, GridFormat gridFormat )
+{
+	ArTime start;
+
+	try {
+		const std::string sonarName( job.sonarName + ".sd" );
+		std::ifstream sonarStream( sonarName.c_str() );
+		if ( sonarStream.fail() ) {
+			throw RmExceptions::IOException( "runJob()", "Unable to read sonar data file" );
+		}
+
+		RmGlobalMap map( job.settings );
+		RmSonarMapper sonarMapper( *job.settings, &map );
+
+		char buffer[300];
+		while( sonarStream.getline( buffer, 300 ) )
+		{
+			// Skip comments
+			if ( buffer[0] == '%' ) continue;
+
+			// Map entire sonar sweep
+			SonarReading readings( buffer );
+			if ( sonarMapper.mapReadings( readings ) ) ++job.updates;
+			++job.sweeps;
+		}
+
+		map.finalize( gridFormat == TextGrid );
+			// binary grid files are written tile by tile without integrating the map
+
+		std::string gridName( job.settings->GridName );
+		gridName.append( gridFormat == TextGrid ? ".gd" : ".gdb" );
+		const RmGridFile::CellType cellType =
+			gridFormat == ByteGrid ? RmGridFile::Quantized8 : RmGridFile::Float32;
+		if ( gridFormat != TextGrid ) {
+			map.writeTiled( gridName.c_str(), cellType );
+
+			// The map is not integrated, so its dimensions are those of the file written
+			const RmGridFile::Header header( RmGridFile::readHeader( gridName.c_str() ) );
+			job.width = header.bound.width();
+			job.height = header.bound.height();
+		}
+		else if ( !map.quantized() ) {
+			const RmMutableCartesianGrid<float> &grid = map;
+				// RmGlobalMap::put() hides the grid's own put() overloads
+			grid.put( gridName.c_str(), 4 );
+			job.width = grid.width();
+			job.height = grid.height();
+		}
+		else {
+			RmMutableCartesianGrid<float> grid;
+			map.fusedMap( grid );
+			grid.put( gridName.c_str(), 4 );
+			job.width = grid.width();
+			job.height = grid.height();
+		}
+
+		map.empty();
+	}
+	catch( RmExceptions::Exception e ) {
+		std::ostringstream os;
+		os << e;
+		job.error = os.str();
+		if ( job.error == "" ) job.error = "failed";
+	}
+
+	job.msecs = start.mSecSince();
+}
+
+
+/**
+ * Returns the elements of the given comma-separated list.
+ */
+std::vector<std::string> splitList( const char *list )
+{
+	std::vector<std::string> elements;
+	std::string s( list );
+	std::string::size_type begin = 0, end;
+	while ( (end = s.find( ',', begin )) != std::string::npos ) {
+		elements.push_back( s.substr( begin, end - begin ) );
+		begin = end + 1;
+	}
+	elements.push_back( s.substr( begin ) );
+	return elements;
+}
+
+
+/**
+ * Writes a tab-delimited table of the settings and results of each job, one job per line,
+ * following a line of column headings.
+ */
+void writeSummary( const std::vector<BatchJob*> &jobs, std::ostream &os )
+{
+	static const char *models[] = { "cell", "axis", "cone" };
+
+	os << "grid\tsonar\tmodel\tcellSize\tbeta\tlocalMapDistance\tlocalize\t"
+	   << "sweeps\tupdates\twidth\theight\tmsecs\tstatus\n";
+
+	for ( unsigned int j = 0; j < jobs.size(); ++j )
+	{
+		const BatchJob &job = *jobs[j];
+		const RmSettings &s = *job.settings;
+		os << s.GridName << "\t" << job.sonarName << "\t" << models[s.SonarModel] << "\t"
+		   << s.CellSize << "\t" << s.Beta << "\t" << s.LocalMapDistance << "\t"
+		   << (s.Localize ? "on" : "off") << "\t" << job.sweeps << "\t" << job.updates << "\t"
+		   << job.width << "\t" << job.height << "\t" << job.msecs << "\t";
+
+		// Exceptions may span lines, which would break the table
+		std::string status( job.error == "" ? "ok" : job.error );
+		for ( std::string::size_type c = 0; c < status.length(); ++c ) {
+			if ( status[c] == '\n' || status[c] == '\t' ) status[c] = ' ';
+		}
+		os << status << "\n";
+	}
+}
@@ -0,0 +1,894 @@
+// bench.cpp
+// The benchmark app that times the mapping core, from single grid operations up to the
+// replay of entire sonar data files, for tracking its performance from one build to the next.
+
+
+// Disable warning C4786: "identifier was truncated to '255' characters in the debug information
+// while compiling class-template member function"
+#pragma warning( disable : 4786 )
+
+
+//////
+
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Aria.h"
+#include "RmSonarMapper.h"
+#include "RmGlobalMap.h"
+#include "RmLocalMap.h"
+#include "RmMapPublisher.h"
+#include "RmMapReplica.h"
+#include "RmBayesCertaintyGrid.h"
+#include "RmMutableCartesianGrid.h"
+#include "RmPioneerController.h"
+#include "RmPolygon.h" // for the polygon filling routines
+#include "RmExceptions.h"
+#include "RmInstrument.h"
+#include "RmSettings.h"
+#include "RmSonarSimulator.h"
+#include "RmViewerStream.h"
+
+using namespace RmUtility;
+using RmInstrument::wallSeconds;
+
+
+//////
+
+
+/**
+ * Passed to each benchmark, which times the body of a loop such as
+ * <code>while ( state.keepRunning() ) { ... }</code>, run for the number of iterations
+ * chosen by the caller.  Any setup preceding the loop is not timed, and any within it may
+ * be excluded by pauseTiming() and resumeTiming().
+ */
+class BenchState
+{
+public:
+
+	BenchState( long iterations )
+		: m_iterations(iterations), m_done(0), m_running(false), m_items(0.0),
+		  m_wallSecs(0.0), m_cpuSecs(0.0) {}
+
+	/** Starts the clock upon the first call, and stops it once all iterations are run */
+	bool keepRunning()
+	{
+		if ( m_done == 0 && !m_running ) resumeTiming();
+		if ( m_done++ < m_iterations ) return true;
+		pauseTiming();
+		return false;
+	}
+
+	void pauseTiming()
+	{
+		if ( !m_running ) return;
+		m_wallSecs += wallSeconds() - m_wallStart;
+		m_cpuSecs += static_cast<double>(clock() - m_cpuStart) / CLOCKS_PER_SEC;
+		m_running = false;
+	}
+
+	void resumeTiming()
+	{
+		if ( m_running ) return;
+		m_wallStart = wallSeconds();
+		m_cpuStart = clock();
+		m_running = true;
+	}
+
+	/** Records the number of items, such as cells or sweeps, processed by all iterations */
+	void setItemsProcessed( double items ) { m_items = items; }
+
+	long iterations() const { return m_iterations; }
+	double items() const { return m_items; }
+	double wallSecs() const { return m_wallSecs; }
+	double cpuSecs() const { return m_cpuSecs; }
+
+private:
+
+	const long m_iterations;
+	long m_done;
+	bool m_running;
+	double m_items;
+	double m_wallStart, m_wallSecs;
+	clock_t m_cpuStart;
+	double m_cpuSecs;
+};
+
+
+/**
+ * Exposes the protected stages of RmGlobalMap to the benchmarks.
+ */
+class BenchGlobalMap : public RmGlobalMap
+{
+public:
+
+	BenchGlobalMap( RmSettings *s ) : RmGlobalMap( s ) {}
+
+	void addToRegionMap( RmLocalMap *map ) { RmGlobalMap::addToRegionMap( map ); }
+
+	void removeFromRegionMap( RmLocalMap *map ) { RmGlobalMap::removeFromRegionMap( map ); }
+
+	Pose localizedPose( const RmLocalMap &priorMap, const SonarReading &reading ) const {
+		return RmGlobalMap::localizedPose( priorMap, reading, 0 ); }
+};
+
+
+/**
+ * Holds the inputs shared by all benchmarks, built once before any is run, along with any
+ * state built from them that the benchmarks do not modify, or restore once done.
+ */
+struct BenchFixture
+{
+	/** Settings at their default values, ignoring those of any settings file, without
+		and with localization */
+	RmSettings settings, localizeSettings;
+
+	/** The sweeps of a synthetic run; see synthesizeRun() */
+	std::vector<SonarReading> run;
+
+	/** The lines of each sonar data file given on the command line, and its name */
+	std::vector<std::vector<std::string> > sonarData;
+	std::vector<std::string> sonarNames;
+
+	/** A map of the synthetic run, finalized but not integrated */
+	BenchGlobalMap *map;
+
+	/** A local map built over the last stretch of the synthetic run, as if just finished,
+		and the sweep that follows it */
+	RmLocalMap *priorMap;
+	SonarReading nextReading;
+
+	BenchFixture() : map(NULL), priorMap(NULL) {}
+	~BenchFixture() { delete priorMap; delete map; }
+};
+
+
+typedef void (*BenchFunction)( BenchState &state, BenchFixture &fixture, int arg );
+
+
+/**
+ * Identifies a benchmark by name, with the function that runs it and the argument passed
+ * to that function, as when several benchmarks share one function.
+ */
+struct Benchmark
+{
+	std::string name;
+	BenchFunction function;
+	int arg;
+
+	Benchmark( const std::string &name_, BenchFunction function_, int arg_ = 0 )
+		: name(name_), function(function_), arg(arg_) {}
+};
+
+
+/**
+ * The result of a benchmark, run for enough iterations to span the minimum time.
+ */
+struct BenchResult
+{
+	std::string name;
+	long iterations;
+	double wallNsecs, cpuNsecs; // per iteration
+	double itemsPerSec;
+};
+
+
+void synthesizeRun( int sweeps, std::vector<SonarReading> &run );
+void buildFixture( BenchFixture &fixture, int sweeps );
+BenchResult runBenchmark( const Benchmark &benchmark, BenchFixture &fixture, double minSecs );
+void writeJson( const std::vector<BenchResult> &results, const char *executable,
+	double minSecs, int sweeps, std::ostream &os );
+
+void benchMatrixValueAt( BenchState &state, BenchFixture &fixture, int arg );
+void benchMatrixResizeBy( BenchState &state, BenchFixture &fixture, int arg );
+void benchGridRotateBy( BenchState &state, BenchFixture &fixture, int arg );
+void benchGridTrim( BenchState &state, BenchFixture &fixture, int arg );
+void benchGridMergeWith( BenchState &state, BenchFixture &fixture, int arg );
+void benchCertaintyUpdate( BenchState &state, BenchFixture &fixture, int sonarModel );
+void benchFillLine( BenchState &state, BenchFixture &fixture, int arg );
+void benchFillPolygon( BenchState &state, BenchFixture &fixture, int arg );
+void benchAddToRegionMap( BenchState &state, BenchFixture &fixture, int arg );
+void benchIntegrate( BenchState &state, BenchFixture &fixture, int threads );
+void benchLocalizedPose( BenchState &state, BenchFixture &fixture, int arg );
+void benchPublish( BenchState &state, BenchFixture &fixture, int dropEvery );
+void benchReplaySynthetic( BenchState &state, BenchFixture &fixture, int localize );
+void benchReplayFile( BenchState &state, BenchFixture &fixture, int file );
+
+
+//////
+
+
+/**
+ * Times the operations of the mapping core on which the speed of mapping depends,
+ * each as a benchmark that is repeated until it has run for a minimum time, reporting
+ * the time per iteration and, where it applies, the rate at which cells or sweeps are
+ * processed.
+ * Every benchmark begins from the same inputs, being the default settings (those of any settings
+ * file are ignored) and a synthetic run of a robot lapping a rectangular room, such that results
+ * are comparable between builds and machines.
+ * Command line arguments allow for specification of
+ * <ul>
+ * <li>Minimum time, in seconds, over which each benchmark is run (defaults to 0.5)
+ * <li>Number of sweeps in the synthetic run (defaults to 1000)
+ * <li>Comma-separated list of the thread counts over which RmGlobalMap::integrate() is run
+ * <li>Substring by which benchmarks are selected by name
+ * <li>File to which results are written as JSON, in the layout written by Google Benchmark,
+ *     for regression tracking
+ * <li>Sonar data files, following all switches, each replayed end to end
+ * </ul>
+ * Execute this application with the switch -h to get specific usage information.
+ */
+int main( int argc, char* argv[] )
+{
+	//////
+	// Get command line arguments
+
+	struct InvalidUsageException {
+		std::string message;
+		InvalidUsageException( const std::string &message_ ) : message(message_) {}
+	};
+
+	double minSecs = 0.5;
+	int sweeps = 1000;
+	std::vector<int> threadCounts;
+	std::string filter;
+	std::string jsonName;
+	std::vector<std::string> sonarNames;
+
+	try {
+		int i;
+		for ( i = 1; i < argc && argv[i][0] == '-'; i += 2 )
+		{
+			if ( strcmp( argv[i], "-h" ) == 0 ) throw InvalidUsageException( "" );
+			if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+
+			// Minimum time per benchmark
+			if ( strcmp( argv[i], "-t" ) == 0 ) {
+				minSecs = atof( argv[i+1] );
+				if ( minSecs <= 0 ) throw InvalidUsageException( "Invalid minimum time" );
+			}
+
+			// Length of the synthetic run
+			else if ( strcmp( argv[i], "-s" ) == 0 ) {
+				sweeps = atoi( argv[i+1] );
+				if ( sweeps < 100 ) throw InvalidUsageException( "Invalid number of sweeps" );
+			}
+
+			// Thread counts over which the global map is integrated
+			else if ( strcmp( argv[i], "-it" ) == 0 ) {
+				const char *next = argv[i+1];
+				while ( *next != '\0' ) {
+					char *end;
+					const int threads = strtol( next, &end, 10 );
+					if ( end == next || threads < 1 )
+						throw InvalidUsageException( "Invalid thread count" );
+					threadCounts.push_back( threads );
+					next = *end == ',' ? end + 1 : end;
+				}
+			}
+
+			// Benchmark selection
+			else if ( strcmp( argv[i], "-f" ) == 0 ) filter = argv[i+1];
+
+			// JSON output
+			else if ( strcmp( argv[i], "-o" ) == 0 ) jsonName = argv[i+1];
+
+			// Unidentified switch
+			else throw InvalidUsageException( std::string( "Invalid switch: " ) + argv[i] );
+		}
+		for ( ; i < argc; ++i ) sonarNames.push_back( argv[i] );
+	}
+	catch( InvalidUsageException &iue ) {
+		std::cout << "\n" << iue.message << "\n";
+		std::cout << "Usage:  " << argv[0] << " [-t minSeconds -s sweeps -it threads,... " <<
+			"-f nameFilter -o jsonFile] [sonarLogName ...]\n";
+		return 1;
+	}
+
+	if ( threadCounts.empty() ) {
+		threadCounts.push_back( 1 );
+		threadCounts.push_back( 2 );
+		threadCounts.push_back( 4 );
+	}
+
+
+	//////
+	// Build the inputs
+
+	BenchFixture fixture;
+	try {
+		buildFixture( fixture, sweeps );
+
+		for ( unsigned int s = 0; s < sonarNames.size(); ++s )
+		{
+			const std::string sonarName( sonarNames[s] + ".sd" );
+			std::ifstream sonarStream( sonarName.c_str() );
+			if ( sonarStream.fail() ) {
+				std::cout << "Unable to read sonar data file " << sonarName << "\n";
+				return 2;
+			}
+			fixture.sonarNames.push_back( sonarNames[s] );
+			fixture.sonarData.push_back( std::vector<std::string>() );
+			char buffer[300];
+			while( sonarStream.getline( buffer, 300 ) ) {
+				if ( buffer[0] != '%' ) fixture.sonarData.back().push_back( buffer );
+			}
+		}
+	}
+	catch( RmExceptions::Exception e ) {
+		std::cout << e << "\n";
+		return 2;
+	}
+
+
+	//////
+	// Register the benchmarks
+
+	std::vector<Benchmark> benchmarks;
+	benchmarks.push_back( Benchmark( "RmMutableMatrix::valueAt", benchMatrixValueAt ) );
+	benchmarks.push_back( Benchmark( "RmMutableMatrix::resizeBy", benchMatrixResizeBy ) );
+	benchmarks.push_back( Benchmark( "RmMutableCartesianGrid::rotateBy", benchGridRotateBy ) );
+	benchmarks.push_back( Benchmark( "RmMutableCartesianGrid::trim", benchGridTrim ) );
+	benchmarks.push_back( Benchmark( "RmMutableCartesianGrid::mergeWith", benchGridMergeWith ) );
+	benchmarks.push_back( Benchmark( "RmBayesCertaintyGrid::update/cell",
+		benchCertaintyUpdate, RmUtility::SingleCell ) );
+	benchmarks.push_back( Benchmark( "RmBayesCertaintyGrid::update/axis",
+		benchCertaintyUpdate, RmUtility::AcousticAxis ) );
+	benchmarks.push_back( Benchmark( "RmBayesCertaintyGrid::update/cone",
+		benchCertaintyUpdate, RmUtility::Cone ) );
+	benchmarks.push_back( Benchmark( "FillLine", benchFillLine ) );
+	benchmarks.push_back( Benchmark( "FillPolygon", benchFillPolygon ) );
+	benchmarks.push_back( Benchmark( "RmGlobalMap::addToRegionMap", benchAddToRegionMap ) );
+	std::vector<int>::const_iterator ti;
+	for ( ti = threadCounts.begin(); ti != threadCounts.end(); ++ti ) {
+		char buff[20];
+		sprintf( buff, "/threads:%d", *ti );
+		benchmarks.push_back( Benchmark( std::string( "RmGlobalMap::integrate" ) + buff,
+			benchIntegrate, *ti ) );
+	}
+	benchmarks.push_back( Benchmark( "RmGlobalMap::localizedPose", benchLocalizedPose ) );
+	benchmarks.push_back( Benchmark( "RmMapPublisher::publish", benchPublish, 0 ) );
+	benchmarks.push_back( Benchmark( "RmMapPublisher::publish/lossy", benchPublish, 7 ) );
+	benchmarks.push_back( Benchmark( "Replay/synthetic", benchReplaySynthetic, 0 ) );
+	benchmarks.push_back( Benchmark( "Replay/synthetic/localize", benchReplaySynthetic, 1 ) );
+	for ( unsigned int f = 0; f < fixture.sonarNames.size(); ++f ) {
+		benchmarks.push_back( Benchmark( "Replay/" + fixture.sonarNames[f], benchReplayFile, f ) );
+	}
+
+
+	//////
+	// Run the benchmarks
+
+	char line[200];
+	sprintf( line, "%-44s %14s %14s %12s %14s\n", "Benchmark", "Time (ns)", "CPU (ns)",
+		"Iterations", "Items/s" );
+	std::cout << line << std::string( 102, '-' ) << "\n";
+
+	std::vector<BenchResult> results;
+	std::vector<Benchmark>::const_iterator bi;
+	for ( bi = benchmarks.begin(); bi != benchmarks.end(); ++bi )
+	{
+		if ( filter != "" && bi->name.find( filter ) == std::string::npos ) continue;
+		try {
+			results.push_back( runBenchmark( *bi, fixture, minSecs ) );
+		}
+		catch( RmExceptions::Exception e ) {
+			std::cout << bi->name << ": " << e << "\n";
+			return 2;
+		}
+
+		const BenchResult &r = results.back();
+		sprintf( line, "%-44s %14.0f %14.0f %12ld ", r.name.c_str(), r.wallNsecs, r.cpuNsecs,
+			r.iterations );
+		std::cout << line;
+		if ( r.itemsPerSec > 0 ) {
+			sprintf( line, "%14.4g", r.itemsPerSec );
+			std::cout << line;
+		}
+		std::cout << std::endl;
+	}
+
+	if ( jsonName != "" ) {
+		std::ofstream json( jsonName.c_str() );
+		if ( !json ) {
+			std::cout << "Unable to write results to " << jsonName << "\n";
+			return 2;
+		}
+		writeJson( results, argv[0], minSecs, sweeps, json );
+		std::cout << "Saving results to " << jsonName << "\n";
+	}
+
+	return 0;
+}
+
+
+/**
+ * Runs the given benchmark for one iteration, then for as many as are predicted to span the
+ * minimum time, growing the prediction at most tenfold per run, until a run spans it.
+ */
+BenchResult runBenchmark( const Benchmark &benchmark, BenchFixture &fixture, double minSecs )
+{
+	long iterations = 1;
+	for ( ;; )
+	{
+		BenchState state( iterations );
+		benchmark.function( state, fixture, benchmark.arg );
+
+		const double secs = state.wallSecs();
+		if ( secs >= minSecs || iterations >= 1000000000L )
+		{
+			BenchResult result;
+			result.name = benchmark.name;
+			result.iterations = iterations;
+			result.wallNsecs = secs * 1e9 / iterations;
+			result.cpuNsecs = state.cpuSecs() * 1e9 / iterations;
+			result.itemsPerSec = secs > 0 ? state.items() / secs : 0.0;
+			return result;
+		}
+
+		const double predicted = secs <= 0 ? iterations * 10.0 : iterations * 1.4 * minSecs / secs;
+		const double most = iterations * 10.0;
+		iterations = static_cast<long>(predicted > most ? most : predicted) + 1;
+	}
+}
+
+
+/**
+ * Writes the given results as JSON, in the layout written by Google Benchmark, such that
+ * its tools for comparing runs may be used to track them.
+ */
+void writeJson( const std::vector<BenchResult> &results, const char *executable,
+	double minSecs, int sweeps, std::ostream &os )
+{
+	char date[40];
+	const time_t now = time( NULL );
+	strftime( date, sizeof date, "%Y-%m-%d %H:%M:%S", localtime( &now ) );
+
+	os << "{\n  \"context\": {\n"
+	   << "    \"date\": \"" << date << "\",\n"
+	   << "    \"executable\": \"" << executable << "\",\n"
+	   << "    \"min_time\": " << minSecs << ",\n"
+	   << "    \"synthetic_sweeps\": " << sweeps << "\n"
+	   << "  },\n  \"benchmarks\": [";
+
+	char buff[100];
+	for ( unsigned int r = 0; r < results.size(); ++r )
+	{
+		os << (r == 0 ? "\n" : ",\n") << "    {\n"
+		   << "      \"name\": \"" << results[r].name << "\",\n"
+		   << "      \"iterations\": " << results[r].iterations << ",\n";
+		sprintf( buff, "      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n",
+			results[r].wallNsecs, results[r].cpuNsecs );
+		os << buff << "      \"time_unit\": \"ns\"";
+		if ( results[r].itemsPerSec > 0 ) {
+			sprintf( buff, ",\n      \"items_per_second\": %.6g", results[r].itemsPerSec );
+			os << buff;
+		}
+		os << "\n    }";
+	}
+	os << "\n  ]\n}\n";
+}
+
+
+//////
+
+
+/**
+ * Fills the given vector with the given number of sonar sweeps, as would be read from a
+ * sonar data file, of a robot lapping a rectangle of 5 by 3 meters within an empty room of
+ * 8 by 6 meters, centered on the origin, as simulated by RmSonarSimulator without odometry
+ * error or sonar noise.
+ * The robot advances 20 mm per sweep along each side and turns 10 degrees per sweep at
+ * each corner.
+ */
+void synthesizeRun( int sweeps, std::vector<SonarReading> &run )
+{
+	RmSonarSimulator sim;
+	std::vector<Coord> room;
+	room.push_back( Coord( -4000, -3000 ) );
+	room.push_back( Coord( 4000, -3000 ) );
+	room.push_back( Coord( 4000, 3000 ) );
+	room.push_back( Coord( -4000, 3000 ) );
+	sim.addPolygon( room );
+	sim.setPose( -2500, -1500, 0 );
+
+	run.clear();
+	run.push_back( sim.sweep() );
+	for ( int side = 0; static_cast<int>(run.size()) < sweeps; side = (side + 1) % 4 )
+	{
+		const int length = side % 2 == 0 ? 5000 : 3000;
+		int step;
+		for ( step = 0; step < length / 20 && static_cast<int>(run.size()) < sweeps; ++step ) {
+			sim.forward( 20 );
+			run.push_back( sim.sweep() );
+		}
+		for ( step = 0; step < 9 && static_cast<int>(run.size()) < sweeps; ++step ) {
+			sim.turn( 10 );
+			run.push_back( sim.sweep() );
+		}
+	}
+}
+
+
+/**
+ * Builds the synthetic run and the maps shared by the benchmarks of the global map.
+ */
+void buildFixture( BenchFixture &fixture, int sweeps )
+{
+	fixture.settings.init();
+	fixture.localizeSettings.init();
+	fixture.localizeSettings.Localize = true;
+
+	synthesizeRun( sweeps, fixture.run );
+
+	// Map all but the last stretch of the run
+	const int last = sweeps * 4 / 5;
+	fixture.map = new BenchGlobalMap( &fixture.settings );
+	RmSonarMapper sonarMapper( fixture.settings, fixture.map );
+	int s;
+	for ( s = 0; s < last; ++s ) {
+		SonarReading readings( fixture.run[s] );
+		sonarMapper.mapReadings( readings );
+	}
+	fixture.map->finalize( false );
+
+	// Build a local map over the last stretch, as the mapper would once the robot has travelled
+	// the local map distance
+	fixture.priorMap = new RmLocalMap( &fixture.settings, fixture.run[last].robotPose );
+	for ( s = last; s < sweeps - 1 &&
+		fixture.priorMap->cumDistance() < fixture.settings.LocalMapDistance; ++s )
+	{
+		SonarReading reading( fixture.run[s] );
+		for ( int i = 0; i < RmPioneerController::NumSonars; ++i ) {
+			reading.sonarNumber = i;
+			reading.distance = reading.all[i];
+			fixture.priorMap->update( reading );
+		}
+	}
+	fixture.nextReading = fixture.run[s];
+}
+
+
+//////
+// Grids
+
+
+void benchMatrixValueAt( BenchState &state, BenchFixture &fixture, int arg )
+{
+	RmMutableMatrix<float> matrix( 200, 200, 0.5f );
+	float sum = 0.0f;
+	while ( state.keepRunning() ) {
+		for ( int y = 0; y < 200; ++y ) {
+			for ( int x = 0; x < 200; ++x ) sum += matrix.valueAt( x, y );
+		}
+	}
+	state.setItemsProcessed( 200.0 * 200 * state.iterations() );
+	if ( sum < 0 ) std::cout << sum; // keeps the reads from being optimized away
+}
+
+
+void benchMatrixResizeBy( BenchState &state, BenchFixture &fixture, int arg )
+{
+	RmMutableMatrix<float> matrix( 200, 200, 0.5f );
+	while ( state.keepRunning() ) {
+		matrix.resizeBy( 4, 4, 4, 4 );
+		matrix.resizeBy( -4, -4, -4, -4 );
+	}
+}
+
+
+/**
+ * Fills the given grid with a pattern of occupied and empty cells, as a local map might be.
+ */
+void fillGrid( RmMutableCartesianGrid<float> &grid )
+{
+	const BoundBox bound( grid.bound() );
+	for ( int y = bound.ul.y; y >= bound.lr.y; --y ) {
+		for ( int x = bound.ul.x; x <= bound.lr.x; ++x ) {
+			grid.valueAt( x, y ) = (x * 7 + y * 13) % 5 == 0 ? 0.9f : 0.1f;
+		}
+	}
+}
+
+
+void benchGridRotateBy( BenchState &state, BenchFixture &fixture, int arg )
+{
+	RmMutableCartesianGrid<float> grid( 100, 100, Coord(), 0.5f );
+	fillGrid( grid );
+	while ( state.keepRunning() ) {
+		state.pauseTiming();
+		RmMutableCartesianGrid<float> rotated( grid );
+		state.resumeTiming();
+		rotated.rotateBy( 30.0 );
+	}
+}
+
+
+void benchGridTrim( BenchState &state, BenchFixture &fixture, int arg )
+{
+	RmMutableCartesianGrid<float> grid( 200, 200, Coord(), 0.5f );
+	RmMutableCartesianGrid<float> content( 100, 100, Coord(), 0.5f );
+	fillGrid( content );
+	grid.mergeWith( content );
+	while ( state.keepRunning() ) {
+		state.pauseTiming();
+		RmMutableCartesianGrid<float> trimmed( grid );
+		state.resumeTiming();
+		trimmed.trim();
+	}
+}
+
+
+void benchGridMergeWith( BenchState &state, BenchFixture &fixture, int arg )
+{
+	RmMutableCartesianGrid<float> grid( 200, 200, Coord(), 0.5f );
+	RmMutableCartesianGrid<float> other( 100, 100, Coord( 30, -20 ), 0.5f );
+	fillGrid( other );
+	while ( state.keepRunning() ) grid.mergeWith( other );
+	state.setItemsProcessed( 100.0 * 100 * state.iterations() );
+}
+
+
+void benchCertaintyUpdate( BenchState &state, BenchFixture &fixture, int sonarModel )
+{
+	RmSettings settings;
+	settings.init();
+	settings.SonarModel = static_cast<RmUtility::SonarModelEnum>(sonarModel);
+	RmBayesCertaintyGrid grid( &settings, Coord() );
+
+	// One in-range reading of each sonar of each sweep, as mapped by RmLocalMap::update()
+	std::vector<MappedSonarReading> readings;
+	std::vector<SonarReading>::const_iterator ri;
+	for ( ri = fixture.run.begin(); ri != fixture.run.end(); ++ri ) {
+		SonarReading reading( *ri );
+		for ( int i = 0; i < RmPioneerController::NumSonars; ++i ) {
+			reading.sonarNumber = i;
+			reading.distance = reading.all[i];
+			if ( reading.distance > RmPioneerController::SonarRange ) continue;
+			readings.push_back(
+				RmPioneerController::rangeReading( reading ).scale( settings.CellSize ) );
+		}
+	}
+
+	unsigned int r = 0;
+	while ( state.keepRunning() ) {
+		grid.update( readings[r] );
+		if ( ++r == readings.size() ) r = 0;
+	}
+	state.setItemsProcessed( static_cast<double>(state.iterations()) );
+}
+
+
+//////
+// Polygon filling
+
+
+void benchFillLine( BenchState &state, BenchFixture &fixture, int arg )
+{
+	int n = 0;
+	while ( state.keepRunning() ) {
+		ScopedDrawContext draw;
+		FillLine( &draw, 0, 0, 30 - n % 60, 25 );
+		++n;
+	}
+}
+
+
+void benchFillPolygon( BenchState &state, BenchFixture &fixture, int arg )
+{
+	// A sonar cone of 30 degrees and 30 cells, as the cone model fills
+	Point points[8];
+	points[0].X = 0;
+	points[0].Y = 0;
+	for ( int v = 1; v < 8; ++v ) {
+		const double th = (-15 + (v - 1) * 5) * RadianFactor;
+		points[v].X = static_cast<int>(30 * sin( th ));
+		points[v].Y = static_cast<int>(30 * cos( th ));
+	}
+	PointListHeader header = { 8, points };
+
+	while ( state.keepRunning() ) {
+		ScopedDrawContext draw;
+		FillPolygon( &draw, &header, 0 /*color*/, NONCONVEX, 0 /*x-offset*/, 0 /*y-offset*/ );
+	}
+}
+
+
+//////
+// Global map
+
+
+/**
+ * Times the addition of a finished local map to a region map already holding many,
+ * removing it again, untimed, after each.
+ */
+void benchAddToRegionMap( BenchState &state, BenchFixture &fixture, int arg )
+{
+	while ( state.keepRunning() ) {
+		fixture.map->addToRegionMap( fixture.priorMap );
+		state.pauseTiming();
+		fixture.map->removeFromRegionMap( fixture.priorMap );
+		state.resumeTiming();
+	}
+}
+
+
+void benchIntegrate( BenchState &state, BenchFixture &fixture, int threads )
+{
+	const int priorThreads = fixture.settings.IntegrateThreads;
+	fixture.settings.IntegrateThreads = threads;
+	while ( state.keepRunning() ) fixture.map->integrate();
+	fixture.settings.IntegrateThreads = priorThreads;
+	state.setItemsProcessed( static_cast<double>(fixture.map->width()) *
+		fixture.map->height() * state.iterations() );
+}
+
+
+void benchLocalizedPose( BenchState &state, BenchFixture &fixture, int arg )
+{
+	while ( state.keepRunning() ) {
+		fixture.map->localizedPose( *fixture.priorMap, fixture.nextReading );
+	}
+}
+
+
+/**
+ * Carries frames straight to a replica, dropping every so many, and the replica's reply back
+ * once per update, as would a client over a lossy network.
+ */
+class ReplicaTransport : public RmMapPublisher::Transport
+{
+public:
+
+	ReplicaTransport( RmMapReplica &replica, int dropEvery )
+		: m_replica(replica), m_dropEvery(dropEvery), m_frames(0), m_replied(true) {}
+
+	/** Sets the number of frames after which one is dropped, or 0 to drop none */
+	void setDropEvery( int dropEvery ) { m_dropEvery = dropEvery; }
+
+	virtual int maxFrame() const { return RmViewerStream::DefaultPayload; }
+
+	virtual void send( const std::string &frame )
+	{
+		m_replied = false;
+		if ( m_dropEvery > 0 && ++m_frames % m_dropEvery == 0 ) return;
+		m_replica.apply( frame.data(), frame.length() );
+	}
+
+	virtual bool receive( std::string &line, int timeout )
+	{
+		if ( m_replied ) return false;
+		line = m_replica.reply();
+		m_replied = true;
+		return true;
+	}
+
+private:
+
+	RmMapReplica &m_replica;
+	int m_dropEvery;
+	long m_frames;
+	bool m_replied; // whether the reply to the frames last sent has been received
+};
+
+
+/**
+ * Times the publication of the map to a replica every PublishSweeps sweeps of the synthetic
+ * run, along with the replica's application of each update and the processing of its reply,
+ * but not the mapping in between.  The items processed are the tiles sent.
+ * Once the run is mapped, the replica is brought up to date over a lossless transport and
+ * checked, cell for cell, against the map.
+ * @param dropEvery the number of frames after which one is dropped, or 0 to drop none
+ * @throw an RmExceptions::InvalidStateException if the replica differs from the map
+ */
+void benchPublish( BenchState &state, BenchFixture &fixture, int dropEvery )
+{
+	const int PublishSweeps = 10;
+	double tiles = 0.0;
+	while ( state.keepRunning() )
+	{
+		state.pauseTiming();
+		RmGlobalMap map( &fixture.settings );
+		RmSonarMapper sonarMapper( fixture.settings, &map );
+		RmMapReplica replica;
+		ReplicaTransport transport( replica, dropEvery );
+		RmMapPublisher publisher( map, transport );
+		for ( unsigned int r = 0; r < fixture.run.size(); ++r )
+		{
+			SonarReading readings( fixture.run[r] );
+			sonarMapper.mapReadings( readings );
+			if ( r % PublishSweeps != PublishSweeps - 1 ) continue;
+
+			state.resumeTiming();
+			tiles += publisher.publish();
+			while ( publisher.service( 0 ) ) ;
+			state.pauseTiming();
+		}
+
+		// Repair whatever was lost, then compare every mapped cell
+		transport.setDropEvery( 0 );
+		for ( int attempt = 0; attempt < 3 && 
+			!(replica.current() && replica.version() == map.version()); ++attempt ) {
+			publisher.publish();
+			while ( publisher.service( 0 ) ) ;
+		}
+		if ( !replica.current() || replica.version() != map.version() ) {
+			throw RmExceptions::InvalidStateException( "benchPublish()", 
+				"Replica not brought up to date" );
+		}
+		std::vector<Coord> changed;
+		map.changedTiles( 0, changed );
+		std::vector<Coord>::const_iterator ti;
+		for ( ti = changed.begin(); ti != changed.end(); ++ti ) {
+			const BoundBox bound( RmGlobalMap::tileBound( *ti ) );
+			for ( int y = bound.ul.y; y >= bound.lr.y; --y ) {
+				for ( int x = bound.ul.x; x <= bound.lr.x; ++x ) {
+					if ( replica.valueAt( x, y ) != quantize( map.liveValueAt( x, y ) ) ) {
+						throw RmExceptions::InvalidStateException( "benchPublish()", 
+							"Replica differs from the map" );
+					}
+				}
+			}
+		}
+		state.resumeTiming();
+	}
+	state.setItemsProcessed( tiles );
+}
+
+
+//////
+// End to end
+
+
+/**
+ * Times the mapping of the synthetic run from its first sweep through finalization,
+ * with or without localization.
+ */
+void benchReplaySynthetic( BenchState &state, BenchFixture &fixture, int localize )
+{
+	RmSettings &settings = localize ? fixture.localizeSettings : fixture.settings;
+	while ( state.keepRunning() )
+	{
+		RmGlobalMap map( &settings );
+		RmSonarMapper sonarMapper( settings, &map );
+		std::vector<SonarReading>::const_iterator ri;
+		for ( ri = fixture.run.begin(); ri != fixture.run.end(); ++ri ) {
+			SonarReading readings( *ri );
+			sonarMapper.mapReadings( readings );
+		}
+		map.finalize();
+	}
+	state.setItemsProcessed( static_cast<double>(fixture.run.size()) * state.iterations() );
+}
+
+
+/**
+ * Times the mapping of the given sonar data file, as would the main application (see main.cpp)
+ * from reading its first line through finalization, under the default settings.
+ */
+void benchReplayFile( BenchState &state, BenchFixture &fixture, int file )
+{
+	const std::vector<std::string> &lines = fixture.sonarData[file];
+	char buffer[300];
+	while ( state.keepRunning() )
+	{
+		RmGlobalMap map( &fixture.settings );
+		RmSonarMapper sonarMapper( fixture.settings, &map );
+		std::vector<std::string>::const_iterator li;
+		for ( li = lines.begin(); li != lines.end(); ++li ) {
+			strncpy( buffer, li->c_str(), 299 );
+			buffer[299] = '\0';
+			SonarReading readings( buffer );
+			sonarMapper.mapReadings( readings );
+		}
+		map.finalize();
+	}
+	state.setItemsProcessed( static_cast<double>(lines.size()) * state.iterations() );
+}
@@ -1,491 +1,863 @@
-// main.cpp
-// The stand-alone app that maps live or pre-recorded sonar data;
-// The server side of the client-server application that allows for remote control of robot
-// and mapping functionality.
-
-
-// Disable warning C4786: "identifier was truncated to '255' characters in the debug information
-// while compiling class-template member function"
-#pragma warning( disable : 4786 )
-
-
-//////
-
-
+// main.cpp
+// The stand-alone app that maps live or pre-recorded sonar data;
+// The server side of the client-server application that allows for remote control of robot
+// and mapping functionality.
+
+
+// Disable warning C4786: "identifier was truncated to '255' characters in the debug information
+// while compiling class-template member function"
+#pragma warning( disable : 4786 )
+
+
+//////
+
+
 #include <fstream>
-#include <iostream>
+#include <iostream>
+#include <string>
 #include <string>
-#include <string>
-#include <ctype.h>
-
-#include "RmSonarMapper.h"
-#include "RmGlobalMap.h"
-#include "RmUtilityExt.h"
-#include "RmExceptions.h"
-#include "RmPioneerController.h"
-#include "RmServer.h"
-
-using namespace RmUtility;
-
-
-//////
-
-
-void mapFromFile( RmSettings &settings, std::ifstream& sonarStream, RmGlobalMap& grid );
-void mapFromRobot( RmSettings &settings, std::ofstream &sonarStream, std::string sonarStreamName, 
-	RmSonarMap &grid, int remotePort, bool wander );
-std::string newLogFile( std::ofstream &sonarStream, std::string sonarStreamName, bool reset = false );
-
-
-//////
-
-
-const std::string DataPath( "../data/" );
-
-
-//////
-
-
-/**
- * Provides console interface to robot mapping functionality encapsulated within the RmMapper API.
- * Supports direct-connect or wireless simulated or real-world operation and real-time map
- * viewing.
- * Command line arguments allow for specification of
- * <ul>
- * <li>Sonar data input file (pre-recorded)
- * <li>Sonar data output file (live)
- * <li>Grid map output file
- * <li>Robot drive mode (keyboard or wander)
- * <li>Sonar mode (Point of Return, Acoustic Axis, or Field of View)
- * <li>Localization enabled or disabled
- * </ul>
+#include <vector>
+#include <ctype.h>
+
+#include "RmSonarMapper.h"
+#include "RmGlobalMap.h"
+#include "RmGridFile.h"
+#include "RmMapFusion.h"
+#include "RmUtilityExt.h"
+#include "RmExceptions.h"
+#include "RmInstrument.h"
+#include "RmPioneerController.h"
+#include "RmServer.h"
+#include "RmBroadcastServer.h"
+#include "RmMapQueryServer.h"
+#include "RmMapSnapshotter.h"
+#include "RmMapPublisher.h"
+#include "RmTrace.h"
+
+using namespace RmUtility;
+
+
+//////
+
+
+void mapFromFile( RmSettings &settings, std::ifstream& sonarStream, RmGlobalMap& grid,
+	const char *snapshotName = NULL, bool fuse = true );
+void mapFromFiles( RmSettings &settings, std::vector<std::ifstream*> &sonarStreams, 
+	RmGlobalMap& grid, const char *snapshotName = NULL, bool fuse = true );
+void mapFromRobot( RmSettings &settings, std::ofstream &sonarStream, std::string sonarStreamName, 
+	RmGlobalMap &grid, int remotePort, bool wander );
+std::string newLogFile( std::ofstream &sonarStream, std::string sonarStreamName, bool reset = false );
+
+
+//////
+
+
+const std::string DataPath( "../data/" );
+const int PollInterval( 250 ); // milliseconds between checks of the robot while awaiting commands
+
+
+//////
+
+
+/**
+ * Checkpoints the global map with each robot action, once the RmSonarMapper installed
+ * before it has mapped the action's sweep; see RmGlobalMap::checkpointIfDue().
+ */
+class MapCheckpointer : public RmActionHandler
+{
+public:
+
+	MapCheckpointer( RmGlobalMap &map ) : m_map( map ) {}
+
+	virtual void handleAction( ArRobot *robot ) { m_map.checkpointIfDue(); }
+
+private:
+
+	RmGlobalMap &m_map;
+};
+
+
+//////
+
+
+/**
+ * Provides console interface to robot mapping functionality encapsulated within the RmMapper API.
+ * Supports direct-connect or wireless simulated or real-world operation and real-time map
+ * viewing.
+ * Command line arguments allow for specification of
+ * <ul>
+ * <li>Sonar data input file (pre-recorded)
+ * <li>Sonar data input files of further robots, fused concurrently with the first
+ * <li>Sonar data output file (live)
+ * <li>Grid map output file, and its format (text, binary, or quantized binary; see RmGridFile)
+ * <li>Area of a binary grid map output file to extract, loading only the tiles it spans,
+ *     as a text grid for the viewer
+ * <li>Robot drive mode (keyboard or wander)
+ * <li>Sonar mode (Point of Return, Acoustic Axis, or Field of View)
+ * <li>Localization enabled or disabled
+ * <li>Quantization of the fused global map and of the probabilities streamed to the viewer
+ * <li>Viewer stream format (text or batched binary datagrams) and coalescing window
+ * <li>Session snapshot to resume from, and to checkpoint to, no more often than a given interval
+ * <li>Trace of the session's timeline, written on exit (see RmTrace)
+ * <li>Trace of each localization, and the interval between those whose grids are dumped
+ *     (see RmLocalizationTrace)
+ * <li>Retirement of local maps beyond the horizon of relocalization, and the file to which
+ *     they are spilled (see RmGlobalMap)
+ * </ul>
  * Execute this application without any arguments to get specific usage information.
  */
 int main( int argc, char* argv[] )
-{
-	//////
-	// Get command line arguments
-
-	struct InvalidUsageException {
-		char* message;
-		InvalidUsageException( char* message_ ) : message(message_) {}
-	};
-
-	char errMsg[50];
-
-	RmSettings settings;
-	bool prerecorded = true;
-	bool overwrite = false;
-	bool wander = false;
-	int remotePort = 0;
-
-	try {
-		if ( argc < 3 ) {
-			throw InvalidUsageException( "Wrong number of arguments." );
-		}
-
-		// Process command line switches
-		for ( int i = 1; i < argc; i += 2 ) 
-		{
-			// Sonar input filename (for processing pre-recorded sonar data)
-			if ( strcmp( argv[i], "-si" ) == 0 ) {
-				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
-				settings.SonarName = argv[i+1];
-				prerecorded = true;
-			}
-
-			// Sonar output filename, without overwrite
-			else if ( strcmp( argv[i], "-so" ) == 0 ) {
-				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
-				settings.SonarName = argv[i+1];
-				prerecorded = false;
-				overwrite = false;
-			}
-
-			// Sonar output filename, with overwrite
-			else if ( strcmp( argv[i], "-soo" ) == 0 ) {
-				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
-				settings.SonarName = argv[i+1];
-				prerecorded = false;
-				overwrite = true;
-			}
-
-			// Wander mode
-			else if ( strcmp( argv[i], "-w" ) == 0 ) {
-				wander = true;
-			}
-
-			// Remote mode (via wireless UDP connection)
-			else if ( strcmp( argv[i], "-r" ) == 0 ) {
-				remotePort = atoi( argv[i+1] );
-				if ( remotePort <= 0 ) {
-					throw InvalidUsageException( "Invalid port specification" );
-				}
-			}
-
-			// Output filename for grid map
-			else if ( strcmp( argv[i], "-g" ) == 0 ) {
-				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
-				settings.GridName = argv[i+1];
-			}
-
+{
+	//////
+	// Get command line arguments
+
+	struct InvalidUsageException {
+		char* message;
+		InvalidUsageException( char* message_ ) : message(message_) {}
+	};
+
+	char errMsg[50];
+
+	RmSettings settings;
+	bool prerecorded = true;
+	bool overwrite = false;
+	bool wander = false;
+	int remotePort = 0;
+	std::string snapshotIn;
+	std::string snapshotOut;
+	std::string traceName;
+	std::vector<std::string> fusedNames; // further robots' sonar input, in robot order
+	enum { TextGrid, FloatGrid, ByteGrid } gridFormat = TextGrid; // as read by the viewer
+	bool extract = false;
+	BoundBox extractArea; // of a binary grid, to be saved as a text grid
+
+	try {
+		if ( argc < 3 ) {
+			throw InvalidUsageException( "Wrong number of arguments." );
+		}
+
+		// Process command line switches
+		for ( int i = 1; i < argc; i += 2 ) 
+		{
+			// Sonar input filename (for processing pre-recorded sonar data)
+			if ( strcmp( argv[i], "-si" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.SonarName = argv[i+1];
+				prerecorded = true;
+			}
+
+			// Sonar input filename of a further robot, whose data is fused with that of -si
+			else if ( strcmp( argv[i], "-sf" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				fusedNames.push_back( std::string( argv[i+1] ) + ".sd" );
+			}
+
+			// Sonar output filename, without overwrite
+			else if ( strcmp( argv[i], "-so" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.SonarName = argv[i+1];
+				prerecorded = false;
+				overwrite = false;
+			}
+
+			// Sonar output filename, with overwrite
+			else if ( strcmp( argv[i], "-soo" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.SonarName = argv[i+1];
+				prerecorded = false;
+				overwrite = true;
+			}
+
+			// Wander mode
+			else if ( strcmp( argv[i], "-w" ) == 0 ) {
+				wander = true;
+			}
+
+			// Remote mode (via wireless UDP connection)
+			else if ( strcmp( argv[i], "-r" ) == 0 ) {
+				remotePort = atoi( argv[i+1] );
+				if ( remotePort <= 0 ) {
+					throw InvalidUsageException( "Invalid port specification" );
+				}
+			}
+
+			// Output filename for grid map
+			else if ( strcmp( argv[i], "-g" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.GridName = argv[i+1];
+			}
+
 			// Localize "on" or "off"
-			else if ( strcmp( argv[i], "-l" ) == 0 ) {
-				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
-				if ( strcmp( argv[i+1], "off" ) == 0 ) settings.Localize = false;
-				else if ( strcmp( argv[i+1], "on" ) == 0 ) settings.Localize = true;
-			}
-
-			// Sonar model "cell", "axis", or "cone" (point of return, acoustic axis, field of view)
-			else if ( strcmp( argv[i], "-m" ) == 0 ) {
-				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
-				if ( strcmp( argv[i+1], "cell" ) == 0 ) settings.SonarModel = RmUtility::SingleCell;
-				else if ( strcmp( argv[i+1], "axis" ) == 0 ) settings.SonarModel = 
-					RmUtility::AcousticAxis;
-				else if ( strcmp( argv[i+1], "cone" ) == 0 ) settings.SonarModel = RmUtility::Cone;
-			}
-
-			// Unidentified switch
-			else {
-				sprintf( errMsg, "Invalid switch: %s", argv[i] );
-				throw InvalidUsageException( errMsg );
-			}
-		}
-
-		if ( settings.SonarName == "" ) 
-			throw InvalidUsageException( "Missing required switch -si or -so." );
-	}
-	catch( InvalidUsageException &iue ) {
-		std::cout << "\n" << iue.message << "\n";
-		std::cout << "Usage:  " << argv[0] << " -si|-so|-soo sonarLogName " <<
-			"[-w{ander} -g gridLogName -l{ocalization} on|off -m cell|axis|cone]\n";
-		return 1;
-	}
-
-	// Update settings file based on command line switches
-	settings.write();
-
-
-	//////
-	// Build the map
-
-	RmGlobalMap map( &settings );
-
-	try {
-
-		std::string sonarName( settings.SonarName );
-		sonarName.append( ".sd" );
-
-		//////
-		// Map from file
-
-		if ( prerecorded ) 
-		{
-			std::ifstream sonarInStream( sonarName.c_str() );
-			if ( sonarInStream.fail() ) {
-				throw RmExceptions::IOException( "main()", "Unable to read sonar data file" );
-			}
-			std::cout << "Mapping sonar data from " << sonarName;
-			if ( settings.Localize ) std::cout << " with localization";
-			std::cout << "...\n";
-			clock_t start = clock();
-			mapFromFile( settings, sonarInStream, map );
-			std::cout << clock() - start << "\n";
-		}
-
-
-		//////
-		// Map from robot
-
-		else 
-		{
-			// Use ifstream to test for file existence
-			std::ifstream ifs( sonarName.c_str() );
-			if ( ifs && !overwrite ) {
-				std::cout << "The file " << sonarName << " already exists.  Overwrite (y/n)? ";
-				char c;
-				std::cin >> c;
-				if ( tolower( c ) == 'n' ) return 0;
-			}
-			ifs.close();
-
-			std::cout << "Mapping sonar data from live connection";
-			if ( settings.Localize ) std::cout << " with localization";
-			std::cout << "...\n";
-			std::ofstream sonarOutStream;
-
-			mapFromRobot( settings, sonarOutStream, settings.SonarName, map, remotePort, wander );
-		}
-
-		
-		//////
-		// Save map
-
-		if ( settings.GridName != "" ) 
-		{
-			std::cout << "Saving global map to " << settings.GridName << ".gd\n";
-			std::string gridName( settings.GridName );
-			gridName.append( ".gd" );
-			static_cast<RmMutableCartesianGrid<float> >(map).put( gridName.c_str(), 4 );
-				// using put() rather than operator<<() in order to specify precision
-				// cast required even though RmGlobalMap is an RmMutableCartesianGrid
-		}
-
-		std::cout << "\n";
-
-		map.empty();
-	}
-	catch( RmExceptions::Exception e ) {
-		std::cout << "\n" << e << "\n";
-	}
-	catch( ... ) {
-		std::cerr << "Uncaught Exception in main().\n";
-		throw;
-	}
+			else if ( strcmp( argv[i], "-l" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "off" ) == 0 ) settings.Localize = false;
+				else if ( strcmp( argv[i+1], "on" ) == 0 ) settings.Localize = true;
+			}
+
+			// Sonar model "cell", "axis", or "cone" (point of return, acoustic axis, field of view)
+			else if ( strcmp( argv[i], "-m" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "cell" ) == 0 ) settings.SonarModel = RmUtility::SingleCell;
+				else if ( strcmp( argv[i+1], "axis" ) == 0 ) settings.SonarModel = 
+					RmUtility::AcousticAxis;
+				else if ( strcmp( argv[i+1], "cone" ) == 0 ) settings.SonarModel = RmUtility::Cone;
+			}
+
+			// Snapshot filename from which to resume a prior mapping session
+			else if ( strcmp( argv[i], "-ci" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				snapshotIn = argv[i+1];
+				snapshotIn.append( ".gm" );
+			}
+
+			// Snapshot filename to which the mapping session is checkpointed
+			else if ( strcmp( argv[i], "-co" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				snapshotOut = argv[i+1];
+				snapshotOut.append( ".gm" );
+			}
+			else if ( strcmp( argv[i], "-ck" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.CheckpointInterval = atoi( argv[i+1] );
+				if ( settings.CheckpointInterval < 0 ) 
+					throw InvalidUsageException( "Invalid checkpoint interval" );
+			}
+
+			// Trace of each localization
+			else if ( strcmp( argv[i], "-lt" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.LocalizationTraceName = argv[i+1];
+			}
+			else if ( strcmp( argv[i], "-ld" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.LocalizationDumpInterval = atoi( argv[i+1] );
+				if ( settings.LocalizationDumpInterval < 0 ) 
+					throw InvalidUsageException( "Invalid localization dump interval" );
+			}
+
+			// Retirement of local maps "on" or "off", and the file to which they are spilled
+			else if ( strcmp( argv[i], "-rm" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "off" ) == 0 ) settings.RetireMaps = false;
+				else if ( strcmp( argv[i+1], "on" ) == 0 ) settings.RetireMaps = true;
+			}
+			else if ( strcmp( argv[i], "-rs" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.RetiredMapSpillName = argv[i+1];
+			}
+
+			// Trace of the session's timeline
+			else if ( strcmp( argv[i], "-tr" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				traceName = argv[i+1];
+				traceName.append( ".json" );
+			}
+
+			// Grid map output format
+			else if ( strcmp( argv[i], "-gf" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "text" ) == 0 ) gridFormat = TextGrid;
+				else if ( strcmp( argv[i+1], "float" ) == 0 ) gridFormat = FloatGrid;
+				else if ( strcmp( argv[i+1], "byte" ) == 0 ) gridFormat = ByteGrid;
+				else throw InvalidUsageException( "Invalid grid format specification" );
+			}
+
+			// Area of the binary grid map to be extracted as a text grid "ulX,ulY,lrX,lrY"
+			else if ( strcmp( argv[i], "-ga" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( sscanf( argv[i+1], "%d,%d,%d,%d", &extractArea.ul.x, &extractArea.ul.y,
+					&extractArea.lr.x, &extractArea.lr.y ) != 4 ) 
+					throw InvalidUsageException( "Invalid grid area specification" );
+				extract = true;
+			}
+
+			// Quantization of the fused global map held in memory
+			else if ( strcmp( argv[i], "-qm" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "off" ) == 0 ) settings.QuantizedMap = false;
+				else if ( strcmp( argv[i+1], "on" ) == 0 ) settings.QuantizedMap = true;
+			}
+
+			// Quantization of the probabilities streamed to the viewer
+			else if ( strcmp( argv[i], "-qv" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "off" ) == 0 ) settings.QuantizedStream = false;
+				else if ( strcmp( argv[i+1], "on" ) == 0 ) settings.QuantizedStream = true;
+			}
+
+			// Format of the updates streamed to the viewer
+			else if ( strcmp( argv[i], "-vs" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				if ( strcmp( argv[i+1], "text" ) == 0 ) settings.BinaryStream = false;
+				else if ( strcmp( argv[i+1], "binary" ) == 0 ) settings.BinaryStream = true;
+				else throw InvalidUsageException( "Invalid viewer stream specification" );
+			}
+
+			// Window over which binary viewer updates are coalesced
+			else if ( strcmp( argv[i], "-vw" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.StreamWindow = atoi( argv[i+1] );
+				if ( settings.StreamWindow < 0 ) 
+					throw InvalidUsageException( "Invalid viewer stream window" );
+			}
+
+			// Number of threads over which the local maps are fused into the global map
+			else if ( strcmp( argv[i], "-it" ) == 0 ) {
+				if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+				settings.IntegrateThreads = atoi( argv[i+1] );
+				if ( settings.IntegrateThreads < 1 ) 
+					throw InvalidUsageException( "Invalid number of integration threads" );
+			}
+
+			// Unidentified switch
+			else {
+				sprintf( errMsg, "Invalid switch: %s", argv[i] );
+				throw InvalidUsageException( errMsg );
+			}
+		}
+
+		if ( settings.SonarName == "" ) 
+			throw InvalidUsageException( "Missing required switch -si or -so." );
+		if ( !prerecorded && fusedNames.size() > 0 ) 
+			throw InvalidUsageException( "Switch -sf requires -si." );
+		if ( extract && (gridFormat == TextGrid || settings.GridName == "") ) 
+			throw InvalidUsageException( "Switch -ga requires -g and -gf float|byte." );
+	}
+	catch( InvalidUsageException &iue ) {
+		std::cout << "\n" << iue.message << "\n";
+		std::cout << "Usage:  " << argv[0] << " -si|-so|-soo sonarLogName " <<
+			"[-w{ander} -g gridLogName -l{ocalization} on|off -m cell|axis|cone " <<
+			"-gf text|float|byte -ga ulX,ulY,lrX,lrY -qm on|off -qv on|off -vs text|binary " <<
+			"-vw milliseconds -it threads " <<
+			"-ci snapshotName -co snapshotName -ck seconds -tr traceName -lt traceName -ld interval " <<
+			"-rm on|off -rs spillName " <<
+			"-sf sonarLogName ...]\n";
+		return 1;
+	}
+
+	// Update settings file based on command line switches
+	settings.write();
+
+	if ( traceName != "" ) RmTrace::start();
+
+
+	//////
+	// Build the map
+
+	RmGlobalMap map( &settings );
+
+	try {
+
+		//////
+		// Resume from and/or checkpoint to a session snapshot
+
+		if ( snapshotIn != "" ) {
+			std::cout << "Restoring mapping session from " << snapshotIn << "\n";
+			map.restore( snapshotIn.c_str() );
+		}
+		map.setCheckpoint( snapshotOut );
+
+		std::string sonarName( settings.SonarName );
+		sonarName.append( ".sd" );
+
+		//////
+		// Map from file
+
+		if ( prerecorded && fusedNames.size() > 0 ) 
+		{
+			std::vector<std::ifstream*> sonarInStreams;
+			fusedNames.insert( fusedNames.begin(), sonarName );
+			std::vector<std::string>::const_iterator ni;
+			for ( ni = fusedNames.begin(); ni != fusedNames.end(); ++ni ) {
+				sonarInStreams.push_back( new std::ifstream( ni->c_str() ) );
+			}
+
+			std::vector<std::ifstream*>::iterator si;
+			try {
+				for ( si = sonarInStreams.begin(); si != sonarInStreams.end(); ++si ) {
+					if ( (*si)->fail() ) {
+						throw RmExceptions::IOException( "main()", "Unable to read sonar data file" );
+					}
+				}
+				std::cout << "Fusing sonar data of " << fusedNames.size() << " robots from " 
+					<< sonarName;
+				if ( settings.Localize ) std::cout << " with localization";
+				std::cout << "...\n";
+				clock_t start = clock();
+				mapFromFiles( settings, sonarInStreams, map, 
+					snapshotOut == "" ? NULL : snapshotOut.c_str(), gridFormat == TextGrid );
+				std::cout << clock() - start << "\n";
+			}
+			catch ( ... ) {
+				for ( si = sonarInStreams.begin(); si != sonarInStreams.end(); ++si ) delete *si;
+				throw;
+			}
+			for ( si = sonarInStreams.begin(); si != sonarInStreams.end(); ++si ) delete *si;
+		}
+
+		else if ( prerecorded ) 
+		{
+			std::ifstream sonarInStream( sonarName.c_str() );
+			if ( sonarInStream.fail() ) {
+				throw RmExceptions::IOException( "main()", "Unable to read sonar data file" );
+			}
+			std::cout << "Mapping sonar data from " << sonarName;
+			if ( settings.Localize ) std::cout << " with localization";
+			std::cout << "...\n";
+			clock_t start = clock();
+			mapFromFile( settings, sonarInStream, map, 
+				snapshotOut == "" ? NULL : snapshotOut.c_str(), gridFormat == TextGrid );
+				// binary grid files are written tile by tile without integrating the map
+			std::cout << clock() - start << "\n";
+		}
+
+
+		//////
+		// Map from robot
+
+		else 
+		{
+			// Use ifstream to test for file existence
+			std::ifstream ifs( sonarName.c_str() );
+			if ( ifs && !overwrite ) {
+				std::cout << "The file " << sonarName << " already exists.  Overwrite (y/n)? ";
+				char c;
+				std::cin >> c;
+				if ( tolower( c ) == 'n' ) return 0;
+			}
+			ifs.close();
+
+			std::cout << "Mapping sonar data from live connection";
+			if ( settings.Localize ) std::cout << " with localization";
+			std::cout << "...\n";
+			std::ofstream sonarOutStream;
+
+			mapFromRobot( settings, sonarOutStream, settings.SonarName, map, remotePort, wander );
+		}
+
+		#ifdef _INSTRUMENT
+		std::cout << "\n";
+		RmInstrument::report( std::cout );
+		#endif
+
+		std::cout << "\n";
+		map.putMemory( std::cout );
+
+		
+		//////
+		// Save map
+
+		if ( settings.GridName != "" ) 
+		{
+			std::string gridName( settings.GridName );
+			gridName.append( gridFormat == TextGrid ? ".gd" : ".gdb" );
+			std::cout << "Saving global map to " << gridName << "\n";
+			const RmGridFile::CellType cellType = 
+				gridFormat == ByteGrid ? RmGridFile::Quantized8 : RmGridFile::Float32;
+			if ( gridFormat != TextGrid ) map.writeTiled( gridName.c_str(), cellType );
+			else if ( !map.quantized() ) {
+				const RmMutableCartesianGrid<float> &grid = map;
+					// RmGlobalMap::put() hides the grid's own put() overloads
+				grid.put( gridName.c_str(), 4 );
+					// using put() rather than operator<<() in order to specify precision
+			}
+			else {
+				RmMutableCartesianGrid<float> grid;
+				map.fusedMap( grid );
+				grid.put( gridName.c_str(), 4 );
+			}
+
+			if ( extract ) {
+				std::string areaName( settings.GridName );
+				areaName.append( "_area.gd" );
+				std::cout << "Saving area of global map to " << areaName << "\n";
+				RmMutableCartesianGrid<float> grid;
+				RmGridFile::read( gridName.c_str(), extractArea, grid );
+				grid.put( areaName.c_str(), 4 );
+			}
+		}
+
+		std::cout << "\n";
+
+		map.empty();
+	}
+	catch( RmExceptions::Exception e ) {
+		std::cout << "\n" << e << "\n";
+	}
+	catch( ... ) {
+		std::cerr << "Uncaught Exception in main().\n";
+		throw;
+	}
+
+	if ( traceName != "" ) {
+		RmTrace::stop();
+		try {
+			std::cout << "Saving trace to " << traceName << "\n";
+			RmTrace::write( traceName.c_str() );
+		}
+		catch( RmExceptions::Exception e ) {
+			std::cout << e << "\n";
+		}
+	}
 
 	return 0;
 }
 
 
 /**
- * Builds an occupancy grid using preexisting sonar data in the given file.
+ * Builds an occupancy grid using preexisting sonar data in the given file.
+ * Should the grid have been restored from a snapshot of the session, those sweeps mapped
+ * before the snapshot was taken are skipped (see RmGlobalMap::resumeSweep()).
  * @param settings the settings to be passed on to the RmSonarMapper
  * @param sonarStream the input sonar data file, already opened for read
- * @param grid the target occupancy grid
+ * @param grid the target occupancy grid, checkpointed between sweeps (see RmGlobalMap::checkpointIfDue())
+ * @param snapshotName if not null, the file to which the mapping session is saved before
+ * the map is finalized, such that the session may later be resumed
+ * @param fuse if false, the local maps are not integrated into the fused global map upon
+ * finalization, as when the map is exported via RmGlobalMap::writeTiled()
  */
-void mapFromFile( RmSettings &settings, std::ifstream& sonarStream, RmGlobalMap& grid )
+void mapFromFile( RmSettings &settings, std::ifstream& sonarStream, RmGlobalMap& grid,
+	const char *snapshotName, bool fuse )
 {
-	char buffer[300];
+	char buffer[300];
 	RmSonarMapper sonarMapper( settings, &grid );
+	const int resume = grid.resumeSweep( 0 );
+	int sweep = 0; // the position of the next sweep within the sonar data
 
 	while( sonarStream.getline( buffer, 300 ) )
-	{
-		// Skip comments
-		if ( buffer[0] == '%' ) continue;
-
-		// Map entire sonar sweep
-		sonarMapper.mapReadings( SonarReading( buffer ) );
-	}
-
-	grid.finalize();
-}
-
-
+	{
+		// Skip comments
+		if ( buffer[0] == '%' ) continue;
+
+		// Skip sweeps already mapped by a restored session, resuming at the last to update it
+		const int s = sweep++;
+		if ( s < resume ) continue;
+
+		// Map entire sonar sweep
+		SonarReading readings( buffer );
+		if ( s == resume ) sonarMapper.resumeAt( readings );
+		else if ( sonarMapper.mapReadings( readings ) ) grid.setResumeSweep( 0, s );
+		grid.checkpointIfDue();
+	}
+
+	if ( snapshotName != NULL ) grid.save( snapshotName );
+	grid.finalize( fuse );
+}
+
+
+/**
+ * Builds an occupancy grid using the preexisting sonar data of several robots, replaying the
+ * file of each concurrently on a thread of its own (see RmMapFusion).
+ * Should the grid have been restored from a snapshot of the session, those sweeps of each
+ * robot mapped before the snapshot was taken are skipped.
+ * @param settings the settings to be passed on to the RmSonarMapper of each robot
+ * @param sonarStreams the input sonar data files, already opened for read, in robot order
+ * @param grid the target occupancy grid, checkpointed between sweeps
+ * @param snapshotName if not null, the file to which the mapping session is saved before
+ * the map is finalized, such that the session may later be resumed
+ * @param fuse if false, the local maps are not integrated into the fused global map upon
+ * finalization, as when the map is exported via RmGlobalMap::writeTiled()
+ */
+void mapFromFiles( RmSettings &settings, std::vector<std::ifstream*> &sonarStreams, 
+	RmGlobalMap& grid, const char *snapshotName, bool fuse )
+{
+	RmMapFusion fusion( grid, settings );
+
+	std::vector<std::ifstream*>::iterator si;
+	for ( si = sonarStreams.begin(); si != sonarStreams.end(); ++si ) fusion.addRobot( **si );
+	fusion.start();
+	fusion.join();
+
+	if ( snapshotName != NULL ) grid.save( snapshotName );
+	grid.finalize( fuse );
+}
+
+
+/**
+ * Builds an occupancy grid using live data taken from the real or simulated robot.
+ * Supports wireless UDP server operation, receiving commands from a client on port 2000
+ * and dispatching to the robot or internally as appropriate.
+ * Wireless commands that may be received from the client include those that:
+ * <ul>
+ * <li>Put the robot in manual keydrive or automatic wander mode
+ * <li>Move the robot forward, backward, left, right, or stop its motion altogether
+ * <li>Turn the robot off and on, creating a new sonar data file each time its turned on
+ * <li>Close and create a new sonar data file
+ * <li>Connect to or disconnect from the remote viewer
+ * <li>Report the memory held by each component of the map, and its high-water marks
+ * <li>Quit the application
+ * </ul>
+ * Also supports a remote map viewer connection on port 2100 that allows for live graphical mapping
+ * of the robot's environment, and answers queries of the map, such as those of a path planner,
+ * on the port following that of the viewer (see RmMapQueryServer).
+ * The port after that publishes the changes to the map, as they are made, to a client that
+ * keeps a replica of it (see RmMapPublisher and RmMapReplica).
+ * All servers are serviced from a single loop that never blocks for longer than PollInterval,
+ * so that neither a pending viewer connection nor an idle client holds up the others.
+ * @param settings the settings to be passed on to the RmSonarMapper
+ * @param sonarStream the output sonar data file, not yet opened for write
+ * @param sonarStreamName the path and filename, without extension, of the sonar data file to create
+ * @param grid the target occupancy grid
+ * @param remotePort if positive non-zero, indicates port for wireless UDP terminal operation
+ * @param wander flags keydrive or automatic wander drive
+ */
+void mapFromRobot( RmSettings &settings, std::ofstream  &sonarStream, std::string sonarStreamName, 
+	RmGlobalMap &grid, int remotePort, bool wander )
+{
+	settings.Localize = false; // just get sonar data; localization causes delays
+
+	std::vector<RmActionHandler*> actionHandlers;
+
+	RmSonarMapper sonarMapper( settings, sonarStream, &grid );
+	actionHandlers.push_back( &sonarMapper );
+
+	MapCheckpointer checkpointer( grid ); // between sweeps, once each is mapped
+	actionHandlers.push_back( &checkpointer );
+
+	RmMapSnapshotter snapshotter( grid, settings ); // for map queries
+	actionHandlers.push_back( &snapshotter );
+
+	RmPioneerController *robot = NULL;
+	ArActionKeydrive *keydriveAction = NULL;
+
+	if ( remotePort > 0 ) 
+	{
+		RmServer remoteControlServer( remotePort, "Robot control server" ); // for the robot
+		RmBroadcastServer remoteViewServer( remotePort + 1, "Map viewer server" ); // for map viewers
+		RmMapQueryServer queryServer( remotePort + 2, snapshotter ); // for map queries
+		RmServer *servers[] = { &remoteControlServer, &remoteViewServer, &queryServer };
+
+		// Map deltas for replicas, published between the robot's actions once a replica replies
+		RmServer deltaServer( remotePort + 3, "Map delta server" );
+		RmMapPublisher::DatagramTransport deltaTransport( &deltaServer );
+		RmMapPublisher publisher( grid, deltaTransport );
+		actionHandlers.push_back( &publisher );
+
+		// Establish communication with control client
+		std::cout << "Remote client says: " << remoteControlServer.getClientString() << "\n";
+		remoteControlServer.sendClientReply( "Welcome" );
+
+		std::string cmdString;
+		std::string replyString;
+		std::string viewerCmdString; // viewer command awaiting handshake from a viewer
+		bool quit = false;
+		bool remoteViewer = false;
+		while ( (robot == NULL || robot->isRunning()) && !quit ) 
+		{
+			// Wait for a remote control command, a message from any map viewer, or a map query
+			const int ready = RmServer::waitForClient( servers, 3, PollInterval );
+			if ( ready < 0 ) {
+				remoteViewServer.flush(); // send map updates held back by slow viewers
+				continue;
+			}
+
+			if ( ready == 2 ) {
+				try {
+					queryServer.service( 0 );
+				}
+				catch ( RmExceptions::SocketException ) {
+					// Unable to reply to the querying client
+					// Ignore
+				}
+				continue;
+			}
+
+			if ( ready == 1 ) {
+				// Viewers subscribe with their handshake, and may do so at any time
+				std::cout << "Remote Control Viewer says: " << 
+					remoteViewServer.getClientString() << "\n";
+				if ( remoteViewServer.subscribers() == 0 ) continue;
+				sonarMapper.setRemoteViewServer( &remoteViewServer );
+				remoteViewer = true;
+
+				// Resume the command that awaited a viewer, if any
+				if ( viewerCmdString.empty() ) continue;
+				replyString = "Remote viewer connection established";
+				cmdString = viewerCmdString;
+				viewerCmdString = "";
+			}
+			else {
+				// Get remote control command
+				cmdString = remoteControlServer.getClientString();
+				std::cout << cmdString << "\n";
+			}
+
+			switch( cmdString.c_str()[0] )
+			{
+				case 'v': // connect to or disconnect from remote viewer
+					if ( !remoteViewer ) {
+						// Continue servicing commands until the viewer makes contact
+						std::cout << "Awaiting handshake from Remote Control Viewer\n" ;
+						viewerCmdString = cmdString;
+						break;
+					}
+
+					if ( cmdString.length() >= 3 ) {
+						replyString = "Viewer sonar mode set to ";
+						switch( cmdString.c_str()[2] )
+						{
+							case 'e': // cEll
+								settings.SonarModel = RmUtility::SingleCell;
+								replyString.append( "Single Cell" );
+								break;
+							case 'x': // aXis
+								settings.SonarModel = RmUtility::AcousticAxis;
+								replyString.append( "Acoustic Axis" );
+								break;
+							case 'o': // cOne
+								settings.SonarModel = RmUtility::Cone;
+								replyString.append( "Cone" );
+								break;
+							case 'l': // cLose
+								replyString = 
+									"Remote viewer connections closed. Rerun viewer application.";
+								remoteViewer = false;
+								remoteViewServer.sendClientReply( "reset" );
+								remoteViewServer.unsubscribeAll();
+								break;
+						}	
+					}
+					else replyString = "Unrecognized mode";
+
+					remoteControlServer.sendClientReply( replyString );
+					break;
+
+				case 'f': // forward
+					if ( keydriveAction ) keydriveAction->up();
+					break;
+
+				case 'b': // backward
+					if ( keydriveAction ) keydriveAction->down();
+					break;
+
+				case 'l': // left
+					if ( keydriveAction ) keydriveAction->left();
+					break;
+
+				case 'r': // right
+					if ( keydriveAction ) keydriveAction->right();
+					break;
+
+				case 's': // stop
+					if ( keydriveAction ) keydriveAction->space();
+					break;
+
+				case 'w': // wander/keydrive toggle
+					if ( robot ) {
+						wander = !wander;
+						robot->setDriveMode( 
+							wander ? RmPioneerController::WANDER : RmPioneerController::KEYDRIVE );
+					}
+					break;
+
+				case 'o': // toggle robot on and off, creating new log file each time turned on
+					if ( robot == NULL ) {
+						std::cerr << "robot == NULL\n";
+						remoteControlServer.sendClientReply( 
+							newLogFile( sonarStream, sonarStreamName ) );
+						robot = new RmPioneerController( wander, !wander, &actionHandlers );
+						keydriveAction = robot->arKeydriveAction();
+					}
+					else {
+						std::cerr << "robot != NULL\n";
+						sonarStream.close();
+
+						delete robot;
+						robot = NULL;
+						keydriveAction = NULL;
+
+						try {
+							remoteViewServer.sendClientReply( "reset" );
+						}
+						catch ( RmExceptions::SocketException ) {
+							// Unable to communicate with remote viewer
+							// Ignore
+						}
+					}
+					break;
+
+				case 'd': // close current log file and create new one 
+					sonarStreamName = DataPath + cmdString.substr(1);
+					remoteControlServer.sendClientReply( 
+						newLogFile( sonarStream, sonarStreamName, true ) );
+					break;
+
+				case 'i': // report instrumentation
+					remoteControlServer.sendClientReply( RmInstrument::report() );
+					break;
+
+				case 'g': // dump the grids of the next localization
+					remoteControlServer.sendClientReply( grid.requestLocalizationDump() ? 
+						"Localization dump requested" : "Localization is not traced" );
+					break;
+
+				case 'm': // report the memory held by each component of the map
+					remoteControlServer.sendClientReply( grid.memoryReport() );
+					break;
+
+				case 'q': // quit the application
+					sonarStream.close();
+					quit = true;
+					if ( robot ) delete robot;
+					robot = NULL;
+					keydriveAction = NULL;
+					try {
+						remoteViewServer.sendClientReply( "quit" );
+					}
+					catch ( RmExceptions::SocketException ) {
+						// Unable to communicate with remote viewer
+						// Ignore
+					}
+					break;
+			}
+ 		}
+
+		// The robot calls the publisher, which must not outlive this block
+		if ( robot ) delete robot;
+		robot = NULL;
+	}
+	else
+	{
+		std::cout << newLogFile( sonarStream, sonarStreamName ) << "\n";
+		robot = new RmPioneerController( wander, false, &actionHandlers );
+			// this blocks, handling all robot motion control, until user presses Escape
+			// meanwhile, the actionHandlers are being called as part of the robot event cycle
+	}
+
+	if ( robot ) delete robot;
+
+	return;
+}
+
+
 /**
- * Builds an occupancy grid using live data taken from the real or simulated robot.
- * Supports wireless UDP server operation, receiving commands from a client on port 2000
- * and dispatching to the robot or internally as appropriate.
- * Wireless commands that may be received from the client include those that:
- * <ul>
- * <li>Put the robot in manual keydrive or automatic wander mode
- * <li>Move the robot forward, backward, left, right, or stop its motion altogether
- * <li>Turn the robot off and on, creating a new sonar data file each time its turned on
- * <li>Close and create a new sonar data file
- * <li>Connect to or disconnect from the remote viewer
- * <li>Quit the application
- * </ul>
- * Also supports a remote map viewer connection on port 2100 that allows for live graphical mapping
- * of the robot's environment.
- * @param settings the settings to be passed on to the RmSonarMapper
- * @param sonarStream the output sonar data file, not yet opened for write
- * @param sonarStreamName the path and filename, without extension, of the sonar data file to create
- * @param grid the target occupancy grid
- * @param remotePort if positive non-zero, indicates port for wireless UDP terminal operation
- * @param wander flags keydrive or automatic wander drive
+ * Opens an sonar data output file of type ".sd".
+ * Each call will increment a sequence number that is appended to the end of the filename.
+ * The first call does not append a sequence number.
+ * For example, given a sonarStreamName of "mydata", the output files 
+ * will be "mydata.sd", "mydata2.sd", "mydata3.sd", and so on.
+ * @param sonarStream the stream used to open the file; if a file is already open on the stream,
+ * it is first closed
+ * @param sonarStreamName the path and filename, without extension, of the file to create
+ * @param reset resets the sequence number to 1
  */
-void mapFromRobot( RmSettings &settings, std::ofstream  &sonarStream, std::string sonarStreamName, 
-	RmSonarMap &grid, int remotePort, bool wander )
-{
-	settings.Localize = false; // just get sonar data; localization causes delays
-
-	std::vector<RmActionHandler*> actionHandlers;
-
-	RmSonarMapper sonarMapper( settings, sonarStream, &grid );
-	actionHandlers.push_back( &sonarMapper );
-
-	RmPioneerController *robot = NULL;
-	ArActionKeydrive *keydriveAction = NULL;
-
-	if ( remotePort > 0 ) 
-	{
-		RmServer remoteControlServer( remotePort, "Robot control server" ); // for the robot
-		RmServer remoteViewServer( remotePort + 1, "Map viewer server" ); // for the Java map viewer
-
-		// Establish communication with control client
-		std::cout << "Remote client says: " << remoteControlServer.getClientString() << "\n";
-		remoteControlServer.sendClientReply( "Welcome" );
-
-		std::string cmdString;
-		std::string replyString;
-		bool quit = false;
-		bool remoteViewer = false;
-		while ( (robot == NULL || robot->isRunning()) && !quit ) 
-		{
-			// Get remote control command
-			cmdString = remoteControlServer.getClientString();
-			std::cout << cmdString << "\n";
-
-			switch( cmdString.c_str()[0] )
-			{
-				case 'v': // connect to or disconnect from remote viewer
-					if ( !remoteViewer ) {
-						std::cout << "Awaiting handshake from Remote Control Viewer\n" ;
-						std::cout << "Remote Control Viewer says: " << 
-							remoteViewServer.getClientString() << "\n";
-						remoteViewServer.sendClientReply( "Welcome" );
-						sonarMapper.setRemoteViewServer( &remoteViewServer );
-						remoteViewer = true;
-						replyString = "Remote viewer connection established";
-					}
-
-					if ( cmdString.length() >= 3 ) {
-						replyString = "Viewer sonar mode set to ";
-						switch( cmdString.c_str()[2] )
-						{
-							case 'e': // cEll
-								settings.SonarModel = RmUtility::SingleCell;
-								replyString.append( "Single Cell" );
-								break;
-							case 'x': // aXis
-								settings.SonarModel = RmUtility::AcousticAxis;
-								replyString.append( "Acoustic Axis" );
-								break;
-							case 'o': // cOne
-								settings.SonarModel = RmUtility::Cone;
-								replyString.append( "Cone" );
-								break;
-							case 'l': // cLose
-								replyString = 
-									"Remote viewer connection closed. Rerun viewer application.";
-								remoteViewer = false;
-								remoteViewServer.sendClientReply( "reset" );
-								break;
-						}	
-					}
-					else replyString = "Unrecognized mode";
-
-					remoteControlServer.sendClientReply( replyString );
-					break;
-
-				case 'f': // forward
-					if ( keydriveAction ) keydriveAction->up();
-					break;
-
-				case 'b': // backward
-					if ( keydriveAction ) keydriveAction->down();
-					break;
-
-				case 'l': // left
-					if ( keydriveAction ) keydriveAction->left();
-					break;
-
-				case 'r': // right
-					if ( keydriveAction ) keydriveAction->right();
-					break;
-
-				case 's': // stop
-					if ( keydriveAction ) keydriveAction->space();
-					break;
-
-				case 'w': // wander/keydrive toggle
-					if ( robot ) {
-						wander = !wander;
-						robot->setDriveMode( 
-							wander ? RmPioneerController::WANDER : RmPioneerController::KEYDRIVE );
-					}
-					break;
-
-				case 'o': // toggle robot on and off, creating new log file each time turned on
-					if ( robot == NULL ) {
-						std::cerr << "robot == NULL\n";
-						remoteControlServer.sendClientReply( 
-							newLogFile( sonarStream, sonarStreamName ) );
-						robot = new RmPioneerController( wander, !wander, &actionHandlers );
-						keydriveAction = robot->arKeydriveAction();
-					}
-					else {
-						std::cerr << "robot != NULL\n";
-						sonarStream.close();
-
-						delete robot;
-						robot = NULL;
-						keydriveAction = NULL;
-
-						try {
-							remoteViewServer.sendClientReply( "reset" );
-						}
-						catch ( RmExceptions::SocketException ) {
-							// Unable to communicate with remote viewer
-							// Ignore
-						}
-					}
-					break;
-
-				case 'd': // close current log file and create new one 
-					sonarStreamName = DataPath + cmdString.substr(1);
-					remoteControlServer.sendClientReply( 
-						newLogFile( sonarStream, sonarStreamName, true ) );
-					break;
-
-				case 'q': // quit the application
-					sonarStream.close();
-					quit = true;
-					if ( robot ) delete robot;
-					robot = NULL;
-					keydriveAction = NULL;
-					try {
-						remoteViewServer.sendClientReply( "quit" );
-					}
-					catch ( RmExceptions::SocketException ) {
-						// Unable to communicate with remote viewer
-						// Ignore
-					}
-					break;
-			}
- 		}
-	}
-	else
-	{
-		std::cout << newLogFile( sonarStream, sonarStreamName ) << "\n";
-		robot = new RmPioneerController( wander, false, &actionHandlers );
-			// this blocks, handling all robot motion control, until user presses Escape
-			// meanwhile, the actionHandlers are being called as part of the robot event cycle
-	}
-
-	if ( robot ) delete robot;
-
-	return;
-}
-
-
-/**
- * Opens an sonar data output file of type ".sd".
- * Each call will increment a sequence number that is appended to the end of the filename.
- * The first call does not append a sequence number.
- * For example, given a sonarStreamName of "mydata", the output files 
- * will be "mydata.sd", "mydata2.sd", "mydata3.sd", and so on.
- * @param sonarStream the stream used to open the file; if a file is already open on the stream,
- * it is first closed
- * @param sonarStreamName the path and filename, without extension, of the file to create
- * @param reset resets the sequence number to 1
- */
-std::string newLogFile( std::ofstream &sonarStream, std::string sonarStreamName, bool reset )
-{
-	static const char *dataFail = "Unable to open sonar file '%s' for write.";
-	static const char *dataOkay = "Sonar file '%s' successfully opened for write.";
-	static char sonarName[255];
-	static int segment = 0;
-
-	if ( reset ) segment = 0;
-
-	if ( sonarStream.is_open() ) sonarStream.close();
-
-	if ( ++segment == 1 ) sprintf( sonarName, "%s.sd", sonarStreamName.c_str() );
-	else sprintf( sonarName, "%s%d.sd", sonarStreamName.c_str(), segment );
-	sonarStream.open( sonarName );
-
-	char buff[255];
-	sprintf( buff, sonarStream ? dataOkay : dataFail, sonarName );
-
-	return std::string( buff );
-}
+std::string newLogFile( std::ofstream &sonarStream, std::string sonarStreamName, bool reset )
+{
+	static const char *dataFail = "Unable to open sonar file '%s' for write.";
+	static const char *dataOkay = "Sonar file '%s' successfully opened for write.";
+	static char sonarName[255];
+	static int segment = 0;
+
+	if ( reset ) segment = 0;
+
+	if ( sonarStream.is_open() ) sonarStream.close();
+
+	if ( ++segment == 1 ) sprintf( sonarName, "%s.sd", sonarStreamName.c_str() );
+	else sprintf( sonarName, "%s%d.sd", sonarStreamName.c_str(), segment );
+	sonarStream.open( sonarName );
+
+	char buff[255];
+	sprintf( buff, sonarStream ? dataOkay : dataFail, sonarName );
+
+	return std::string( buff );
+}
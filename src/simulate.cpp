@@ -0,0 +1,306 @@
+// simulate.cpp
+// The simulation app that generates sonar data files by driving a simulated robot through a
+// floor plan, such that mapping may be tested at any scale without a robot.
+
+
+// Disable warning C4786: "identifier was truncated to '255' characters in the debug information
+// while compiling class-template member function"
+#pragma warning( disable : 4786 )
+
+
+//////
+
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "RmSonarSimulator.h"
+#include "RmExceptions.h"
+
+
+//////
+
+
+/**
+ * A single command of a trajectory script; see main().
+ */
+struct TrajectoryCommand
+{
+	std::string name;
+	double args[3];
+};
+
+std::vector<TrajectoryCommand> readTrajectory( std::istream &is );
+std::vector<double> splitNumbers( const char *list, unsigned int count );
+int drive( RmSonarSimulator &sim, const std::vector<TrajectoryCommand> &trajectory,
+	bool first, int sweeps, std::ostream &os );
+
+
+//////
+
+
+/**
+ * Generates a sonar data file, as would be recorded by the main application (see main.cpp),
+ * by driving an RmSonarSimulator through a floor plan along a scripted trajectory,
+ * recording one sweep per step.
+ * The floor plan is read by RmSonarSimulator::readFloorPlan().
+ * The trajectory script consists of one command per line, any line beginning with '%' being
+ * a comment:
+ * <ul>
+ * <li><code>pose x y th</code> places the robot, in millimeters and degrees counterclockwise
+ *     from the x-axis, and records a sweep
+ * <li><code>step mm</code> sets the distance driven per sweep (defaults to 20)
+ * <li><code>turnstep degrees</code> sets the angle turned per sweep (defaults to 5)
+ * <li><code>forward mm</code> drives straight ahead, or back if negative
+ * <li><code>turn degrees</code> turns in place, counterclockwise if positive
+ * <li><code>pause sweeps</code> records the given number of sweeps without moving
+ * </ul>
+ * Should a number of sweeps be specified, the script is repeated until that many are recorded,
+ * skipping its <code>pose</code> commands after the first pass, such that a script
+ * describing a closed loop produces a run of any length.
+ * Command line arguments allow for specification of
+ * <ul>
+ * <li>Floor plan file (required)
+ * <li>Trajectory script file (required)
+ * <li>Sonar data output filename, to which ".sd" is appended (required)
+ * <li>Number of sweeps recorded
+ * <li>Seed of the random number generator (defaults to 1)
+ * <li>Odometry error: distance scale, turn scale, heading drift per meter,
+ *     and deviations of distance and turn (see RmSonarSimulator::setOdometryError())
+ * <li>Sonar noise: range deviation, dropout probability, and beam width
+ *     (see RmSonarSimulator::setSonarNoise())
+ * </ul>
+ * Execute this application without any arguments to get specific usage information.
+ */
+int main( int argc, char* argv[] )
+{
+	//////
+	// Get command line arguments
+
+	struct InvalidUsageException {
+		std::string message;
+		InvalidUsageException( const std::string &message_ ) : message(message_) {}
+	};
+
+	std::string planName, trajectoryName, sonarName;
+	int sweeps = 0;
+	unsigned long seed = 1;
+	std::vector<double> odometryError( 5, 0.0 );
+	std::vector<double> sonarNoise( 3, 0.0 );
+
+	try {
+		for ( int i = 1; i < argc; i += 2 )
+		{
+			if ( i+1 == argc ) throw InvalidUsageException( "Wrong number of arguments." );
+
+			if ( strcmp( argv[i], "-p" ) == 0 ) planName = argv[i+1];
+			else if ( strcmp( argv[i], "-t" ) == 0 ) trajectoryName = argv[i+1];
+			else if ( strcmp( argv[i], "-so" ) == 0 ) sonarName = argv[i+1];
+
+			// Length of the run
+			else if ( strcmp( argv[i], "-n" ) == 0 ) {
+				sweeps = atoi( argv[i+1] );
+				if ( sweeps < 1 ) throw InvalidUsageException( "Invalid number of sweeps" );
+			}
+
+			else if ( strcmp( argv[i], "-seed" ) == 0 ) seed = strtoul( argv[i+1], NULL, 10 );
+
+			// Odometry error and sonar noise
+			else if ( strcmp( argv[i], "-oe" ) == 0 ) {
+				odometryError = splitNumbers( argv[i+1], 5 );
+				if ( odometryError.empty() )
+					throw InvalidUsageException( "Invalid odometry error specification" );
+			}
+			else if ( strcmp( argv[i], "-sn" ) == 0 ) {
+				sonarNoise = splitNumbers( argv[i+1], 3 );
+				if ( sonarNoise.empty() || sonarNoise[0] < 0 || sonarNoise[1] < 0 ||
+					 sonarNoise[1] > 1 || sonarNoise[2] < 0 )
+					throw InvalidUsageException( "Invalid sonar noise specification" );
+			}
+
+			// Unidentified switch
+			else throw InvalidUsageException( std::string( "Invalid switch: " ) + argv[i] );
+		}
+
+		if ( planName == "" || trajectoryName == "" || sonarName == "" )
+			throw InvalidUsageException( "Missing required switch -p, -t, or -so." );
+	}
+	catch( InvalidUsageException &iue ) {
+		std::cout << "\n" << iue.message << "\n";
+		std::cout << "Usage:  " << argv[0] << " -p floorPlanFile -t trajectoryFile " <<
+			"-so sonarLogName [-n sweeps -seed n " <<
+			"-oe distanceScale,turnScale,drift,distanceSigma,turnSigma " <<
+			"-sn rangeSigma,dropout,beamWidth]\n";
+		return 1;
+	}
+
+
+	//////
+	// Simulate
+
+	try {
+		RmSonarSimulator sim( seed );
+		sim.setOdometryError( odometryError[0], odometryError[1], odometryError[2],
+			odometryError[3], odometryError[4] );
+		sim.setSonarNoise( sonarNoise[0], sonarNoise[1], sonarNoise[2] );
+
+		std::ifstream planStream( planName.c_str() );
+		if ( planStream.fail() ) {
+			throw RmExceptions::IOException( "main()", "Unable to read floor plan file" );
+		}
+		sim.readFloorPlan( planStream );
+
+		std::ifstream trajectoryStream( trajectoryName.c_str() );
+		if ( trajectoryStream.fail() ) {
+			throw RmExceptions::IOException( "main()", "Unable to read trajectory file" );
+		}
+		const std::vector<TrajectoryCommand> trajectory( readTrajectory( trajectoryStream ) );
+
+		sonarName.append( ".sd" );
+		std::ofstream sonarStream( sonarName.c_str() );
+		if ( sonarStream.fail() ) {
+			throw RmExceptions::IOException( "main()", "Unable to write sonar data file" );
+		}
+		sonarStream << "% Simulated by " << argv[0];
+		for ( int i = 1; i < argc; ++i ) sonarStream << " " << argv[i];
+		sonarStream << "\n";
+
+		std::cout << "Simulating " << sonarName << " over " << sim.walls() << " walls...\n";
+		int recorded = drive( sim, trajectory, true, sweeps, sonarStream );
+		while ( recorded < sweeps ) {
+			const int more = drive( sim, trajectory, false, sweeps - recorded, sonarStream );
+			if ( more == 0 ) break; // the script records nothing once its poses are skipped
+			recorded += more;
+		}
+		std::cout << "Recorded " << recorded << " sweeps\n";
+	}
+	catch( RmExceptions::Exception e ) {
+		std::cout << e << "\n";
+		return 2;
+	}
+
+	return 0;
+}
+
+
+/**
+ * Reads a trajectory script, as described by main().
+ * @throws an RmExceptions::IOException if the script is malformed
+ */
+std::vector<TrajectoryCommand> readTrajectory( std::istream &is )
+{
+	std::vector<TrajectoryCommand> trajectory;
+	std::string line;
+	while ( std::getline( is, line ) )
+	{
+		if ( line.empty() || line[0] == '%' ) continue;
+
+		std::istringstream ls( line );
+		TrajectoryCommand c;
+		if ( !(ls >> c.name) ) continue;
+
+		const unsigned int count = c.name == "pose" ? 3 : 1;
+		if ( c.name != "pose" && c.name != "step" && c.name != "turnstep" &&
+			 c.name != "forward" && c.name != "turn" && c.name != "pause" ) {
+			throw RmExceptions::IOException( "readTrajectory()", "Unrecognized command" );
+		}
+		for ( unsigned int a = 0; a < count; ++a ) {
+			if ( !(ls >> c.args[a]) ) {
+				throw RmExceptions::IOException( "readTrajectory()", "Missing command argument" );
+			}
+		}
+		if ( (c.name == "step" || c.name == "turnstep") && c.args[0] <= 0 ) {
+			throw RmExceptions::IOException( "readTrajectory()", "Step must be positive" );
+		}
+		trajectory.push_back( c );
+	}
+	return trajectory;
+}
+
+
+/**
+ * Runs the trajectory once, writing a sweep to the given stream after each step.
+ * @param first if false, the trajectory's <code>pose</code> commands are skipped
+ * @param sweeps if positive, the number of sweeps after which the run ends early
+ * @return the number of sweeps written
+ */
+int drive( RmSonarSimulator &sim, const std::vector<TrajectoryCommand> &trajectory,
+	bool first, int sweeps, std::ostream &os )
+{
+	double step = 20, turnStep = 5;
+	int recorded = 0;
+	std::vector<TrajectoryCommand>::const_iterator ci;
+	for ( ci = trajectory.begin(); ci != trajectory.end(); ++ci )
+	{
+		const double arg = ci->args[0];
+		double done = 0;
+
+		if ( ci->name == "step" ) step = arg;
+		else if ( ci->name == "turnstep" ) turnStep = arg;
+
+		else if ( ci->name == "pose" ) {
+			if ( !first ) continue;
+			sim.setPose( ci->args[0], ci->args[1], ci->args[2] );
+			sim.writeSweep( os );
+			++recorded;
+		}
+
+		else if ( ci->name == "forward" ) {
+			while ( done < fabs( arg ) - 1e-9 ) {
+				if ( sweeps > 0 && recorded == sweeps ) return recorded;
+				const double d = fabs( arg ) - done < step ? fabs( arg ) - done : step;
+				sim.forward( arg < 0 ? -d : d );
+				done += d;
+				sim.writeSweep( os );
+				++recorded;
+			}
+		}
+
+		else if ( ci->name == "turn" ) {
+			while ( done < fabs( arg ) - 1e-9 ) {
+				if ( sweeps > 0 && recorded == sweeps ) return recorded;
+				const double th = fabs( arg ) - done < turnStep ? fabs( arg ) - done : turnStep;
+				sim.turn( arg < 0 ? -th : th );
+				done += th;
+				sim.writeSweep( os );
+				++recorded;
+			}
+		}
+
+		else if ( ci->name == "pause" ) {
+			for ( int p = 0; p < static_cast<int>(arg); ++p ) {
+				if ( sweeps > 0 && recorded == sweeps ) return recorded;
+				sim.writeSweep( os );
+				++recorded;
+			}
+		}
+
+		if ( sweeps > 0 && recorded == sweeps ) return recorded;
+	}
+	return recorded;
+}
+
+
+/**
+ * Returns the given number of comma-separated numbers, or an empty vector if the list holds
+ * any other number of them or anything other than numbers.
+ */
+std::vector<double> splitNumbers( const char *list, unsigned int count )
+{
+	std::vector<double> numbers;
+	const char *next = list;
+	while ( *next != '\0' ) {
+		char *end;
+		numbers.push_back( strtod( next, &end ) );
+		if ( end == next || (*end != ',' && *end != '\0') ) return std::vector<double>();
+		next = *end == ',' ? end + 1 : end;
+	}
+	if ( numbers.size() != count ) numbers.clear();
+	return numbers;
+}
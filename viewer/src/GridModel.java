@@ -169,7 +169,7 @@ class GridModel
 	private String m_filename;
 	
 	private DatagramSocket m_dataSocket;
-	private DatagramPacket m_packet;	private byte m_datagramBuffer[] = new byte[4096];	
+	private DatagramPacket m_packet;	private byte m_datagramBuffer[] = new byte[4096];	private long m_sequence = -1; // sequence number of the last binary datagram received, if any	
 	GridModel( String dataFilename ) throws FileNotFoundException
 	{		init( dataFilename );
 	}
@@ -240,9 +240,10 @@ class GridModel
 			return "";
 		}
 		
-		String reply = new String( m_packet.getData(), 0, m_packet.getLength() );//		System.err.println( "GridModel.datagramUpdate(): " + reply );		// Terminate viewer if user requested Quit
-		if ( reply.compareTo( "quit" ) == 0 ) System.exit(0);		return reply.compareTo( "reset" ) == 0 ? "" : reply;
+		// Binary datagrams streamed by the mapper's RmViewerStream are converted to text		if ( m_packet.getLength() >= 20 && m_datagramBuffer[0] == 'R' && m_datagramBuffer[1] == 'V' )			return binaryUpdate( m_packet.getData(), m_packet.getLength() );		String reply = new String( m_packet.getData(), 0, m_packet.getLength() );//		System.err.println( "GridModel.datagramUpdate(): " + reply );		// Terminate viewer if user requested Quit
+		if ( reply.compareTo( "quit" ) == 0 ) System.exit(0);		if ( reply.compareTo( "reset" ) == 0 ) {			m_sequence = -1;			return "";		}		return reply;
 	}
+		/**	 * Converts a binary datagram streamed by the mapper's RmViewerStream into the text form	 * of an update string: the pose and range reading, "x y th sonar range", followed on the	 * next line by "x y q;" for each cell, its probability quantized to [0..254].	 * Datagrams that arrive out of order are discarded, and any found lost are reported.	 */	private String binaryUpdate( byte data[], int length )	{		long sequence = ((long)readShort( data, 4 ) & 0xffff) << 16 | (readShort( data, 6 ) & 0xffff);		if ( m_sequence >= 0 ) {			long gap = sequence - m_sequence;			if ( gap <= 0 ) return "";			if ( gap > 1 ) System.err.println( "GridModel.binaryUpdate(): " + (gap - 1) + " datagram(s) lost" );		}		m_sequence = sequence;				int cells = readShort( data, 18 ) & 0xffff;		if ( length < 20 + cells * 5 ) {			System.err.println( "GridModel.binaryUpdate(): Truncated datagram " + sequence );			return "";		}				StringBuffer s = new StringBuffer( 32 + cells * 13 );		s.append( readShort( data, 8 ) ).append( ' ' ).append( readShort( data, 10 ) ).append( ' ' )		 .append( readShort( data, 12 ) ).append( ' ' ).append( data[14] & 0xff ).append( ' ' )		 .append( readShort( data, 16 ) ).append( '\n' );		for ( int i = 0, offset = 20; i < cells; ++i, offset += 5 ) {			s.append( readShort( data, offset ) ).append( ' ' ).append( readShort( data, offset + 2 ) )			 .append( ' ' ).append( data[offset + 4] & 0xff ).append( ';' );		}		return s.toString();	}		/**	 * Returns the signed big-endian 16-bit value at the given offset of the given data.	 */	private static int readShort( byte data[], int offset )	{		return (short)((data[offset] << 8) | (data[offset + 1] & 0xff));	}
 			/**
 	 * This is called by GridView.updateLocalized() in response to user-requested localization.
 	 */
@@ -307,7 +308,7 @@ class GridModel
 			{
 				String pointData[] = regionData[i].split( " " );				Cell cell = rangeReading.fill[i] = new Cell();
 				cell.x = GRID_MID + Integer.parseInt( pointData[0] );
-				cell.y = GRID_MID - Integer.parseInt( pointData[1] );				cell.pr = Float.parseFloat( pointData[2] );				
+				cell.y = GRID_MID - Integer.parseInt( pointData[1] );				// Probabilities arrive either as decimals or quantized to [0..254] (see RmUtility::quantize)				cell.pr = pointData[2].indexOf( '.' ) >= 0 ? Float.parseFloat( pointData[2] ) :					Integer.parseInt( pointData[2] ) / 254.0f;				
 				// Skip out of bounds				if ( cell.x < 0 || cell.x > GridModel.GRID_SIZE ||					 cell.y < 0 || cell.y > GridModel.GRID_SIZE ) continue;
 						
 				undoData.fill[i] = new Cell( cell.x, cell.y, m_gridData[cell.x][cell.y] );